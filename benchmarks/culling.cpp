@@ -0,0 +1,91 @@
+/***************************************************************************************************
+ * @file  culling.cpp
+ * @brief Compares the batched frustum culling of AABBArrays to culling the boxes one at a time
+ **************************************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <numbers>
+#include <vector>
+#include "culling/AABB.hpp"
+#include "culling/AABBArrays.hpp"
+#include "culling/Frustum.hpp"
+#include "maths/simd.hpp"
+#include "maths/transforms.hpp"
+#include "utility/Random.hpp"
+
+/**
+ * @brief The amount of boxes, as many as the cubes and spheres of the frustum culling tests scene.
+ */
+static constexpr unsigned int BOX_COUNT = 20'000;
+
+/**
+ * @brief The amount of times each method culls every box.
+ */
+static constexpr unsigned int ITERATION_COUNT = 1'000;
+
+/**
+ * @brief Measures the mean duration of a culling method.
+ * @param cull Culls every box and returns the amount of visible ones.
+ * @param visible_count Stores the amount of visible boxes.
+ * @return The mean duration of a call in milliseconds.
+ */
+template <typename Function>
+static float time_culling(Function cull, unsigned int& visible_count) {
+    visible_count = cull();
+
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned int i = 0 ; i < ITERATION_COUNT ; ++i) { visible_count = cull(); }
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / ITERATION_COUNT;
+}
+
+int main() {
+#if defined(MATHS_USE_AVX)
+    std::cout << "Instruction set: AVX\n";
+#elif defined(MATHS_USE_SSE)
+    std::cout << "Instruction set: SSE\n";
+#else
+    std::cout << "Instruction set: scalar\n";
+#endif
+
+    // Same distribution and camera as the frustum culling tests scene
+    std::vector<AABB> boxes;
+    std::vector<unsigned char> last_failed_planes(BOX_COUNT, 0);
+    AABBArrays aabb_arrays;
+
+    boxes.reserve(BOX_COUNT);
+    for(unsigned int i = 0 ; i < BOX_COUNT ; ++i) {
+        const vec3 center = Random::get_vec3(-1000.0f, 1000.0f);
+        const vec3 extent = Random::get_vec3(1.0f, 10.0f);
+        boxes.emplace_back(center - extent, center + extent);
+        aabb_arrays.add(nullptr, boxes.back());
+    }
+
+    Frustum frustum;
+    frustum.update(perspective(std::numbers::pi_v<float> / 2.0f, 16.0f / 9.0f, 0.1f, 1024.0f)
+                   * look_at(vec3(0.0f, 10.0f, 0.0f), vec3(1.0f, 10.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f)));
+
+    unsigned int scalar_visible_count;
+    const float scalar_time = time_culling([&] {
+        unsigned int count = 0;
+        for(unsigned int i = 0 ; i < BOX_COUNT ; ++i) { count += boxes[i].is_in_frustum(frustum, last_failed_planes[i]); }
+        return count;
+    }, scalar_visible_count);
+
+    std::vector<unsigned int> visible_indices;
+    visible_indices.reserve(BOX_COUNT);
+
+    unsigned int batched_visible_count;
+    const float batched_time = time_culling([&] {
+        visible_indices.clear();
+        aabb_arrays.cull(frustum, visible_indices);
+        return static_cast<unsigned int>(visible_indices.size());
+    }, batched_visible_count);
+
+    std::cout << BOX_COUNT << " boxes, mean of " << ITERATION_COUNT << " iterations\n";
+    std::cout << "AABB::is_in_frustum loop: " << scalar_time << " ms, " << scalar_visible_count << " visible\n";
+    std::cout << "AABBArrays::cull:         " << batched_time << " ms, " << batched_visible_count << " visible\n";
+    std::cout << "Speedup: " << scalar_time / batched_time << "x\n";
+
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <functional>
 
 #include "mesh/Mesh.hpp"
+#include "mesh/MeshBuffer.hpp"
 #include "mesh/Model.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
@@ -74,12 +75,29 @@ public:
 
     static Shader& get_relevant_shader_from_mesh(const Mesh& mesh);
 
+    /**
+     * @brief Finds the instanced variant of a shader, added with the shader's name followed by
+     * " instanced".
+     * @param shader A shader of the asset manager.
+     * @return A pointer to the instanced variant, nullptr if the shader doesn't have one.
+     */
+    static Shader* get_instanced_shader_ptr(const Shader& shader);
+
+    /**
+     * @brief Finds the buffer shared by the meshes with a certain vertex layout, creating it if it
+     * doesn't exist yet.
+     * @param attributes The type of each attribute of the layout.
+     * @return The mesh buffer of the layout.
+     */
+    static MeshBuffer& get_mesh_buffer(const AttributeType* attributes);
+
 private:
     AssetManager();
     ~AssetManager();
 
     std::unordered_map<std::string, Shader> shaders;
     std::unordered_map<std::string, Texture> textures;
+    std::unordered_map<unsigned int, MeshBuffer> mesh_buffers; ///< Destroyed after the meshes allocating from them.
     std::unordered_map<std::string, Model> models;
     std::unordered_map<std::string, Mesh> meshes;
 };
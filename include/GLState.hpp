@@ -0,0 +1,160 @@
+/***************************************************************************************************
+ * @file  GLState.hpp
+ * @brief Declaration of the GLState class
+ **************************************************************************************************/
+
+#pragma once
+
+/**
+ * @class GLState
+ * @brief Keeps a copy of the OpenGL state that changes the most between draws: the shader program, the
+ * vertex array, the textures bound to each unit, the framebuffer, blending, depth testing, face culling
+ * and the polygon mode. Changing a part of the state through this class only calls OpenGL if its value
+ * is different, the redundant calls being counted instead. The copy starts with the default state of a
+ * new context and only stays correct if the tracked state is never changed by calling OpenGL directly.
+ */
+class GLState {
+public:
+    GLState(const GLState&) = delete; ///< Delete copy constructor.
+    GLState& operator=(const GLState&) = delete; ///< Deleted copy operator.
+
+    /**
+     * @brief Access the GLState singleton.
+     * @return A reference to the GLState singleton.
+     */
+    static inline GLState& get() {
+        static GLState state;
+        return state;
+    }
+
+    /**
+     * @brief Makes a shader program the current one.
+     * @param program The id of the program.
+     */
+    static void use_program(unsigned int program);
+
+    /**
+     * @brief Binds a vertex array.
+     * @param vertex_array The id of the vertex array.
+     */
+    static void bind_vertex_array(unsigned int vertex_array);
+
+    /**
+     * @brief Binds a texture to a texture unit and makes the unit the active one, so that the texture
+     * can be edited right after.
+     * @param unit The texture unit.
+     * @param target The target, GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+     * @param texture The id of the texture.
+     */
+    static void bind_texture(unsigned int unit, unsigned int target, unsigned int texture);
+
+    /**
+     * @brief Binds a framebuffer for both drawing and reading.
+     * @param framebuffer The id of the framebuffer, 0 for the default one.
+     */
+    static void bind_framebuffer(unsigned int framebuffer);
+
+    /**
+     * @brief Enables or disables blending.
+     * @param enabled Whether blending is enabled.
+     */
+    static void set_blending(bool enabled);
+
+    /**
+     * @brief Enables or disables depth testing.
+     * @param enabled Whether depth testing is enabled.
+     */
+    static void set_depth_test(bool enabled);
+
+    /**
+     * @brief Enables or disables face culling.
+     * @param enabled Whether face culling is enabled.
+     */
+    static void set_face_culling(bool enabled);
+
+    /**
+     * @return Whether face culling is enabled, without querying OpenGL.
+     */
+    static bool is_face_culling_enabled();
+
+    /**
+     * @brief Sets the polygon mode of both faces.
+     * @param mode GL_FILL, GL_LINE or GL_POINT.
+     */
+    static void set_polygon_mode(unsigned int mode);
+
+    /**
+     * @brief Forgets a shader program that is about to be deleted. OpenGL keeps using it until another
+     * program is made current, so the next program is made current whatever its id.
+     * @param program The id of the program.
+     */
+    static void forget_program(unsigned int program);
+
+    /**
+     * @brief Forgets a vertex array that is about to be deleted, which OpenGL unbinds.
+     * @param vertex_array The id of the vertex array.
+     */
+    static void forget_vertex_array(unsigned int vertex_array);
+
+    /**
+     * @brief Forgets a texture that is about to be deleted, which OpenGL unbinds from every unit.
+     * @param texture The id of the texture.
+     */
+    static void forget_texture(unsigned int texture);
+
+    /**
+     * @brief Forgets a framebuffer that is about to be deleted, which OpenGL unbinds.
+     * @param framebuffer The id of the framebuffer.
+     */
+    static void forget_framebuffer(unsigned int framebuffer);
+
+    /**
+     * @brief Starts counting the calls of a new frame, keeping the counts of the last one.
+     */
+    static void new_frame();
+
+    /**
+     * @return The amount of OpenGL calls made through this class during the last frame.
+     */
+    static unsigned int get_issued_call_count();
+
+    /**
+     * @return The amount of redundant OpenGL calls avoided during the last frame.
+     */
+    static unsigned int get_elided_call_count();
+
+private:
+    /**
+     * @brief Starts with the default state of a new OpenGL context.
+     */
+    GLState();
+
+    /**
+     * @brief Counts a state change, which is issued if the value is different.
+     * @param value The tracked value, updated.
+     * @param new_value The new value.
+     * @return Whether the value was different and OpenGL needs to be called.
+     */
+    template <typename Type>
+    static bool change(Type& value, Type new_value);
+
+    static constexpr unsigned int MAX_TEXTURE_UNITS = 32; ///< The amount of tracked texture units.
+
+    unsigned int program;      ///< The current shader program.
+    unsigned int vertex_array; ///< The bound vertex array.
+    unsigned int framebuffer;  ///< The bound framebuffer.
+
+    unsigned int active_texture_unit;                 ///< The active texture unit.
+    unsigned int textures_2D[MAX_TEXTURE_UNITS];      ///< The 2D texture bound to each unit.
+    unsigned int cubemap_textures[MAX_TEXTURE_UNITS]; ///< The cube map texture bound to each unit.
+
+    bool b_is_blending_enabled;     ///< Whether blending is enabled.
+    bool b_is_depth_test_enabled;   ///< Whether depth testing is enabled.
+    bool b_is_face_culling_enabled; ///< Whether face culling is enabled.
+    unsigned int polygon_mode;      ///< The polygon mode of both faces.
+
+    unsigned int issued_call_count;            ///< The calls made during the current frame.
+    unsigned int elided_call_count;            ///< The calls avoided during the current frame.
+    unsigned int last_frame_issued_call_count; ///< The calls made during the last frame.
+    unsigned int last_frame_elided_call_count; ///< The calls avoided during the last frame.
+};
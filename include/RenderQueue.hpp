@@ -0,0 +1,211 @@
+/***************************************************************************************************
+ * @file  RenderQueue.hpp
+ * @brief Declaration of the RenderQueue class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "culling/Frustum.hpp"
+#include "maths/mat4.hpp"
+#include "maths/vec4.hpp"
+#include "mesh/MeshBuffer.hpp"
+
+class Entity;
+
+/**
+ * @brief The passes of the render queue, drawn in this order.
+ */
+enum RenderPass : unsigned int {
+    RENDER_PASS_OPAQUE,     ///< Opaque draws, sorted by state then front to back.
+    RENDER_PASS_TRANSPARENT ///< Transparent draws, sorted back to front then by state.
+};
+
+/**
+ * @struct DrawPacket
+ * @brief A draw found while culling the scene graph, drawn by its entity once the queue was sorted.
+ */
+struct DrawPacket {
+    uint64_t key;          ///< The sort key, see RenderQueue::make_key.
+    const Entity* entity;  ///< The entity drawing the packet.
+    unsigned int index;    ///< What the entity draws, such as the index of a mesh or of a primitive.
+    unsigned int lod;      ///< The level of detail to draw.
+    bool can_be_batched;   ///< Whether the entity can draw the packet along others with a multi draw call.
+};
+
+/**
+ * @struct InstanceData
+ * @brief The data of an object drawn by a batch in the instance buffer, laid out like the Instance
+ * struct of the instanced shaders with the std430 layout.
+ */
+struct InstanceData {
+    mat4 model;            ///< The global model.
+    vec4 normal_matrix[3]; ///< The columns of the global normal matrix, padded to 4 floats.
+    vec4 color;            ///< The color of the instance.
+};
+
+/**
+ * @class RenderQueue
+ * @brief The draws of a frame, sorted by a 64-bit key packing their pass, shader, texture, material,
+ * mesh and depth before being submitted, so that draws sharing the same state are drawn one after the
+ * other. Opaque keys start with the state so that state changes are minimized, their depth only
+ * ordering the draws of a same state front to back. Transparent keys start with the inverted depth
+ * so that they're blended back to front. Consecutive packets that can be batched are drawn with a
+ * single multi draw indirect call, one indirect command per mesh. The data of every object drawn by the
+ * batches of the frame is uploaded at once to an instance buffer, which the shaders index with the
+ * instance index, each command's base instance being the index of its first object. The commands are
+ * uploaded at once to an indirect buffer.
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief Creates an empty render queue. The instance and indirect buffers are only created once
+     * batches are drawn, so the queue can be created before the OpenGL context.
+     */
+    RenderQueue();
+
+    /**
+     * @brief Frees the instance and indirect buffers.
+     */
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator =(const RenderQueue&) = delete;
+
+    /**
+     * @brief Packs the sort key of a draw. The ids are truncated to the bits of their field, ids sharing
+     * the same bits only making the sort less efficient.
+     * @param pass The pass of the draw.
+     * @param shader The id of the shader program.
+     * @param texture The id of the main texture, 0 if there isn't any.
+     * @param material An id of the material, 0 if there isn't any.
+     * @param mesh An id of the mesh, see Mesh::get_sort_id, 0 if there isn't any.
+     * @param depth The distance between the camera and the draw, positive.
+     * @return The sort key.
+     */
+    static uint64_t make_key(RenderPass pass, unsigned int shader, unsigned int texture, unsigned int material,
+                             unsigned int mesh, float depth);
+
+    /**
+     * @brief Gives an id to a material from its address, so that materials that aren't stored in a
+     * common array can still be told apart by the sort keys.
+     * @param material The material, nullptr if there isn't any.
+     * @return The id of the material, 0 for nullptr.
+     */
+    static unsigned int get_material_id(const void* material);
+
+    /**
+     * @brief Removes every packet.
+     */
+    void clear();
+
+    /**
+     * @brief Adds a packet to the queue.
+     * @param key The sort key, see make_key.
+     * @param entity The entity drawing the packet.
+     * @param index What the entity draws.
+     * @param lod The level of detail to draw.
+     * @param can_be_batched Whether the entity can draw the packet along others with a multi draw call.
+     */
+    void push(uint64_t key, const Entity* entity, unsigned int index = 0, unsigned int lod = 0,
+              bool can_be_batched = false);
+
+    /**
+     * @brief Sorts the packets by key with a least significant digit radix sort, one pass per byte of
+     * the keys. Bytes that are the same for every key are skipped.
+     */
+    void sort();
+
+    /**
+     * @brief Draws the packets in order and counts the state changes between the draw calls. Runs of
+     * packets that can be batched and have the same pass, shader, texture and material are given to
+     * the entity of their first packet, which adds the objects and the commands of the packets it can
+     * draw at once. Batches are drawn once they have at least 2 packets, with their objects and
+     * commands uploaded beforehand.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void submit(const mat4& view_projection_matrix, const Frustum& frustum);
+
+    /**
+     * @return The amount of packets in the queue.
+     */
+    unsigned int size() const;
+
+    /**
+     * @return The amount of times the shader changed between two packets during the last submission.
+     */
+    unsigned int get_shader_change_count() const;
+
+    /**
+     * @return The amount of times the shader, texture, material or mesh changed between two packets
+     * during the last submission.
+     */
+    unsigned int get_state_change_count() const;
+
+    /**
+     * @return The amount of draw calls of the last submission, multi draw calls included.
+     */
+    unsigned int get_draw_call_count() const;
+
+    /**
+     * @return The amount of multi draw indirect calls of the last submission.
+     */
+    unsigned int get_batch_count() const;
+
+    /**
+     * @return The amount of packets drawn by the multi draw calls of the last submission.
+     */
+    unsigned int get_batched_packet_count() const;
+
+    /**
+     * @return The amount of indirect commands of the multi draw calls of the last submission.
+     */
+    unsigned int get_command_count() const;
+
+private:
+    /**
+     * @struct Batch
+     * @brief Consecutive packets drawn with a single multi draw call.
+     */
+    struct Batch {
+        unsigned int packet_index;  ///< The index of the first packet.
+        unsigned int packet_count;  ///< The amount of packets.
+        unsigned int first_command; ///< The index of the first command in the indirect buffer.
+        unsigned int command_count; ///< The amount of commands.
+    };
+
+    /**
+     * @brief Finds the packets drawn with multi draw calls and gathers their objects and commands.
+     */
+    void build_batches();
+
+    /**
+     * @brief Uploads data to a buffer, orphaning it so that the previous frame's data can still be read
+     * while the new data is written and growing it geometrically so that its size rarely changes.
+     * @param target The target the buffer is bound to.
+     * @param buffer The id of the buffer, created if it's 0.
+     * @param capacity The size of the buffer in bytes, increased if the data doesn't fit.
+     * @param data The data.
+     * @param size The size of the data in bytes.
+     */
+    static void upload_buffer(unsigned int target, unsigned int& buffer, std::size_t& capacity, const void* data,
+                              std::size_t size);
+
+    std::vector<DrawPacket> packets;        ///< The packets of the frame.
+    std::vector<DrawPacket> sorted_packets; ///< The buffer the radix sort's passes write to.
+
+    std::vector<Batch> batches;                        ///< The packets drawn with multi draw calls, in order.
+    std::vector<InstanceData> instances;               ///< The objects of the batches.
+    std::vector<DrawElementsIndirectCommand> commands; ///< The commands of the batches.
+    unsigned int instance_buffer;                      ///< The shader storage buffer holding the objects.
+    std::size_t instance_buffer_capacity;              ///< The size of the instance buffer in bytes.
+    unsigned int indirect_buffer;                      ///< The indirect buffer holding the commands.
+    std::size_t indirect_buffer_capacity;              ///< The size of the indirect buffer in bytes.
+
+    unsigned int shader_change_count;  ///< The shader changes of the last submission.
+    unsigned int state_change_count;   ///< The state changes of the last submission.
+    unsigned int draw_call_count;      ///< The draw calls of the last submission.
+    unsigned int batched_packet_count; ///< The packets drawn by the batches of the last submission.
+};
@@ -5,7 +5,26 @@
 
 #pragma once
 
+#include <vector>
+#include "culling/AABBArrays.hpp"
+#include "culling/BVH.hpp"
+#include "culling/OcclusionCuller.hpp"
+#include "entities/DrawableEntity.hpp"
 #include "entities/Entity.hpp"
+#include "entities/EntityArena.hpp"
+#include "entities/MeshEntity.hpp"
+#include "entities/SceneEntity.hpp"
+#include "maths/TransformSystem.hpp"
+#include "RenderQueue.hpp"
+#include "utility/ThreadPool.hpp"
+
+/**
+ * @brief The ways the scene graph can find the entities inside of the frustum.
+ */
+enum CullingMethod : int {
+    CULLING_METHOD_BVH,    ///< Hierarchical culling by querying the BVH.
+    CULLING_METHOD_BATCHED ///< Brute force SIMD culling of the bounds arrays.
+};
 
 /**
  * @class SceneGraph
@@ -31,13 +50,77 @@ public:
     void add_selected_entity_editor_to_imgui_window() const;
 
     /**
-     * @brief Draw every drawable object within the scene graph.
+     * @brief Inserts every drawable entity with bounds of a subtree in the scene graph's BVH and bounds
+     * arrays, and keeps track of its scene entities so that their primitives can occlude. Needs to be
+     * called once the entities' bounds were created.
+     * @param entity The root of the subtree.
+     */
+    void insert_in_culling_structures(Entity* entity);
+
+    /**
+     * @brief Updates the global models of the entities whose transform was modified and of their
+     * descendants on every thread of the thread pool.
+     */
+    void update_transforms();
+
+    /**
+     * @brief Freezes a subtree whose entities won't move anymore so that it's drawn with a few merged
+     * meshes instead of one draw per entity. The visible mesh entities of the subtree are grouped by
+     * what they need to be drawn with, see MeshEntity::can_be_merged_with, and their meshes are baked
+     * into a merged mesh per group with their global model. Each group is split into cells along the
+     * longest axis of its entities' centers until the cells are small enough, every cell being a merged
+     * mesh with its own bounds so that it can still be culled. The merged meshes are drawn by new
+     * entities added below the root, which are inserted in the culling structures, while the baked
+     * entities are removed from them and marked as baked, see DrawableEntity::bake, so that they don't
+     * cost any culling or draw. Baked entities stay visible, so the other entities of the subtree, such
+     * as lights, scenes or the descendants of a baked entity, are still drawn as they were.
+     * Only mesh entities are baked: the primitives of scene entities keep their per primitive culling,
+     * PVS, levels of detail and meshlets, which merging them would lose.
+     * @param subtree The root of the subtree.
+     * @return The entity holding the merged meshes' entities, a child of the root.
+     */
+    Entity* freeze(Entity* subtree);
+
+    /**
+     * @brief Draw every drawable object within the scene graph. The entities with bounds are found with
+     * the current culling method on every thread of the thread pool, then culled by occlusion if it is
+     * enabled. The other ones, such as the primitives of scenes, are found while walking the graph and
+     * are culled by occlusion as they're found. The draw packets of the visible
+     * entities are added to the render queue, which is sorted then submitted.
      * @param view_projection_matrix The projection matrix multiplied by the view matrix.
-     * @param frustum
+     * @param frustum The view frustum.
+     */
+    void draw(const mat4& view_projection_matrix, const Frustum& frustum);
+
+    /**
+     * @return The time spent finding the visible entities during the last draw, in milliseconds.
+     */
+    float get_culling_time() const;
+
+    /**
+     * @return The time spent on occlusion culling during the last draw, in milliseconds.
      */
-    void draw(const mat4& view_projection_matrix, const Frustum& frustum) const;
+    float get_occlusion_time() const;
 
-    Entity root; ///< The root of the scene graph.
+    /**
+     * @return The amount of occluders rasterized during the last draw.
+     */
+    unsigned int get_occluder_count() const;
+
+    /**
+     * @return The render queue of the last draw.
+     */
+    const RenderQueue& get_render_queue() const;
+
+    BVH bvh;                          ///< The BVH of the entities with bounds, outlives the entities.
+    AABBArrays aabb_arrays;           ///< The bounds arrays of the entities with bounds, outlives them too.
+    TransformSystem transform_system; ///< The transforms of the entities, outlives them too.
+    EntityArena entity_arena;         ///< Allocates the entities below the root, destroying them at once.
+    Entity root;                      ///< The root of the scene graph.
+    CullingMethod culling_method;     ///< The method used to find the visible entities with bounds.
+
+    OcclusionCuller occlusion_culler;  ///< Culls the visible entities hidden behind the largest ones.
+    bool is_occlusion_culling_enabled; ///< Whether the visible entities are culled by occlusion.
 
 private:
     /**
@@ -46,5 +129,41 @@ private:
      */
     void add_entity_to_imgui_node_tree(Entity* entity);
 
+    /**
+     * @brief Finds the visible entities with bounds on every thread of the thread pool. With the BVH,
+     * each task queries a subtree, otherwise each task culls a range of the bounds arrays. Entities too
+     * small on the screen to be seen are dropped. The visible entities of each task are merged in order
+     * once every task is done.
+     * @param frustum The view frustum.
+     */
+    void cull(const Frustum& frustum);
+
+    /**
+     * @brief Rasterizes the visible entities and the primitives of the scene entities covering the most
+     * of the screen as occluders then removes the visible entities they hide, testing them on every
+     * thread of the thread pool.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void cull_occluded(const mat4& view_projection_matrix, const Frustum& frustum);
+
     Entity* selected_entity; ///< The currently selected entity.
+
+    ThreadPool thread_pool; ///< The threads culling the entities and updating their transforms.
+
+    std::vector<int> subtrees;                                       ///< The subtree culled by each task.
+    std::vector<std::vector<DrawableEntity*>> task_visible_entities; ///< The entities found by each task.
+    std::vector<DrawStatistics> thread_statistics;                   ///< The counters of each thread.
+    std::vector<DrawableEntity*> visible_entities;                   ///< The entities found by the culling.
+    float culling_time;                                              ///< The culling's duration in ms.
+
+    std::vector<const SceneEntity*> scene_entities;           ///< The scene entities, whose primitives can occlude.
+    std::vector<std::pair<float, DrawableEntity*>> occluders; ///< The occluder candidates and their coverage.
+    std::vector<unsigned char> occlusion_results;             ///< Whether each visible entity isn't occluded.
+    unsigned int occluder_count;                              ///< The amount of rasterized occluders.
+    float occlusion_time;                                     ///< The occlusion culling's duration in ms.
+
+    RenderQueue render_queue; ///< The draw packets of the visible entities.
+
+    unsigned int merged_mesh_count; ///< The amount of meshes merged by freeze, used to name them.
 };
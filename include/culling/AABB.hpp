@@ -5,14 +5,80 @@
 
 #pragma once
 
-#include "maths/Transform.hpp"
+#include "culling/Frustum.hpp"
+#include "maths/affine3x4.hpp"
 
+/**
+ * @brief Boxes whose screen size is smaller are too small to be seen and aren't drawn. About a pixel of
+ * radius at 1080p.
+ */
+constexpr float SMALL_FEATURE_SCREEN_SIZE = 0.002f;
+
+/**
+ * @struct AABB
+ * @brief Axis aligned bounding box stored as its center and its half size on each axis.
+ */
 struct AABB {
+    /**
+     * @brief Constructs an empty AABB at the origin.
+     */
     AABB();
+
+    /**
+     * @brief Constructs the AABB going from a minimum to a maximum point.
+     * @param min_point The minimum coordinates of the box.
+     * @param max_point The maximum coordinates of the box.
+     */
     AABB(const vec3& min_point, const vec3& max_point);
 
-    bool is_in_frustum(const mat4& mvp_matrix) const;
-    mat4 get_global_model_matrix(const Transform& transform) const;
+    /**
+     * @return The minimum coordinates of the box.
+     */
+    vec3 get_min_point() const;
+
+    /**
+     * @return The maximum coordinates of the box.
+     */
+    vec3 get_max_point() const;
+
+    /**
+     * @brief Calculates the smallest AABB containing this box once transformed by an affine transform.
+     * @param model The transform, usually a global model matrix.
+     * @return The transformed AABB.
+     */
+    AABB transformed(const affine3x4& model) const;
+
+    /**
+     * @brief Calculates the smallest AABB containing both this box and another one.
+     * @param other The other box.
+     * @return The merged AABB.
+     */
+    AABB merged(const AABB& other) const;
+
+    /**
+     * @brief Checks whether the box is at least partially inside a frustum. The box is assumed to be
+     * in world space.
+     * @param frustum The frustum.
+     * @param last_failed_plane The plane that culled the box last time, tested first.
+     * @return Whether the box is visible.
+     */
+    bool is_in_frustum(const Frustum& frustum, unsigned char& last_failed_plane) const;
+
+    /**
+     * @brief Approximates the size of the box on the screen with the projected radius of its bounding
+     * sphere. The box is assumed to be in world space.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix, whose view
+     * matrix doesn't scale.
+     * @return The projected radius divided by half of the screen's height, infinity if the camera is
+     * inside of the sphere.
+     */
+    float get_screen_size(const mat4& view_projection_matrix) const;
+
+    /**
+     * @return The model matrix transforming the [-1 ; 1] cube into this box, used to draw the box.
+     */
+    mat4 get_model_matrix() const;
 
-    vec4 points[8];
+    vec3 center; ///< The center of the box.
+    vec3 extent; ///< The half size of the box on each axis.
 };
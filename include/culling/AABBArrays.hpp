@@ -0,0 +1,89 @@
+/***************************************************************************************************
+ * @file  AABBArrays.hpp
+ * @brief Declaration of the AABBArrays class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <limits>
+#include <vector>
+#include "culling/AABB.hpp"
+#include "culling/Frustum.hpp"
+
+class DrawableEntity;
+
+/**
+ * @brief Index of the bounds of an entity that aren't in its bounds arrays.
+ */
+constexpr unsigned int AABB_ARRAYS_NULL_INDEX = std::numeric_limits<unsigned int>::max();
+
+/**
+ * @class AABBArrays
+ * @brief Stores the world space bounds of drawable entities as a structure of arrays so that they can
+ * be frustum culled several at a time: 8 boxes per iteration with AVX, 4 with SSE.
+ */
+class AABBArrays {
+public:
+    /**
+     * @brief Adds an entity's bounds at the end of the arrays.
+     * @param entity The entity.
+     * @param bounds The world space bounds of the entity.
+     * @return The index of the entity's bounds, used to update or remove them.
+     */
+    unsigned int add(DrawableEntity* entity, const AABB& bounds);
+
+    /**
+     * @brief Removes bounds by moving the last bounds in their place, updating the index stored by the
+     * moved entity.
+     * @param index The index of the bounds to remove.
+     */
+    void remove(unsigned int index);
+
+    /**
+     * @brief Sets the bounds at a specific index.
+     * @param index The index.
+     * @param bounds The new world space bounds.
+     */
+    void set(unsigned int index, const AABB& bounds);
+
+    /**
+     * @brief Tests every box against the planes of a frustum.
+     * @param frustum The frustum.
+     * @param visible_indices Stores the indices of the boxes that are at least partially inside of the
+     * frustum, in increasing order. Isn't cleared.
+     */
+    void cull(const Frustum& frustum, std::vector<unsigned int>& visible_indices) const;
+
+    /**
+     * @brief Tests a range of boxes against the planes of a frustum. Disjoint ranges can be culled in
+     * parallel.
+     * @param frustum The frustum.
+     * @param begin The index of the first box to test.
+     * @param end The index after the last box to test.
+     * @param visible_indices Stores the indices of the boxes that are at least partially inside of the
+     * frustum, in increasing order. Isn't cleared.
+     */
+    void cull(const Frustum& frustum, unsigned int begin, unsigned int end,
+              std::vector<unsigned int>& visible_indices) const;
+
+    /**
+     * @param index The index of bounds.
+     * @return The entity whose bounds are at this index.
+     */
+    DrawableEntity* get_entity(unsigned int index) const;
+
+    /**
+     * @return The amount of boxes.
+     */
+    unsigned int size() const;
+
+private:
+    std::vector<float> center_x; ///< The x coordinates of the centers.
+    std::vector<float> center_y; ///< The y coordinates of the centers.
+    std::vector<float> center_z; ///< The z coordinates of the centers.
+    std::vector<float> extent_x; ///< The x components of the extents.
+    std::vector<float> extent_y; ///< The y components of the extents.
+    std::vector<float> extent_z; ///< The z components of the extents.
+
+    std::vector<DrawableEntity*> entities; ///< The entity owning each box.
+};
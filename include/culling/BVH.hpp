@@ -0,0 +1,165 @@
+/***************************************************************************************************
+ * @file  BVH.hpp
+ * @brief Declaration of the BVH class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "culling/AABB.hpp"
+#include "culling/Frustum.hpp"
+
+class DrawableEntity;
+
+/**
+ * @brief Index used by the BVH for missing nodes.
+ */
+constexpr int BVH_NULL_NODE = -1;
+
+/**
+ * @struct BVHNode
+ * @brief A node of a BVH. Leaves hold an entity and internal nodes always have two children.
+ */
+struct BVHNode {
+    /**
+     * @return Whether the node is a leaf.
+     */
+    bool is_leaf() const { return left == BVH_NULL_NODE; }
+
+    vec3 min;                        ///< The minimum coordinates of the node's box.
+    vec3 max;                        ///< The maximum coordinates of the node's box.
+    int parent;                      ///< The parent's index, or the next free node if the node is free.
+    int left;                        ///< The left child's index.
+    int right;                       ///< The right child's index.
+    int height;                      ///< The height of the subtree, 0 for leaves and -1 for free nodes.
+    unsigned char last_failed_plane; ///< The frustum plane that last culled the node.
+    DrawableEntity* entity;          ///< The entity held by a leaf.
+};
+
+/**
+ * @class BVH
+ * @brief Dynamic AABB tree holding drawable entities, in the manner of Bullet's dbvt. Leaves are
+ * inserted next to the sibling that increases the surface area of the tree the least and the tree is
+ * kept balanced with rotations. The boxes of the leaves are enlarged by a margin so that entities that
+ * move a little don't need to be reinserted.
+ */
+class BVH {
+public:
+    /**
+     * @brief Constructs an empty BVH.
+     */
+    BVH();
+
+    /**
+     * @brief Inserts an entity in the tree.
+     * @param entity The entity.
+     * @param bounds The world space bounds of the entity.
+     * @return The index of the leaf holding the entity, used to update or remove it.
+     */
+    int insert(DrawableEntity* entity, const AABB& bounds);
+
+    /**
+     * @brief Removes a leaf from the tree.
+     * @param leaf The index of the leaf.
+     */
+    void remove(int leaf);
+
+    /**
+     * @brief Refits a leaf after the bounds of its entity changed. The leaf is only reinserted if the
+     * new bounds leave its enlarged box.
+     * @param leaf The index of the leaf.
+     * @param bounds The new world space bounds of the entity.
+     */
+    void update(int leaf, const AABB& bounds);
+
+    /**
+     * @brief Finds the entities whose bounds are at least partially inside of a frustum. Subtrees
+     * outside of the frustum are skipped and the entities of subtrees fully inside of it are added
+     * without testing them.
+     * @param frustum The frustum.
+     * @param visible_entities Stores the visible entities. Isn't cleared.
+     */
+    void query(const Frustum& frustum, std::vector<DrawableEntity*>& visible_entities);
+
+    /**
+     * @brief Finds the entities of a subtree whose bounds are at least partially inside of a frustum.
+     * Queries of disjoint subtrees can run in parallel.
+     * @param frustum The frustum.
+     * @param subtree The index of the root of the subtree.
+     * @param visible_entities Stores the visible entities. Isn't cleared.
+     */
+    void query(const Frustum& frustum, int subtree, std::vector<DrawableEntity*>& visible_entities);
+
+    /**
+     * @brief Splits the tree into disjoint subtrees by replacing the largest subtrees by their children
+     * until there are enough of them or only leaves are left.
+     * @param subtree_count The wanted amount of subtrees.
+     * @param subtrees Stores the indices of the roots of the subtrees, from left to right. Is cleared.
+     */
+    void split(unsigned int subtree_count, std::vector<int>& subtrees) const;
+
+    /**
+     * @brief Removes every node from the tree.
+     */
+    void clear();
+
+    /**
+     * @return The height of the tree, 0 if it is empty or only has one leaf.
+     */
+    int get_height() const;
+
+    /**
+     * @return The amount of entities in the tree.
+     */
+    unsigned int get_entity_count() const;
+
+private:
+    /**
+     * @brief Takes a node from the free list, growing the nodes array if it is empty.
+     * @return The index of the node.
+     */
+    int allocate_node();
+
+    /**
+     * @brief Adds a node to the free list.
+     * @param node The index of the node.
+     */
+    void free_node(int node);
+
+    /**
+     * @brief Links an allocated leaf into the tree.
+     * @param leaf The index of the leaf.
+     */
+    void insert_leaf(int leaf);
+
+    /**
+     * @brief Unlinks a leaf from the tree without freeing it.
+     * @param leaf The index of the leaf.
+     */
+    void remove_leaf(int leaf);
+
+    /**
+     * @brief Refits and rebalances every node from a node to the root.
+     * @param node The index of the first node.
+     */
+    void refit_ancestors(int node);
+
+    /**
+     * @brief Rotates a node with one of its children if the heights of its subtrees differ by more
+     * than 1.
+     * @param node The index of the node.
+     * @return The index of the node now at the node's position.
+     */
+    int balance(int node);
+
+    /**
+     * @brief Sets the box and height of an internal node from its children's.
+     * @param node The index of the node.
+     */
+    void refit_node(int node);
+
+    std::vector<BVHNode> nodes; ///< The nodes of the tree, allocated or free.
+    int root;                   ///< The index of the root.
+    int free_list;              ///< The index of the first free node.
+    unsigned int entity_count;  ///< The amount of entities in the tree.
+};
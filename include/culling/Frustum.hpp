@@ -6,11 +6,93 @@
 #pragma once
 
 #include "maths/mat4.hpp"
+#include "maths/vec3.hpp"
+#include "maths/vec4.hpp"
+
+/**
+ * @brief Indices of the planes of a frustum.
+ */
+enum FrustumPlane : unsigned char {
+    FRUSTUM_PLANE_LEFT,
+    FRUSTUM_PLANE_RIGHT,
+    FRUSTUM_PLANE_BOTTOM,
+    FRUSTUM_PLANE_TOP,
+    FRUSTUM_PLANE_NEAR,
+    FRUSTUM_PLANE_FAR
+};
+
+/**
+ * @brief Mask with a bit set for each of the 6 planes of a frustum.
+ */
+constexpr unsigned char FRUSTUM_ALL_PLANES_MASK = 0b111111;
 
 /**
  * @struct Frustum
- * @brief
+ * @brief Represents the view frustum of a camera as 6 world space planes extracted from its view
+ * projection matrix. Each plane is stored as (a, b, c, d) with (a, b, c) being its unit normal,
+ * pointing towards the inside of the frustum, such that a point p is inside of it if
+ * dot((a, b, c), p) + d >= 0.
  */
 struct Frustum {
-    mat4 view_projection;
+    /**
+     * @brief Stores the view projection matrix, extracts and normalizes the planes of the frustum and
+     * finds the position of the camera. Needs to be called each time the camera moves.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     */
+    void update(const mat4& view_projection_matrix);
+
+    /**
+     * @brief Checks whether a world space AABB is at least partially inside the frustum. Tests the plane
+     * the box was last culled by first since it's likely to cull it again.
+     * @param center The center of the AABB.
+     * @param extent The half size of the AABB on each axis.
+     * @param last_failed_plane The plane that culled the box last time. Updated when another plane
+     * culls the box.
+     * @return Whether the AABB is visible.
+     */
+    bool is_aabb_visible(const vec3& center, const vec3& extent, unsigned char& last_failed_plane) const;
+
+    /**
+     * @brief Checks whether a world space AABB is at least partially inside the frustum, only testing
+     * the planes set in a mask. The bits of the planes the box is fully inside of are cleared from the
+     * mask, so that the boxes it contains don't need to be tested against them.
+     * @param center The center of the AABB.
+     * @param extent The half size of the AABB on each axis.
+     * @param last_failed_plane The plane that culled the box last time. Updated when another plane
+     * culls the box.
+     * @param plane_mask The planes to test. Only contains the planes the box intersects after the call.
+     * @return Whether the AABB is visible.
+     */
+    bool is_aabb_visible(const vec3& center, const vec3& extent,
+                         unsigned char& last_failed_plane, unsigned char& plane_mask) const;
+
+    /**
+     * @brief Checks whether a world space bounding sphere is at least partially inside the frustum.
+     * Tests the plane the sphere was last culled by first since it's likely to cull it again.
+     * @param center The center of the sphere.
+     * @param radius The radius of the sphere.
+     * @param last_failed_plane The plane that culled the sphere last time. Updated when another plane
+     * culls the sphere.
+     * @return Whether the sphere is visible.
+     */
+    bool is_sphere_visible(const vec3& center, float radius, unsigned char& last_failed_plane) const;
+
+    /**
+     * @brief Checks whether a world space bounding sphere is at least partially inside the frustum,
+     * only testing the planes set in a mask. The bits of the planes the sphere is fully inside of are
+     * cleared from the mask.
+     * @param center The center of the sphere.
+     * @param radius The radius of the sphere.
+     * @param last_failed_plane The plane that culled the sphere last time. Updated when another plane
+     * culls the sphere.
+     * @param plane_mask The planes to test. Only contains the planes the sphere intersects after the
+     * call.
+     * @return Whether the sphere is visible.
+     */
+    bool is_sphere_visible(const vec3& center, float radius,
+                           unsigned char& last_failed_plane, unsigned char& plane_mask) const;
+
+    mat4 view_projection; ///< The view projection matrix the planes were extracted from.
+    vec4 planes[6];       ///< The normalized planes, indexed by FrustumPlane.
+    vec3 position;        ///< The position of the camera, where the side planes meet.
 };
@@ -0,0 +1,105 @@
+/***************************************************************************************************
+ * @file  OcclusionCuller.hpp
+ * @brief Declaration of the OcclusionCuller class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "culling/AABB.hpp"
+#include "maths/affine3x4.hpp"
+#include "maths/mat4.hpp"
+#include "mesh/Mesh.hpp"
+
+/**
+ * @class OcclusionCuller
+ * @brief Software occlusion culling: large occluders are rasterized on the CPU into a low resolution
+ * depth buffer, from which a hierarchy of maximum depths is built. A box is occluded if its nearest
+ * depth is behind the farthest occluder depth over the whole screen rectangle it covers.\n
+ * Depths are the normalized device coordinates' z, the buffer being cleared to the far plane.
+ */
+class OcclusionCuller {
+public:
+    /**
+     * @brief Creates the depth buffer and its hierarchy.
+     * @param width The width of the depth buffer in pixels, needs to be a multiple of 4.
+     * @param height The height of the depth buffer in pixels.
+     */
+    explicit OcclusionCuller(unsigned int width = 256, unsigned int height = 128);
+
+    /**
+     * @brief Clears the depth buffer and sets the view projection matrix used for the next occluders
+     * and tests.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     */
+    void begin(const mat4& view_projection_matrix);
+
+    /**
+     * @brief Rasterizes the triangles of a mesh into the depth buffer. Meshes whose primitive isn't
+     * triangles are ignored.
+     * @param model The global model matrix of the mesh.
+     * @param mesh The mesh.
+     */
+    void rasterize_mesh(const affine3x4& model, const Mesh& mesh);
+
+    /**
+     * @brief Builds the hierarchy of maximum depths from the depth buffer. Needs to be called once
+     * every occluder was rasterized and before testing boxes.
+     */
+    void build_hierarchy();
+
+    /**
+     * @brief Calculates the part of the screen covered by the screen rectangle of a box, used to
+     * choose the occluders.
+     * @param bounds The world space box.
+     * @return The covered area divided by the screen's area, 1 if the box crosses the near plane.
+     */
+    float get_screen_coverage(const AABB& bounds) const;
+
+    /**
+     * @brief Tests whether a box may be visible behind the rasterized occluders. Boxes crossing the
+     * near plane or outside of the screen are always considered visible.
+     * @param bounds The world space box.
+     * @return Whether the box isn't fully occluded.
+     */
+    bool is_visible(const AABB& bounds) const;
+
+    /**
+     * @return The amount of triangles rasterized since the last call to begin.
+     */
+    unsigned int get_rasterized_triangle_count() const;
+
+private:
+    /**
+     * @brief Projects the corners of a box to the screen.
+     * @param bounds The world space box.
+     * @param min_x Stores the minimum x screen coordinate, in pixels.
+     * @param min_y Stores the minimum y screen coordinate, in pixels.
+     * @param max_x Stores the maximum x screen coordinate, in pixels.
+     * @param max_y Stores the maximum y screen coordinate, in pixels.
+     * @param min_depth Stores the nearest depth of the corners.
+     * @return false if a corner is in front of the near plane, in which case the outputs are unset.
+     */
+    bool project_bounds(const AABB& bounds, float& min_x, float& min_y, float& max_x, float& max_y,
+                        float& min_depth) const;
+
+    /**
+     * @brief Rasterizes a triangle whose vertices are in screen space, keeping the nearest depth of
+     * each pixel whose center is inside of it.
+     * @param a The first vertex: x and y in pixels and the depth.
+     * @param b The second vertex.
+     * @param c The third vertex.
+     */
+    void rasterize_triangle(vec3 a, vec3 b, vec3 c);
+
+    unsigned int width;  ///< The width of the depth buffer.
+    unsigned int height; ///< The height of the depth buffer.
+
+    std::vector<std::vector<float>> levels;  ///< The depth buffer then each level of maximum depths.
+    std::vector<unsigned int> level_widths;  ///< The width of each level.
+    std::vector<unsigned int> level_heights; ///< The height of each level.
+
+    mat4 view_projection;                   ///< The view projection matrix of the current frame.
+    std::vector<vec4> clip_positions;       ///< The clip space positions of the current occluder.
+    unsigned int rasterized_triangle_count; ///< The amount of triangles rasterized this frame.
+};
@@ -0,0 +1,94 @@
+/***************************************************************************************************
+ * @file  PVS.hpp
+ * @brief Declaration of the PVS class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "maths/vec3.hpp"
+#include "mesh/Mesh.hpp"
+
+/**
+ * @class PVS
+ * @brief Potentially visible sets of a static scene: the bounds of the scene are divided into a grid
+ * of cells and each cell stores the set of objects that can be seen from somewhere inside of it.\n
+ * The sets are baked offline by casting rays from random points of each cell against the triangles of
+ * every object, then stored as bitsets whose runs of zero bytes are compressed. Objects are indexed in
+ * the order they were given when baking.
+ */
+class PVS {
+public:
+    /**
+     * @brief Creates an empty PVS, which doesn't have any cell.
+     */
+    PVS();
+
+    /**
+     * @brief Bakes the visibility of objects on every thread of the machine. Each cell casts rays in
+     * random directions and rays towards random points of each object it didn't see yet, an object
+     * being visible if one of the rays reaches it before hitting another one.
+     * @param objects The objects, which all need to be in the same space. Objects without triangles are
+     * visible from everywhere.
+     * @param are_occluders Whether the triangles of each object hide the objects behind them, which
+     * shouldn't be the case for transparent objects.
+     * @param resolution The amount of cells along the longest axis of the objects' bounds.
+     */
+    void bake(const std::vector<const Mesh*>& objects, const std::vector<bool>& are_occluders,
+              unsigned int resolution = 32);
+
+    /**
+     * @brief Writes the PVS to a binary file.
+     * @param path The path to the file.
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Reads a PVS from a binary file written by save.
+     * @param path The path to the file.
+     */
+    void load(const std::filesystem::path& path);
+
+    /**
+     * @return Whether the PVS doesn't have any cell, in which case every object is visible.
+     */
+    bool is_empty() const;
+
+    /**
+     * @return The amount of objects the PVS was baked for.
+     */
+    unsigned int get_object_count() const;
+
+    /**
+     * @return The amount of cells of the grid.
+     */
+    unsigned int get_cell_count() const;
+
+    /**
+     * @return The size of the compressed sets, in bytes.
+     */
+    std::size_t get_compressed_size() const;
+
+    /**
+     * @brief Finds the objects that can be seen from the cell containing a position. The set of the last
+     * cell is kept decompressed so that looking up the same cell again only costs finding it.
+     * @param position The position, in the space of the objects.
+     * @return A bitset with one bit per object, bit i of word i / 64 being set if object i is
+     * potentially visible, or nullptr if the position is outside of the grid.
+     */
+    const std::vector<uint64_t>* find_visible_objects(const vec3& position) const;
+
+private:
+    vec3 grid_min;             ///< The minimum corner of the grid.
+    vec3 cell_size;            ///< The size of a cell on each axis.
+    uvec3 cell_counts;         ///< The amount of cells on each axis.
+    unsigned int object_count; ///< The amount of objects.
+
+    std::vector<unsigned int> cell_offsets; ///< The offset of each cell's set in the data, then its size.
+    std::vector<unsigned char> data;        ///< The compressed sets of every cell.
+
+    mutable int cached_cell;                              ///< The last cell looked up, -1 if none.
+    mutable std::vector<uint64_t> cached_visible_objects; ///< The decompressed set of the last cell.
+};
@@ -16,6 +16,7 @@
 #define DEBUG_LOG_GLTF_READ_INFO
 
 // #define DEBUG_ENABLE_FRUSTUM_TESTS
+// #define DEBUG_FREEZE_FRUSTUM_TESTS
 // #define DEBUG_SHOW_BOUNDING_BOXES
 
 #endif
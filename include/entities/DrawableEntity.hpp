@@ -6,9 +6,41 @@
 #pragma once
 
 #include "culling/AABB.hpp"
+#include "culling/AABBArrays.hpp"
+#include "culling/BVH.hpp"
+#include "culling/OcclusionCuller.hpp"
 #include "Entity.hpp"
 #include "Shader.hpp"
 
+/**
+ * @struct DrawStatistics
+ * @brief Counters of the drawable entities met while drawing the scene graph. Each culling thread
+ * accumulates its own counters, which are summed once the threads are done.
+ */
+struct DrawStatistics {
+    /**
+     * @brief Adds the counters of other statistics to these.
+     * @param other The other statistics.
+     * @return A reference to these statistics.
+     */
+    DrawStatistics& operator +=(const DrawStatistics& other) {
+        drawable_entities += other.drawable_entities;
+        not_hidden_entities += other.not_hidden_entities;
+        drawn_entities += other.drawn_entities;
+        occluded_entities += other.occluded_entities;
+        culled_meshlet_triangles += other.culled_meshlet_triangles;
+        pvs_culled_entities += other.pvs_culled_entities;
+        return *this;
+    }
+
+    unsigned int drawable_entities = 0;        ///< The amount of drawable entities.
+    unsigned int not_hidden_entities = 0;      ///< The amount of drawable entities that aren't hidden.
+    unsigned int drawn_entities = 0;           ///< The amount of drawable entities that passed culling.
+    unsigned int occluded_entities = 0;        ///< The amount of drawable entities culled by occlusion.
+    unsigned int culled_meshlet_triangles = 0; ///< The amount of triangles skipped by meshlet culling.
+    unsigned int pvs_culled_entities = 0;      ///< The amount of drawable entities culled by a PVS.
+};
+
 /**
  * @class DrawableEntity
  * @brief Pure virtual class that represents an entity that can be drawn.
@@ -23,16 +55,41 @@ public:
     DrawableEntity(const std::string& name, const Shader& shader);
 
     /**
-     * @brief Frees the aabb.
+     * @brief Removes the entity from its BVH and its bounds arrays.
      */
     ~DrawableEntity() override;
 
     /**
-     * @brief Recursively draws this entity and its children if they're drawable.
+     * @brief Recursively adds the draw packets of this entity and its children if they're drawable to a
+     * render queue. Entities in a BVH are skipped since they're drawn by querying it, and baked ones
+     * since their merged mesh draws them, but their children are still enqueued. The other ones with
+     * bounds are culled by the frustum, their screen size and occlusion.
+     * @param render_queue The render queue.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     * @param occlusion_culler The occlusion culler whose occluders are rasterized, nullptr if occlusion
+     * culling is disabled.
+     */
+    void enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                 const OcclusionCuller* occlusion_culler) const override;
+
+    /**
+     * @brief Adds the draw packets of the entity to a render queue once it passed culling. By default,
+     * a single opaque packet sorted by shader and depth draws the whole entity.
+     * @param render_queue The render queue.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    virtual void enqueue_visible(RenderQueue& render_queue, const mat4& view_projection_matrix,
+                                 const Frustum& frustum) const;
+
+    /**
+     * @brief Draws the whole entity and its bounding box if DEBUG_SHOW_BOUNDING_BOXES is defined.
+     * @param packet The packet.
      * @param view_projection_matrix The projection matrix multiplied by the view matrix.
      * @param frustum The view frustum.
      */
-    void draw(const mat4& view_projection_matrix, const Frustum& frustum) const override;
+    void draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const override;
 
     /**
      * @brief Updates uniforms then draws the entity.
@@ -40,6 +97,20 @@ public:
      */
     virtual void draw(const mat4& view_projection_matrix) const = 0;
 
+    /**
+     * @brief Draws the entity's bounding box if DEBUG_SHOW_BOUNDING_BOXES is defined, does nothing
+     * otherwise.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     */
+    void draw_bounding_box(const mat4& view_projection_matrix) const;
+
+    /**
+     * @param camera_position The position of the camera.
+     * @return The distance between the camera and the center of the world space bounds, or the global
+     * position if the entity doesn't have bounds, used to sort its draw packets.
+     */
+    float get_camera_distance(const vec3& camera_position) const;
+
     /**
      * @brief Updates these uniforms if they exist in the shader:\n
      * - u_mvp\n
@@ -50,7 +121,67 @@ public:
     virtual void update_uniforms(const mat4& view_projection_matrix) const;
 
     /**
-     * @brief Creates the aabb for this entity, a bounding volume used for optimization.
+     * @brief Counts the entity in the aggregate of its subtree and, if it isn't drawn by querying a BVH
+     * or baked, adds its world space bounds, the subtree becoming unbounded if it doesn't have any.
+     * @param aggregate The aggregate of the subtree.
+     */
+    void add_to_subtree_aggregate(SubtreeAggregate& aggregate) const override;
+
+    /**
+     * @brief Recomputes the world space bounding box from the local one and the global model, refits
+     * the entity's leaf in its BVH and updates its bounds arrays.
+     */
+    void update_world_bounds() override;
+
+    /**
+     * @brief Inserts the entity in a BVH, removing it from its previous one. Does nothing if the entity
+     * doesn't have bounds or was baked. The entity is then only drawn by querying the BVH. Its leaf is
+     * only in the BVH while the entity is visible.
+     * @param bvh The BVH.
+     */
+    void insert_in_bvh(BVH& bvh);
+
+    /**
+     * @return Whether the entity is in a BVH.
+     */
+    bool is_in_bvh() const;
+
+    /**
+     * @brief Adds the entity's bounds to bounds arrays, removing them from the previous ones. Does
+     * nothing if the entity doesn't have bounds or was baked. The bounds are only in the arrays while
+     * the entity is visible.
+     * @param aabb_arrays The bounds arrays.
+     */
+    void insert_in_aabb_arrays(AABBArrays& aabb_arrays);
+
+    /**
+     * @brief Removes the entity from its BVH and from its bounds arrays, after which it is drawn while
+     * walking the scene graph again.
+     */
+    void remove_from_culling_structures();
+
+    /**
+     * @brief Marks the entity as baked into a merged mesh, which draws it from then on, and removes it
+     * from its culling structures. The entity itself isn't drawn anymore but stays visible, so that its
+     * descendants that weren't baked are still drawn.
+     */
+    void bake();
+
+    /**
+     * @return The amount of triangles the entity rasterizes as an occluder, 0 if it can't be one.
+     */
+    virtual unsigned int get_occluder_triangle_count() const;
+
+    /**
+     * @brief Rasterizes the entity's triangles into the depth buffer of an occlusion culler. Does
+     * nothing by default.
+     * @param occlusion_culler The occlusion culler.
+     */
+    virtual void rasterize_occluder(OcclusionCuller& occlusion_culler) const;
+
+    /**
+     * @brief Creates the aabb for this entity, a bounding volume used for optimization, by pointing
+     * to the local bounds of the drawn asset.
      */
     virtual void create_aabb() = 0;
 
@@ -61,9 +192,37 @@ public:
     constexpr EntityType get_type() const override { return ENTITY_TYPE_DRAWABLE; }
 
     const Shader& shader; ///< A pointer to the shader used when rendering.
-    AABB* aabb;           ///< The bounding volume of the entity.
+    const AABB* aabb;     ///< The local space bounding volume of the entity, owned by its asset.
+    AABB world_bounds;    ///< The world space bounding volume, updated when the transform changes.
+
+    mutable unsigned char last_failed_frustum_plane; ///< The frustum plane that last culled the entity.
+
+    BVH* bvh;     ///< The BVH holding the entity, nullptr if it isn't in one.
+    int bvh_leaf; ///< The index of the entity's leaf in its BVH, BVH_NULL_NODE while it's hidden.
+
+    AABBArrays* aabb_arrays;        ///< The bounds arrays holding the entity, nullptr if it isn't in any.
+    unsigned int aabb_arrays_index; ///< The index of its bounds in them, AABB_ARRAYS_NULL_INDEX while it's hidden.
+
+    bool is_baked; ///< Whether the entity was baked into a merged mesh, which draws it instead.
+
+    static inline DrawStatistics statistics; ///< The statistics of the last draw, filled by the main thread.
 
-    static inline unsigned int total_drawable_entities = 0;
-    static inline unsigned int total_not_hidden_entities = 0;
-    static inline unsigned int total_drawn_entities = 0;
+protected:
+    /**
+     * @brief Removes the entity's leaf and bounds from its BVH and bounds arrays when it's hidden, so
+     * that culling doesn't visit it, and adds them back when it's shown.
+     * @param is_drawn Whether the entity and all of its ancestors are now visible.
+     */
+    void on_visibility_changed(bool is_drawn) override;
+
+private:
+    /**
+     * @brief Adds the entity's leaf and bounds to its BVH and bounds arrays if they aren't in them.
+     */
+    void attach_to_culling_structures();
+
+    /**
+     * @brief Removes the entity's leaf and bounds from its BVH and bounds arrays, which it stays in.
+     */
+    void detach_from_culling_structures();
 };
@@ -5,9 +5,13 @@
 
 #pragma once
 
-#include <list>
+#include "culling/AABB.hpp"
 #include "culling/Frustum.hpp"
+#include "culling/OcclusionCuller.hpp"
+#include "entities/EntityArena.hpp"
 #include "maths/Transform.hpp"
+#include "RenderQueue.hpp"
+#include "utility/SmallVector.hpp"
 
 enum EntityType {
     ENTITY_TYPE_DEFAULT,
@@ -19,12 +23,41 @@ enum EntityType {
     ENTITY_TYPE_SCENE,
 };
 
+/**
+ * @brief The amount of children an entity stores without allocating memory.
+ */
+constexpr std::size_t ENTITY_INLINE_CHILD_COUNT = 4;
+
+/**
+ * @struct SubtreeAggregate
+ * @brief Summary of what an entity and its descendants draw while walking the scene graph, so that the
+ * walk can skip the whole subtree with a single test. Entities drawn by querying a BVH aren't drawn
+ * by the walk so they're only counted.
+ */
+struct SubtreeAggregate {
+    AABB bounds;                       ///< The world space bounds of what the walk draws in the subtree.
+    bool has_bounds = false;           ///< Whether the bounds contain anything.
+    bool is_bounded = true;            ///< Whether everything the walk draws in the subtree is in the bounds.
+    unsigned int drawable_count = 0;   ///< The amount of drawable entities in the subtree.
+    unsigned int not_hidden_count = 0; ///< The amount of them visible if the subtree's parent is.
+
+    /**
+     * @brief Adds bounds to the aggregate.
+     * @param other_bounds The world space bounds.
+     */
+    void add_bounds(const AABB& other_bounds) {
+        bounds = has_bounds ? bounds.merged(other_bounds) : other_bounds;
+        has_bounds = true;
+    }
+};
+
 /**
  * @class Entity
- * @brief An entity in the scene graph, implements a tree-like classure with an std::list of pointers
- * to its children entities. Handles the propagation of its local transform to its children.
+ * @brief An entity in the scene graph, implements a tree-like classure with a small vector of pointers
+ * to its children entities, which are allocated by the entity arena of the scene graph. Its transform
+ * is stored in the transform system of the scene graph, which propagates it to its children.
  */
-class Entity {
+class Entity : public TransformOwner {
 public:
     /**
      * @brief Creates an entity with a specified name.
@@ -33,12 +66,12 @@ public:
     explicit Entity(const std::string& name);
 
     /**
-     * @brief Frees the children.
+     * @brief Destroys the entity. Its children aren't destroyed since they belong to its arena.
      */
-    virtual ~Entity();
+    virtual ~Entity() = default;
 
     /**
-     * @brief Add a child to the entity.
+     * @brief Add a child to the entity, allocated by the entity's arena.
      * @tparam EntityClass The type of entity to add.
      * @tparam Args The types of the arguments of the new child's conclassor.
      * @param child_name The name of the child entity.
@@ -47,46 +80,127 @@ public:
      */
     template <typename EntityClass, typename... Args>
     EntityClass* add_child(const std::string& child_name, Args&&... args) {
-        EntityClass* child = new EntityClass(child_name, std::forward<Args>(args)...);
+        EntityClass* child = arena->create<EntityClass>(child_name, std::forward<Args>(args)...);
         children.push_back(child);
         child->parent = this;
+        child->arena = arena;
+        child->transform.attach(child, transform);
+        invalidate_subtree_aggregate();
         return child;
     }
 
     /**
-     * @brief Changes the visibility for this entity and all its children.
-     * @param is_visible Whether this entity and its children are visible.
+     * @brief Changes the visibility of this entity. Its descendants inherit it without being modified:
+     * an entity is only visible if it and all of its ancestors are. If the change shows or hides the
+     * subtree, its entities are notified with on_visibility_changed.
+     * @param is_visible Whether this entity is visible.
      */
     void set_visibility(bool is_visible);
 
     /**
-     * @return Whether the entity is visible.
+     * @return Whether the entity and all of its ancestors are visible.
      */
     bool get_visibility() const;
 
     /**
-     * @brief Toggles the visibility for this entity and sets all of its children's visibility to
-     * the same value.
+     * @return Whether the entity itself is visible, regardless of its ancestors.
+     */
+    bool get_local_visibility() const;
+
+    /**
+     * @brief Toggles the visibility of this entity, which its descendants inherit.
      */
     void toggle_visibility();
 
     /**
-     * @brief Check if the local model was modified, updates it if it was and do the same thing for
-     * all children.
+     * @brief Marks the aggregate of this entity's subtree and of its ancestors' subtrees as out of
+     * date. Needs to be called whenever what the entity draws or its bounds change.
+     */
+    void invalidate_subtree_aggregate();
+
+    /**
+     * @brief Recomputes the aggregate of the subtree if it's out of date, recomputing the aggregates
+     * of the out of date subtrees of the children first.
+     * @return The aggregate of the subtree.
+     */
+    const SubtreeAggregate& get_subtree_aggregate() const;
+
+    /**
+     * @brief Adds what the entity itself, without its children, draws while walking the scene graph to
+     * the aggregate of its subtree. Does nothing by default.
+     * @param aggregate The aggregate of the subtree.
+     */
+    virtual void add_to_subtree_aggregate(SubtreeAggregate& aggregate) const;
+
+    /**
+     * @brief Updates what the entity computes from its global model. Does nothing by default.
      */
-    void update_transform_and_children();
+    virtual void update_world_bounds();
 
     /**
-     * @brief Update the local model of this entity and all its children.
+     * @brief Updates the world bounds, called by the transform system each time the global model
+     * changes.
      */
-    void force_update_transform_and_children();
+    void on_global_model_updated() final;
 
     /**
-     * @brief Recursively draws this entity and its children if they're drawable.
+     * @brief Recursively adds the draw packets of this entity and its children if they're drawable to a
+     * render queue.
+     * @param render_queue The render queue.
      * @param view_projection_matrix The projection matrix multiplied by the view matrix.
      * @param frustum The view frustum.
+     * @param occlusion_culler The occlusion culler whose occluders are rasterized, nullptr if occlusion
+     * culling is disabled.
      */
-    virtual void draw(const mat4& view_projection_matrix, const Frustum& frustum) const;
+    virtual void enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                         const OcclusionCuller* occlusion_culler) const;
+
+    /**
+     * @brief Adds the draw packets of the children's subtrees to a render queue. Subtrees that are
+     * hidden, that only contain entities drawn by querying a BVH, or whose aggregate bounds are outside
+     * of the frustum are skipped with a single test, their drawable entities only being counted in the
+     * draw statistics.
+     * @param render_queue The render queue.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     * @param occlusion_culler The occlusion culler whose occluders are rasterized, nullptr if occlusion
+     * culling is disabled.
+     */
+    void enqueue_children(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                          const OcclusionCuller* occlusion_culler) const;
+
+    /**
+     * @brief Draws one of the packets the entity added to a render queue. Does nothing by default.
+     * @param packet The packet.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    virtual void draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const;
+
+    /**
+     * @brief Adds the objects and the indirect commands of the first packets of a run of packets that
+     * can be drawn along this entity's first one with a multi draw call. Doesn't add any by default.
+     * @param packets The run of packets, starting with one of this entity's.
+     * @param count The amount of packets in the run.
+     * @param instances The objects to add to, one per packet.
+     * @param commands The commands to add to, whose base instance is the index of their first object.
+     * @return The amount of packets added from the start of the run.
+     */
+    virtual unsigned int add_to_batch(const DrawPacket* packets, unsigned int count,
+                                      std::vector<InstanceData>& instances,
+                                      std::vector<DrawElementsIndirectCommand>& commands) const;
+
+    /**
+     * @brief Draws packets added by add_to_batch with a single multi draw indirect call, the commands
+     * being read from the bound indirect buffer. Does nothing by default.
+     * @param packets The packets, starting with one of this entity's.
+     * @param packet_count The amount of packets.
+     * @param first_command The index of the first command in the indirect buffer.
+     * @param command_count The amount of commands.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     */
+    virtual void draw_batch(const DrawPacket* packets, unsigned int packet_count, unsigned int first_command,
+                            unsigned int command_count, const mat4& view_projection_matrix) const;
 
     /**
      * @brief Add this entity to the object editor. Allows to modify these fields in the entity:\n
@@ -103,11 +217,31 @@ public:
      */
     virtual constexpr EntityType get_type() const { return ENTITY_TYPE_DEFAULT; }
 
-    std::string name;            ///< The entity's name.
-    std::list<Entity*> children; ///< The entity's children
-    Entity* parent;              ///< The entity's parent.
-    Transform transform;         ///< The entity's transform.
+    std::string name;                                         ///< The entity's name.
+    SmallVector<Entity*, ENTITY_INLINE_CHILD_COUNT> children; ///< The entity's children.
+    Entity* parent;                                           ///< The entity's parent.
+    EntityArena* arena;                                       ///< The arena allocating the entity's children.
+    Transform transform;                                      ///< The entity's transform.
 
 protected:
-    bool is_visible; ///< Whether the entity is visible.
+    /**
+     * @brief Called when the entity is shown or hidden by a change of its own visibility or of one of
+     * its ancestors'. Does nothing by default.
+     * @param is_drawn Whether the entity and all of its ancestors are now visible.
+     */
+    virtual void on_visibility_changed(bool is_drawn);
+
+    bool is_visible; ///< Whether the entity itself is visible.
+
+private:
+    /**
+     * @brief Notifies the entity and its descendants that they were shown or hidden, skipping the
+     * subtrees of the entities hidden themselves since they stay hidden.
+     * @param is_drawn Whether the entity and all of its ancestors are now visible.
+     */
+    void propagate_visibility_change(bool is_drawn);
+
+    mutable SubtreeAggregate subtree_aggregate;      ///< The aggregate of the subtree.
+    mutable bool is_subtree_aggregate_dirty;         ///< Whether the aggregate needs to be recomputed.
+    mutable unsigned char last_failed_subtree_plane; ///< The frustum plane that last culled the subtree.
 };
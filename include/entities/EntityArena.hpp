@@ -0,0 +1,109 @@
+/***************************************************************************************************
+ * @file  EntityArena.hpp
+ * @brief Declaration of the EntityArena class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+/**
+ * @class EntityArena
+ * @brief Allocates the entities of a scene graph in blocks, each concrete entity type having its own
+ * blocks so that entities of the same type are contiguous in memory. Entities can't be destroyed one
+ * by one: they are all destroyed at once with the arena, block by block.
+ */
+class EntityArena {
+public:
+    /**
+     * @brief Creates an empty arena.
+     */
+    EntityArena();
+
+    /**
+     * @brief Destroys every entity then frees the blocks.
+     */
+    ~EntityArena();
+
+    EntityArena(const EntityArena&) = delete;
+    EntityArena& operator =(const EntityArena&) = delete;
+
+    /**
+     * @brief Constructs an entity in the blocks of its type.
+     * @tparam EntityClass The type of entity to create.
+     * @tparam Args The types of the arguments of the entity's constructor.
+     * @param args The arguments of the entity's constructor.
+     * @return The new entity's pointer.
+     */
+    template <typename EntityClass, typename... Args>
+    EntityClass* create(Args&&... args) {
+        const unsigned int pool_index = find_pool(typeid(EntityClass), sizeof(EntityClass), alignof(EntityClass),
+                                                  [](void* entity) { static_cast<EntityClass*>(entity)->~EntityClass(); });
+
+        // The slot is only taken once the constructor succeeded so that a throwing one doesn't leave a
+        // slot that would be destroyed with the arena
+        EntityClass* entity = new(get_free_slot(pool_index)) EntityClass(std::forward<Args>(args)...);
+        ++pools[pool_index].blocks.back().count;
+        ++entity_count;
+
+        return entity;
+    }
+
+    /**
+     * @return The amount of entities in the arena.
+     */
+    unsigned int size() const;
+
+    /**
+     * @return The amount of blocks allocated by the arena.
+     */
+    unsigned int get_block_count() const;
+
+private:
+    /**
+     * @struct Block
+     * @brief Memory holding several entities of the same type.
+     */
+    struct Block {
+        std::byte* memory;     ///< The memory of the entities.
+        unsigned int capacity; ///< The amount of entities that fit in the block.
+        unsigned int count;    ///< The amount of entities constructed in the block.
+    };
+
+    /**
+     * @struct Pool
+     * @brief The blocks of a concrete entity type.
+     */
+    struct Pool {
+        std::type_index type;      ///< The type of the entities.
+        std::size_t size;          ///< The size of an entity.
+        std::size_t alignment;     ///< The alignment of an entity.
+        void (*destroy)(void*);    ///< Calls the destructor of an entity.
+        std::vector<Block> blocks; ///< The blocks, only the last one having free slots.
+    };
+
+    /**
+     * @brief Finds the pool of a type, creating it if it doesn't exist yet.
+     * @param type The type of the entities.
+     * @param size The size of an entity.
+     * @param alignment The alignment of an entity.
+     * @param destroy Calls the destructor of an entity.
+     * @return The index of the pool.
+     */
+    unsigned int find_pool(std::type_index type, std::size_t size, std::size_t alignment, void (*destroy)(void*));
+
+    /**
+     * @brief Finds the next free slot of a pool, allocating a block twice as large as the previous one
+     * if the last block is full.
+     * @param pool_index The index of the pool.
+     * @return The memory of the slot.
+     */
+    void* get_free_slot(unsigned int pool_index);
+
+    std::vector<Pool> pools;   ///< The pool of each type of entity.
+    unsigned int entity_count; ///< The amount of entities in the arena.
+};
@@ -36,6 +36,34 @@ public:
      */
     void update_uniforms(const mat4& view_projection_matrix) const override;
 
+    /**
+     * @return Whether the mesh is drawn with transparency, which is when its color or its material has
+     * some.
+     */
+    bool has_transparency() const override;
+
+    /**
+     * @return The color the mesh should be rendered in.
+     */
+    vec4 get_instance_color() const override;
+
+    /**
+     * @param other Another mesh entity.
+     * @return Whether both entities can be drawn as a single merged mesh, which also needs them to have
+     * the same color.
+     */
+    bool can_be_merged_with(const MeshEntity& other) const override;
+
+    /**
+     * @brief Adds a child to an entity drawing a mesh merged from entities that can be merged with this
+     * one, with the same shader, material and color as this one.
+     * @param parent The entity the child is added to.
+     * @param name The name of the child.
+     * @param merged_mesh The merged mesh, whose vertices are in world space.
+     * @return The new child.
+     */
+    MeshEntity* add_merged_child(Entity& parent, const std::string& name, Mesh& merged_mesh) const override;
+
     /**
      * @brief Add this entity to the object editor. Allows to modify these fields in the entity:\n
      * - The transform's local position\n
@@ -30,6 +30,78 @@ public:
      */
     void draw(const mat4& view_projection_matrix) const override;
 
+    /**
+     * @brief Adds a packet drawing the mesh at the level of detail matching its screen size, sorted by
+     * shader, diffuse map, material and mesh, to the transparent pass if the mesh has transparency.
+     * The packet can be batched if the shader has an instanced variant.
+     * @param render_queue The render queue.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void enqueue_visible(RenderQueue& render_queue, const mat4& view_projection_matrix,
+                         const Frustum& frustum) const override;
+
+    /**
+     * @brief Updates uniforms then draws the mesh at the packet's level of detail.
+     * @param packet The packet.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const override;
+
+    /**
+     * @brief Adds an object for each packet from the start of a run whose entity has the same shader
+     * and material as this one and an indexed mesh with the same primitive in the same mesh buffer.
+     * Consecutive packets drawing the same mesh at the same level of detail share a command, drawing
+     * one instance per packet.
+     * @param packets The run of packets, starting with one of this entity's.
+     * @param count The amount of packets in the run.
+     * @param instances The objects to add to, one per packet.
+     * @param commands The commands to add to.
+     * @return The amount of packets added.
+     */
+    unsigned int add_to_batch(const DrawPacket* packets, unsigned int count, std::vector<InstanceData>& instances,
+                              std::vector<DrawElementsIndirectCommand>& commands) const override;
+
+    /**
+     * @brief Updates the uniforms of the instanced variant of the shader then draws the meshes of the
+     * packets with a single multi draw indirect call.
+     * @param packets The packets, starting with one of this entity's.
+     * @param packet_count The amount of packets.
+     * @param first_command The index of the first command in the indirect buffer.
+     * @param command_count The amount of commands.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     */
+    void draw_batch(const DrawPacket* packets, unsigned int packet_count, unsigned int first_command,
+                    unsigned int command_count, const mat4& view_projection_matrix) const override;
+
+    /**
+     * @return Whether the mesh is drawn with transparency, which is when its material has some.
+     */
+    virtual bool has_transparency() const;
+
+    /**
+     * @return The color of the entity's object when it is drawn in a batch, white by default.
+     */
+    virtual vec4 get_instance_color() const;
+
+    /**
+     * @param other Another mesh entity.
+     * @return Whether both entities can be drawn as a single merged mesh, which is when they're of the
+     * same type, have the same shader and material, and meshes with the same primitive and attributes.
+     */
+    virtual bool can_be_merged_with(const MeshEntity& other) const;
+
+    /**
+     * @brief Adds a child to an entity drawing a mesh merged from entities that can be merged with this
+     * one, with the same shader and material as this one.
+     * @param parent The entity the child is added to.
+     * @param name The name of the child.
+     * @param merged_mesh The merged mesh, whose vertices are in world space.
+     * @return The new child.
+     */
+    virtual MeshEntity* add_merged_child(Entity& parent, const std::string& name, Mesh& merged_mesh) const;
+
     /**
      * @brief Updates these uniforms if they exist in the shader:\n
      * - u_mvp\n
@@ -51,11 +123,22 @@ public:
     void add_to_object_editor() override;
 
     /**
-     * @brief Creates an AABB bounding volume for the entity by computing the mesh's minimum and
-     * maximum coordinates.
+     * @brief Uses the mesh's bounding box, computed when it was loaded, as the entity's bounding
+     * volume.
      */
     void create_aabb() override;
 
+    /**
+     * @return The amount of triangles of the mesh, 0 if its primitive isn't triangles.
+     */
+    unsigned int get_occluder_triangle_count() const override;
+
+    /**
+     * @brief Rasterizes the triangles of the mesh into the depth buffer of an occlusion culler.
+     * @param occlusion_culler The occlusion culler.
+     */
+    void rasterize_occluder(OcclusionCuller& occlusion_culler) const override;
+
     /**
      * @brief Returns the type of the entity.
      * @return ENTITY_TYPE_TRIANGLE_MESH.
@@ -64,4 +147,5 @@ public:
 
     Mesh& mesh; ///< The mesh to render.
     Material* material; ///< The mesh's material.
+    const Shader* instanced_shader; ///< The instanced variant of the shader, nullptr if it doesn't have any.
 };
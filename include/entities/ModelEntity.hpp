@@ -29,6 +29,26 @@ public:
      */
     void draw(const mat4& view_projection_matrix) const override;
 
+    /**
+     * @brief Adds a packet for each of the model's meshes, at the level of detail matching its share of
+     * the model's screen size, sorted by shader, diffuse map, material and mesh. Meshes whose material
+     * has transparency are added to the transparent pass.
+     * @param render_queue The render queue.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void enqueue_visible(RenderQueue& render_queue, const mat4& view_projection_matrix,
+                         const Frustum& frustum) const override;
+
+    /**
+     * @brief Updates uniforms then draws the packet's mesh with its material at the packet's level of
+     * detail.
+     * @param packet The packet.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const override;
+
     /**
      * @brief Add this entity to the object editor. Allows to modify these fields in the entity:\n
      * - The transform's local position\n
@@ -41,6 +61,18 @@ public:
 
     void create_aabb() override;
 
+    /**
+     * @return The amount of triangles of the model's meshes whose primitive is triangles.
+     */
+    unsigned int get_occluder_triangle_count() const override;
+
+    /**
+     * @brief Rasterizes the triangles of the model's meshes into the depth buffer of an occlusion
+     * culler.
+     * @param occlusion_culler The occlusion culler.
+     */
+    void rasterize_occluder(OcclusionCuller& occlusion_culler) const override;
+
     /**
      * @brief Returns the type of the entity.
      * @return ENTITY_TYPE_MODEL.
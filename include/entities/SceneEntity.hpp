@@ -28,11 +28,34 @@ public:
     constexpr EntityType get_type() const override { return ENTITY_TYPE_SCENE; }
 
     /**
-     * @brief Recursively draws this entity and its children if they're drawable.
+     * @brief Recursively adds the draw packets of this entity and its children if they're drawable to a
+     * render queue. Each primitive of the scene is culled on its own, has its own packet and is counted
+     * as a drawable entity in the draw statistics.
+     * @param render_queue The render queue.
      * @param view_projection_matrix The projection matrix multiplied by the view matrix.
      * @param frustum The view frustum.
+     * @param occlusion_culler The occlusion culler whose occluders are rasterized, nullptr if occlusion
+     * culling is disabled.
      */
-    void draw(const mat4& view_projection_matrix, const Frustum& frustum) const override;
+    void enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                 const OcclusionCuller* occlusion_culler) const override;
+
+    /**
+     * @brief Rasterizes the largest opaque primitives of the scene as occluders if it isn't hidden.
+     * @param occlusion_culler The occlusion culler, between its begin and build_hierarchy calls.
+     * @param frustum The view frustum.
+     * @return The amount of primitives rasterized.
+     */
+    unsigned int rasterize_occluders(OcclusionCuller& occlusion_culler, const Frustum& frustum) const;
+
+    /**
+     * @brief Draws the primitive of a packet, counting the triangles skipped by meshlet culling in the
+     * draw statistics.
+     * @param packet The packet.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param frustum The view frustum.
+     */
+    void draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const override;
 
     /**
      * @brief Draws the scene.
@@ -40,6 +63,30 @@ public:
      */
     void draw(const mat4& view_projection_matrix) const;
 
+    /**
+     * @brief Updates the world space bounds of the scene from the global model.
+     */
+    void update_world_bounds() override;
+
+    /**
+     * @brief Counts each primitive of the scene as a drawable entity in the aggregate of the subtree
+     * and adds the world space bounds of the scene.
+     * @param aggregate The aggregate of the subtree.
+     */
+    void add_to_subtree_aggregate(SubtreeAggregate& aggregate) const override;
+
+    /**
+     * @brief Add this entity to the object editor. Allows to modify these fields in the entity:\n
+     * - The transform's local position\n
+     * - The transform's local orientation\n
+     * - The transform's local scale\n
+     * - Whether the entity is hidden\n
+     * - Whether the scene's PVS is used\n
+     * Also allows to bake the scene's PVS.
+     */
+    void add_to_object_editor() override;
+
 private:
     Scene scene;
+    AABB world_bounds; ///< The world space bounds of the scene, updated when the transform changes.
 };
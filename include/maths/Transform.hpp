@@ -5,23 +5,50 @@
 
 #pragma once
 
+#include "maths/affine3x4.hpp"
+#include "maths/mat3.hpp"
 #include "maths/mat4.hpp"
 #include "maths/transforms.hpp"
+#include "maths/TransformSystem.hpp"
 
 /**
  * @class Transform
  * @brief Holds information about an entity's local position, orientation and scale and stores its
  * global transformation information, the product of the local model matrices of all its parents and
- * itself.
+ * itself. The values are stored in a transform system, the transform only holding their index.
  */
 class Transform {
 public:
     /**
-     * @brief Default constructor, creates a transform at the origin, with no orientation and a
-     * scale of 1.
+     * @brief Default constructor, creates a transform that isn't part of a transform system yet. One of
+     * the attach methods needs to be called before using it.
      */
     Transform();
 
+    /**
+     * @brief Removes the transform from its transform system.
+     */
+    ~Transform();
+
+    Transform(const Transform&) = delete;
+    Transform& operator =(const Transform&) = delete;
+
+    /**
+     * @brief Adds the transform to a transform system, as a root, at the origin, with no orientation
+     * and a scale of 1.
+     * @param system The transform system.
+     * @param owner The owner of the transform, notified when its global model is recomputed.
+     */
+    void attach(TransformSystem& system, TransformOwner* owner);
+
+    /**
+     * @brief Adds the transform to the transform system of its parent, at the origin, with no
+     * orientation and a scale of 1.
+     * @param owner The owner of the transform, notified when its global model is recomputed.
+     * @param parent The transform of the owner's parent.
+     */
+    void attach(TransformOwner* owner, const Transform& parent);
+
     /**
      * @brief Changes the local position of the transform.
      * @param position The transform's new position.
@@ -89,7 +116,8 @@ public:
 
     /**
      * @return A reference to the transform's local position. If the value is modified,
-     * set_local_model_to_dirty need to be called.
+     * set_local_model_to_dirty need to be called. Only valid until a transform is added to or removed
+     * from the transform system.
      */
     vec3& get_local_position_reference();
 
@@ -100,7 +128,8 @@ public:
 
     /**
      * @return A reference to the transform's local orientation. If the value is modified,
-     * set_local_model_to_dirty need to be called.
+     * set_local_model_to_dirty need to be called. Only valid until a transform is added to or removed
+     * from the transform system.
      */
     quaternion& get_local_orientation_reference();
 
@@ -111,7 +140,8 @@ public:
 
     /**
      * @return A reference to the transform's local scale. If the value is modified,
-     * set_local_model_to_dirty need to be called.
+     * set_local_model_to_dirty need to be called. Only valid until a transform is added to or removed
+     * from the transform system.
      */
     vec3& get_local_scale_reference();
 
@@ -122,10 +152,16 @@ public:
     mat4 get_global_model() const;
 
     /**
-     * @return A const reference to the transform's global model, the product of the local model
-     * matrices of all its parents and itself.
+     * @return A const reference to the transform's global model stored as an affine transform, the
+     * product of the local model matrices of all its parents and itself.
+     */
+    const affine3x4& get_global_affine_model() const;
+
+    /**
+     * @return A const reference to the transform's global normal matrix, the transpose of the
+     * inverse of the upper-left 3 by 3 part of the global model.
      */
-    const mat4& get_global_model_const_reference() const;
+    const mat3& get_normal_matrix() const;
 
     /**
      * @return The transform's global position.
@@ -162,28 +198,18 @@ public:
      * @brief Computes and returns the local model matrix.
      * @return The transform's local model matrix.
      */
-    mat4 compute_local_model() const;
+    affine3x4 compute_local_model() const;
 
     /**
-     * @brief Sets the value of the global model matrix to the local model matrix. Used if the entity
-     * related to the transform does not have any parents.
+     * @brief Computes and returns the local normal matrix analytically from the local orientation
+     * and scale, without inverting any matrix.
+     * @return The transform's local normal matrix.
      */
-    void update_global_model();
-
-    /**
-     * @brief Sets the value of the global model matrix to the product of the global model of the
-     * parent of the entity related to the transform and the transform's local model matrix.
-     * @param parent_global_model The entity related to the transform's parent's global model matrix.
-     */
-    void update_global_model(const mat4& parent_global_model);
+    mat3 compute_local_normal_matrix() const;
 
 private:
-    vec3 local_position;          ///< The transform's local position.
-    quaternion local_orientation; ///< The transform's local orientation.
-    vec3 local_scale;             ///< The transform's local scale.
-
-    bool is_dirty; ///< Whether the local model was modified.
+    friend class TransformSystem;
 
-    /// The transform's global model, the product of the local model matrices of all its parents and itself.
-    mat4 global_model;
+    TransformSystem* system; ///< The transform system storing the transform's values.
+    unsigned int index;      ///< The index of the transform in the system, updated when it's sorted.
 };
@@ -0,0 +1,158 @@
+/***************************************************************************************************
+ * @file  TransformSystem.hpp
+ * @brief Declaration of the TransformSystem class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "maths/affine3x4.hpp"
+#include "maths/mat3.hpp"
+#include "maths/quaternion.hpp"
+#include "maths/vec3.hpp"
+#include "utility/ThreadPool.hpp"
+
+class Transform;
+
+/**
+ * @brief Index used by the transform system for missing parents.
+ */
+constexpr int TRANSFORM_NULL_INDEX = -1;
+
+/**
+ * @class TransformOwner
+ * @brief Interface of the objects owning a transform, which the transform system notifies when it
+ * recomputes the global model of their transform.
+ */
+class TransformOwner {
+public:
+    /**
+     * @brief Default destructor.
+     */
+    virtual ~TransformOwner() = default;
+
+    /**
+     * @brief Called by the transform system once the global model of the owned transform was
+     * recomputed, on the thread updating the system, in depth-first order.
+     */
+    virtual void on_global_model_updated() = 0;
+};
+
+/**
+ * @class TransformSystem
+ * @brief Stores the transforms of every entity of a scene graph in contiguous arrays, one per field,
+ * entities holding the index of their transform. The transforms are kept in depth-first order so that
+ * parents always come before their children and every subtree is a contiguous range, which lets the
+ * global models be updated in a single linear pass instead of walking the graph. Modified transforms
+ * are listed when they're modified so that updating doesn't cost anything if none of them were.
+ */
+class TransformSystem {
+public:
+    /**
+     * @brief Creates an empty transform system.
+     */
+    TransformSystem();
+
+    /**
+     * @brief Adds a transform at the origin, with no orientation and a scale of 1. Adding a transform to
+     * a parent whose subtree isn't at the end of the arrays breaks the depth-first order, which is
+     * restored during the next update by moving the transforms.
+     * @param transform The transform, whose index is kept up to date.
+     * @param owner The owner of the transform, notified when its global model is recomputed.
+     * @param parent The index of the parent's transform, TRANSFORM_NULL_INDEX if it doesn't have any.
+     * @return The index of the new transform.
+     */
+    unsigned int add(Transform* transform, TransformOwner* owner, int parent);
+
+    /**
+     * @brief Removes a transform. Its slot is only freed during the next update so the indices of the
+     * other transforms stay valid until then.
+     * @warning The transforms of the entity's children need to be removed first.
+     * @param index The index of the transform.
+     */
+    void remove(unsigned int index);
+
+    /**
+     * @brief Recomputes the global model and normal matrices of the modified transforms and of their
+     * descendants, then notifies their owners. The modified transforms are
+     * sorted in depth-first order so that the ones inside of the subtree of another are updated with
+     * it, only the subtrees of the others being updated. The local matrices of the modified transforms
+     * are computed 4 at a time with SIMD. Large updated subtrees are split into ranges of sibling
+     * subtrees whose global matrices are computed in depth-first order by the threads of a thread pool,
+     * once their ancestors were computed. Every matrix is computed by the same operations whatever the
+     * thread, so the results don't depend on the amount of threads.
+     * @param thread_pool The threads computing the matrices.
+     */
+    void update(ThreadPool& thread_pool);
+
+    /**
+     * @return The amount of transforms, including the removed ones waiting to be freed.
+     */
+    unsigned int size() const;
+
+    /**
+     * @return The amount of global models recomputed during the last update.
+     */
+    unsigned int get_updated_count() const;
+
+private:
+    friend class Transform;
+
+    /**
+     * @brief Marks a transform as modified, listing it if it wasn't already.
+     * @param index The index of the transform.
+     */
+    void mark_dirty(unsigned int index);
+
+    /**
+     * @brief Moves the transforms in depth-first order, frees the slots of the removed ones, recomputes
+     * the subtree sizes, updates the indices stored by the transforms and lists the modified transforms
+     * again with their new indices.
+     */
+    void sort();
+
+    /**
+     * @brief Computes the local model and normal matrices of a range of the modified transforms.
+     * @param begin The index of the first modified transform of the range in dirty_indices.
+     * @param end The index after the last one.
+     */
+    void compute_local_matrices(unsigned int begin, unsigned int end);
+
+    /**
+     * @brief Computes the global model and normal matrices of a transform from its parent's.
+     * @param index The index of the transform.
+     */
+    void compute_global_matrices(unsigned int index);
+
+    /**
+     * @brief Splits a range of updated sibling subtrees into tasks of at most TRANSFORM_TASK_SIZE
+     * transforms. Subtrees too large for a single task have their root added to the spine and their
+     * children split in turn.
+     * @param begin The index of the first transform of the range.
+     * @param end The index after the last one.
+     */
+    void split_update(unsigned int begin, unsigned int end);
+
+    std::vector<vec3> local_positions;          ///< The local position of each transform.
+    std::vector<quaternion> local_orientations; ///< The local orientation of each transform.
+    std::vector<vec3> local_scales;             ///< The local scale of each transform.
+
+    std::vector<affine3x4> local_models;     ///< The local model of each transform.
+    std::vector<mat3> local_normal_matrices; ///< The local normal matrix of each transform.
+    std::vector<affine3x4> global_models;    ///< The global model of each transform.
+    std::vector<mat3> normal_matrices;       ///< The global normal matrix of each transform.
+
+    std::vector<int> parents;                ///< The index of each transform's parent.
+    std::vector<unsigned int> subtree_sizes; ///< The amount of transforms in each subtree, itself included.
+    std::vector<Transform*> transforms;      ///< The transform at each index, nullptr once removed.
+    std::vector<TransformOwner*> owners;     ///< The owner of each transform.
+    std::vector<unsigned char> dirty_flags;  ///< Whether each local model was modified.
+
+    std::vector<unsigned int> dirty_indices;                           ///< The modified transforms, listed once.
+    std::vector<std::pair<unsigned int, unsigned int>> updated_ranges; ///< The updated subtrees.
+    std::vector<unsigned int> spine_indices;                           ///< The transforms computed before the tasks.
+    std::vector<std::pair<unsigned int, unsigned int>> update_tasks;   ///< The ranges computed by each task.
+    unsigned int updated_count;                                        ///< The amount of transforms updated.
+    bool is_sorted;                                                    ///< Whether the transforms are in depth-first order.
+};
@@ -0,0 +1,160 @@
+/***************************************************************************************************
+ * @file  affine3x4.hpp
+ * @brief Declaration of the affine3x4 struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include <ostream>
+#include "mat3.hpp"
+#include "mat4.hpp"
+#include "quaternion.hpp"
+#include "vec3.hpp"
+
+/**
+ * @struct affine3x4
+ * @brief Represents an affine transform as the first 3 rows of a 4 by 4 matrix, the fourth row
+ * always being (0, 0, 0, 1). Only stores 12 floats instead of the 16 of a mat4.
+ */
+struct affine3x4 {
+public:
+    /**
+     * @brief Constructs the identity transform.
+     */
+    constexpr affine3x4()
+        : values{
+            { 1.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f },
+            { 0.0f, 0.0f, 0.0f }
+        } { }
+
+    /**
+     * @brief Constructs an affine3x4 with a specific value for each component.
+     * @param v00, v01, v02, v03 The values of the components of the first row.
+     * @param v10, v11, v12, v13 The values of the components of the second row.
+     * @param v20, v21, v22, v23 The values of the components of the third row.
+     */
+    constexpr affine3x4(float v00, float v01, float v02, float v03,
+                        float v10, float v11, float v12, float v13,
+                        float v20, float v21, float v22, float v23)
+        : values{
+            { v00, v10, v20 },
+            { v01, v11, v21 },
+            { v02, v12, v22 },
+            { v03, v13, v23 }
+        } { }
+
+    /**
+     * @brief Constructs an affine3x4 from the first 3 rows of a mat4. The fourth row is ignored.
+     * @param mat The mat4.
+     */
+    explicit constexpr affine3x4(const mat4& mat)
+        : values{
+            { mat(0, 0), mat(1, 0), mat(2, 0) },
+            { mat(0, 1), mat(1, 1), mat(2, 1) },
+            { mat(0, 2), mat(1, 2), mat(2, 2) },
+            { mat(0, 3), mat(1, 3), mat(2, 3) }
+        } { }
+
+    /**
+     * @brief Accesses an element of the affine3x4.
+     * @param row The row's index, between 0 and 2.
+     * @param column The column's index, between 0 and 3.
+     * @return A reference to the element.
+     */
+    constexpr float& operator ()(int row, int column) { return values[column][row]; }
+
+    /**
+     * @brief Accesses an element of the affine3x4.
+     * @param row The row's index, between 0 and 2.
+     * @param column The column's index, between 0 and 3.
+     * @return A const reference to the element.
+     */
+    constexpr const float& operator ()(int row, int column) const { return values[column][row]; }
+
+    /**
+     * @return The equivalent mat4, with (0, 0, 0, 1) as its fourth row.
+     */
+    mat4 get_matrix() const;
+
+    /**
+     * @return The upper-left 3 by 3 part of the transform, without the translation.
+     */
+    mat3 get_linear_part() const;
+
+    /**
+     * @return The translation part of the transform.
+     */
+    vec3 get_translation() const;
+
+private:
+    float values[4][3]; ///< The values of the affine3x4, column by column.
+};
+
+/**
+ * @brief Writes the components of the given affine3x4 to the output stream, row by row.
+ * @param stream The output stream to write to.
+ * @param mat The affine3x4 to write to the stream.
+ * @return A reference to the output stream after writing the affine3x4.
+ */
+std::ostream& operator <<(std::ostream& stream, const affine3x4& mat);
+
+/**
+ * @brief Composes two affine transforms.
+ * @param left The left operand.
+ * @param right The right operand.
+ * @return The product of the two affine3x4, applying right then left.
+ */
+affine3x4 operator *(const affine3x4& left, const affine3x4& right);
+
+/**
+ * @brief Multiplies a mat4 by an affine transform, taking advantage of the known fourth row.
+ * @param left The mat4, usually a view projection matrix.
+ * @param right The affine3x4, usually a model matrix.
+ * @return The product of the two matrices.
+ */
+mat4 operator *(const mat4& left, const affine3x4& right);
+
+/**
+ * @brief Transforms a point by an affine transform.
+ * @param mat The affine3x4.
+ * @param point The point.
+ * @return The transformed point.
+ */
+vec3 operator *(const affine3x4& mat, const vec3& point);
+
+/**
+ * @brief Calculates the inverse of any invertible affine transform.
+ * @param mat The affine3x4.
+ * @return The inverse of the transform, or the identity if it isn't invertible.
+ */
+affine3x4 inverse(const affine3x4& mat);
+
+/**
+ * @brief Calculates the affine TRS transform such that TRS=T*Rq*S, with T being a translation
+ * matrix, Rq being the rotation matrix derived from a quaternion S being a scale matrix.
+ * @param translation The value of the translation vector.
+ * @param rotation The rotation quaternion. Assumed to be a unit quaternion.
+ * @param scale The values of the scaling factors.
+ * @return The transform that scales then rotates then translates a point.
+ */
+affine3x4 TRS_affine(const vec3& translation, const quaternion& rotation, const vec3& scale);
+
+/**
+ * @brief Calculates the inverse of a TRS transform analytically: (T*R*S)^-1 = S^-1*R^T*T^-1.
+ * @param translation The value of the translation vector.
+ * @param rotation The rotation quaternion. Assumed to be a unit quaternion.
+ * @param scale The values of the scaling factors. Null factors are treated as 1.
+ * @return The inverse of the TRS transform.
+ */
+affine3x4 inverse_TRS_affine(const vec3& translation, const quaternion& rotation, const vec3& scale);
+
+/**
+ * @brief Calculates the normal matrix of a TRS transform analytically. The transpose of the inverse
+ * of R*S is R*S^-1, which is the rotation matrix with each column divided by its scaling factor.
+ * @param rotation The rotation quaternion. Assumed to be a unit quaternion.
+ * @param scale The values of the scaling factors. Null factors are treated as 1.
+ * @return The normal matrix of the TRS transform.
+ */
+mat3 TRS_normal_matrix(const quaternion& rotation, const vec3& scale);
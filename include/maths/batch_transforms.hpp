@@ -0,0 +1,97 @@
+/***************************************************************************************************
+ * @file  batch_transforms.hpp
+ * @brief Declaration of functions transforming arrays of points and normals
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include "mat3.hpp"
+#include "mat4.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+/**
+ * @brief Transforms an array of points, each point p being replaced by mat * (p.x, p.y, p.z, 1.0).
+ * The w component of the result is discarded, the matrix is therefore assumed to be affine.
+ * @param mat The transform matrix.
+ * @param in The points to transform.
+ * @param out The transformed points. Must have the same size as in and can be the same array.
+ */
+void transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out);
+
+/**
+ * @brief Transforms an array of homogeneous points, each point p being replaced by mat * p.
+ * @param mat The transform matrix.
+ * @param in The points to transform.
+ * @param out The transformed points. Must have the same size as in and can be the same array.
+ */
+void transform_points(const mat4& mat, std::span<const vec4> in, std::span<vec4> out);
+
+/**
+ * @brief Transforms points stored as 3 consecutive floats inside of an interleaved array, like the
+ * positions in a vertex buffer. The w component of the result is discarded.
+ * @param mat The transform matrix.
+ * @param in A pointer to the x component of the first point to transform.
+ * @param in_stride The amount of floats between the start of two consecutive input points.
+ * @param out A pointer to the x component of the first transformed point. Can be equal to in if
+ * both strides are the same.
+ * @param out_stride The amount of floats between the start of two consecutive output points.
+ * @param count The amount of points.
+ */
+void transform_points(const mat4& mat,
+                      const float* in, std::size_t in_stride,
+                      float* out, std::size_t out_stride,
+                      std::size_t count);
+
+/**
+ * @brief Transforms points stored as a structure of arrays, each point p being replaced by
+ * mat * (p.x, p.y, p.z, 1.0). Output arrays can be the same as the input ones.
+ * @param mat The transform matrix.
+ * @param in_x, in_y, in_z The components of the points to transform.
+ * @param out_x, out_y, out_z The components of the transformed points.
+ * @param out_w The w component of the transformed points. Can be nullptr if not needed.
+ * @param count The amount of points.
+ */
+void transform_points(const mat4& mat,
+                      const float* in_x, const float* in_y, const float* in_z,
+                      float* out_x, float* out_y, float* out_z, float* out_w,
+                      std::size_t count);
+
+/**
+ * @brief Transforms an array of normals, each normal n being replaced by normalize(mat * n).
+ * @param mat The normal matrix, usually the transpose of the inverse of a model matrix.
+ * @param in The normals to transform.
+ * @param out The transformed normals. Must have the same size as in and can be the same array.
+ */
+void transform_normals(const mat3& mat, std::span<const vec3> in, std::span<vec3> out);
+
+/**
+ * @brief Transforms normals stored as 3 consecutive floats inside of an interleaved array, each
+ * normal n being replaced by normalize(mat * n).
+ * @param mat The normal matrix.
+ * @param in A pointer to the x component of the first normal to transform.
+ * @param in_stride The amount of floats between the start of two consecutive input normals.
+ * @param out A pointer to the x component of the first transformed normal. Can be equal to in if
+ * both strides are the same.
+ * @param out_stride The amount of floats between the start of two consecutive output normals.
+ * @param count The amount of normals.
+ */
+void transform_normals(const mat3& mat,
+                       const float* in, std::size_t in_stride,
+                       float* out, std::size_t out_stride,
+                       std::size_t count);
+
+/**
+ * @brief Transforms normals stored as a structure of arrays, each normal n being replaced by
+ * normalize(mat * n). Output arrays can be the same as the input ones.
+ * @param mat The normal matrix.
+ * @param in_x, in_y, in_z The components of the normals to transform.
+ * @param out_x, out_y, out_z The components of the transformed normals.
+ * @param count The amount of normals.
+ */
+void transform_normals(const mat3& mat,
+                       const float* in_x, const float* in_y, const float* in_z,
+                       float* out_x, float* out_y, float* out_z,
+                       std::size_t count);
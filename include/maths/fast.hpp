@@ -0,0 +1,156 @@
+/***************************************************************************************************
+ * @file  fast.hpp
+ * @brief Declaration of fast approximations of common maths functions
+ **************************************************************************************************/
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "constants.hpp"
+#include "simd.hpp"
+#include "vec3.hpp"
+
+/**
+ * These functions trade accuracy for speed and are meant to be used explicitly where full precision
+ * is wasted (mesh generation, noise, culling...). Each function documents its maximum error, measured
+ * over the whole documented input range, relative errors being relative to the exact result.
+ */
+
+/**
+ * @brief Reduces an angle to [-pi/2 ; pi/2] such that angle = k * pi + reduced_angle, pi being split
+ * in two constants to reduce the rounding error.
+ * @param angle The angle in radians.
+ * @param reduced_angle Stores the reduced angle.
+ * @return k, the number of half turns removed from the angle.
+ */
+inline int fast_reduce_angle(float angle, float& reduced_angle) {
+    const int k = static_cast<int>(angle * (1.0f / PI_F) + (angle < 0.0f ? -0.5f : 0.5f));
+    const float k_float = static_cast<float>(k);
+    reduced_angle = (angle - k_float * 3.140625f) - k_float * 9.67653589793e-4f;
+    return k;
+}
+
+/**
+ * @brief Approximates the sine of an angle with a degree 11 odd polynomial after reducing the angle
+ * to [-pi/2 ; pi/2]. Maximum absolute error: 2.5e-7 for angles in [-100 ; 100], the error grows
+ * slowly with the magnitude of the angle because of the range reduction.
+ * @param angle The angle in radians.
+ * @return An approximation of the sine of the angle.
+ */
+inline float fast_sin(float angle) {
+    float r;
+    const int k = fast_reduce_angle(angle, r);
+    const float r2 = r * r;
+
+    const float sine = r * (1.0f + r2 * (-1.6666667e-1f + r2 * (8.3333333e-3f + r2 * (-1.9841270e-4f
+                           + r2 * (2.7557319e-6f + r2 * -2.5052108e-8f)))));
+
+    return k & 1 ? -sine : sine;
+}
+
+/**
+ * @brief Approximates the cosine of an angle with a degree 12 even polynomial after reducing the
+ * angle to [-pi/2 ; pi/2]. Maximum absolute error: 2.5e-7 for angles in [-100 ; 100], the error
+ * grows slowly with the magnitude of the angle because of the range reduction.
+ * @param angle The angle in radians.
+ * @return An approximation of the cosine of the angle.
+ */
+inline float fast_cos(float angle) {
+    float r;
+    const int k = fast_reduce_angle(angle, r);
+    const float r2 = r * r;
+
+    const float cosine = 1.0f + r2 * (-0.5f + r2 * (4.1666667e-2f + r2 * (-1.3888889e-3f + r2 * (2.4801587e-5f
+                                + r2 * (-2.7557319e-7f + r2 * 2.0876757e-9f)))));
+
+    return k & 1 ? -cosine : cosine;
+}
+
+/**
+ * @brief Approximates the angle between the positive x axis and the point (x, y) with a degree 9 odd
+ * polynomial for atan on [0 ; 1]. Maximum absolute error: 1.2e-5 radians.
+ * @param y The y coordinate of the point.
+ * @param x The x coordinate of the point.
+ * @return An approximation of the angle in radians, in [-pi ; pi]. Returns 0 for (0, 0).
+ */
+inline float fast_atan2(float y, float x) {
+    const float abs_x = x < 0.0f ? -x : x;
+    const float abs_y = y < 0.0f ? -y : y;
+
+    const float max = abs_x > abs_y ? abs_x : abs_y;
+    if(max == 0.0f) { return 0.0f; }
+
+    const float t = (abs_x < abs_y ? abs_x : abs_y) / max;
+    const float t2 = t * t;
+
+    float angle = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+
+    if(abs_y > abs_x) { angle = PI_HALF_F - angle; }
+    if(x < 0.0f) { angle = PI_F - angle; }
+    return y < 0.0f ? -angle : angle;
+}
+
+/**
+ * @brief Approximates 1 / sqrt(value). Uses the rsqrtss instruction refined with one Newton-Raphson
+ * step when SSE is available and the 0x5f375a86 bit trick refined with two steps otherwise. Maximum
+ * relative error: 3e-7 with SSE, 5e-6 without.
+ * @param value A strictly positive value.
+ * @return An approximation of 1 / sqrt(value).
+ */
+inline float fast_rsqrt(float value) {
+#ifdef MATHS_USE_SSE
+    const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+    return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#else
+    float estimate = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<std::uint32_t>(value) >> 1));
+    estimate *= 1.5f - 0.5f * value * estimate * estimate;
+    return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#endif
+}
+
+/**
+ * @brief Approximates sqrt(value) as value * fast_rsqrt(value). Maximum relative error: the same as
+ * fast_rsqrt.
+ * @param value A positive value.
+ * @return An approximation of the square root of the value, 0 if the value is 0.
+ */
+inline float fast_sqrt(float value) {
+    return value > 0.0f ? value * fast_rsqrt(value) : 0.0f;
+}
+
+/**
+ * @brief Approximates the normalization of a vec3 by multiplying it by fast_rsqrt of its squared
+ * length. Maximum relative error on the length of the result: the same as fast_rsqrt.
+ * @param vec A non null vector.
+ * @return An approximation of the normalized vector.
+ */
+inline vec3 fast_normalize(const vec3& vec) {
+    return vec * fast_rsqrt(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
+}
+
+/**
+ * @brief Computes fast_sin and fast_cos of an array of angles, 4 angles at a time with SSE.
+ * Maximum absolute error: the same as fast_sin.
+ * @param angles The angles in radians.
+ * @param sines Stores the sines. Must have as many elements as angles.
+ * @param cosines Stores the cosines. Must have as many elements as angles.
+ */
+void fast_sin_cos(std::span<const float> angles, std::span<float> sines, std::span<float> cosines);
+
+/**
+ * @brief Computes fast_rsqrt of an array of values, 4 values at a time with SSE. Maximum relative
+ * error: the same as fast_rsqrt.
+ * @param values The strictly positive values.
+ * @param results Stores the results. Must have as many elements as values, can be the same array.
+ */
+void fast_rsqrt(std::span<const float> values, std::span<float> results);
+
+/**
+ * @brief Normalizes an array of vec3 in place with fast_normalize, 4 vectors at a time with SSE.
+ * Maximum relative error on the length of the results: the same as fast_rsqrt.
+ * @param vectors The non null vectors to normalize.
+ */
+void fast_normalize(std::span<vec3> vectors);
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cmath>
+#include <limits>
 #include "vec3.hpp"
 
 /**
@@ -14,8 +16,33 @@
  * @return value * value.
  */
 template <typename Type>
-Type pow2(Type value) {
+constexpr Type pow2(Type value) {
     return value * value;
 }
 
+/**
+ * @brief Computes the square root of a value. Uses std::sqrt at runtime and Newton's method when
+ * evaluated at compile time, the result being computed in double precision then rounded.
+ * @param value The value.
+ * @return The square root of the value, or NaN if the value is negative.
+ */
+constexpr float constexpr_sqrt(float value) {
+    if consteval {
+        if(value < 0.0f) { return std::numeric_limits<float>::quiet_NaN(); }
+        if(value == 0.0f || value == std::numeric_limits<float>::infinity()) { return value; }
+
+        double x = value;
+        double root = value > 1.0f ? x : 1.0;
+        for(int i = 0 ; i < 128 ; ++i) {
+            const double next = 0.5 * (root + x / root);
+            if(next == root) { break; }
+            root = next;
+        }
+
+        return static_cast<float>(root);
+    } else {
+        return std::sqrt(value);
+    }
+}
+
 vec3 hue_to_rgb(unsigned short hue);
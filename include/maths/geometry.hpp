@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "functions.hpp"
 #include "vec2.hpp"
 #include "vec3.hpp"
 #include "vec4.hpp"
@@ -14,21 +15,27 @@
  * @param vec The vec2.
  * @return The length.
  */
-float length(const vec2& vec);
+constexpr float length(const vec2& vec) {
+    return constexpr_sqrt(vec.x * vec.x + vec.y * vec.y);
+}
 
 /**
  * @brief Calculates the length of a vec3.
  * @param vec The vec3.
  * @return The length.
  */
-float length(const vec3& vec);
+constexpr float length(const vec3& vec) {
+    return constexpr_sqrt(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
+}
 
 /**
  * @brief Calculates the length of a vec4.
  * @param vec The vec4.
  * @return The length.
  */
-float length(const vec4& vec);
+constexpr float length(const vec4& vec) {
+    return constexpr_sqrt(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w);
+}
 
 /**
  * @brief Calculates the dot product of two vec2.
@@ -36,7 +43,9 @@ float length(const vec4& vec);
  * @param right The right operand.
  * @return The dot product of the two vec2.
  */
-float dot(const vec2& left, const vec2& right);
+constexpr float dot(const vec2& left, const vec2& right) {
+    return left.x * right.x + left.y * right.y;
+}
 
 /**
  * @brief Calculates the dot product of two vec3.
@@ -44,7 +53,9 @@ float dot(const vec2& left, const vec2& right);
  * @param right The right operand.
  * @return The dot product of the two vec3.
  */
-float dot(const vec3& left, const vec3& right);
+constexpr float dot(const vec3& left, const vec3& right) {
+    return left.x * right.x + left.y * right.y + left.z * right.z;
+}
 
 /**
  * @brief Calculates the dot product of two vec4.
@@ -52,28 +63,36 @@ float dot(const vec3& left, const vec3& right);
  * @param right The right operand.
  * @return The dot product of the two vec4.
  */
-float dot(const vec4& left, const vec4& right);
+constexpr float dot(const vec4& left, const vec4& right) {
+    return left.x * right.x + left.y * right.y + left.z * right.z + left.w * right.w;
+}
 
 /**
  * @brief Calculates the normalized vector of a vec2.
  * @param vec The vec2.
  * @return The normalized vec2.
  */
-vec2 normalize(const vec2& vec);
+constexpr vec2 normalize(const vec2& vec) {
+    return vec / length(vec);
+}
 
 /**
  * @brief Calculates the normalized vector of a vec3.
  * @param vec The vec3.
  * @return The normalized vec3.
  */
-vec3 normalize(const vec3& vec);
+constexpr vec3 normalize(const vec3& vec) {
+    return vec / length(vec);
+}
 
 /**
  * @brief Calculates the normalized vector of a vec4.
  * @param vec The vec4.
  * @return The normalized vec4.
  */
-vec4 normalize(const vec4& vec);
+constexpr vec4 normalize(const vec4& vec) {
+    return vec / length(vec);
+}
 
 /**
  * @brief Calculates the cross product of two vec3.
@@ -81,4 +100,10 @@ vec4 normalize(const vec4& vec);
  * @param right The right operand.
  * @return The cross product of the two vec3.
  */
-vec3 cross(const vec3& left, const vec3& right);
\ No newline at end of file
+constexpr vec3 cross(const vec3& left, const vec3& right) {
+    return vec3(
+        left.y * right.z - left.z * right.y,
+        left.z * right.x - left.x * right.z,
+        left.x * right.y - left.y * right.x
+    );
+}
@@ -19,7 +19,12 @@ public:
     /**
      * @brief Constructs a mat3 with all components equal to 0.
      */
-    mat3();
+    constexpr mat3()
+        : values{
+            { 0.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f }
+        } { }
 
     /**
      * @brief Constructs a mat3 with a specific value for each component.
@@ -27,16 +32,26 @@ public:
      * @param v10, v11, v12 The values of the first three components of the second row.
      * @param v20, v21, v22 The values of the first three components of the third row.
      */
-    mat3(float v00, float v01, float v02,
-         float v10, float v11, float v12,
-         float v20, float v21, float v22);
+    constexpr mat3(float v00, float v01, float v02,
+                   float v10, float v11, float v12,
+                   float v20, float v21, float v22)
+        : values{
+            { v00, v10, v20 },
+            { v01, v11, v21 },
+            { v02, v12, v22 }
+        } { }
 
     /**
      * @brief Constructs a mat3 which is the identity matrix multiplied by a scalar.
      * Each value of the diagonal is equal to the scalar and the rest is zeros.
      * @param scalar The value for the components on the diagonal.
      */
-    explicit mat3(float scalar);
+    explicit constexpr mat3(float scalar)
+        : values{
+            { scalar, 0.0f, 0.0f },
+            { 0.0f, scalar, 0.0f },
+            { 0.0f, 0.0f, scalar }
+        } { }
 
     /**
      * @brief Accesses an element of the mat3.
@@ -44,7 +59,7 @@ public:
      * @param column The column's index.
      * @return A reference to the element.
      */
-    float& operator ()(int row, int column);
+    constexpr float& operator ()(int row, int column) { return values[column][row]; }
 
     /**
      * @brief Accesses an element of the mat3.
@@ -52,7 +67,7 @@ public:
      * @param column The column's index.
      * @return A const reference to the element.
      */
-    const float& operator ()(int row, int column) const;
+    constexpr const float& operator ()(int row, int column) const { return values[column][row]; }
 
 private:
     float values[3][3]; ///< The values of the mat3.
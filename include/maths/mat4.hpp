@@ -18,7 +18,13 @@ public:
     /**
      * @brief Constructs a mat4 with all components equal to 0.
      */
-    mat4();
+    constexpr mat4()
+        : values{
+            { 0.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 0.0f }
+        } { }
 
     /**
      * @brief Constructs a mat4 with a specific value for each component.
@@ -27,10 +33,16 @@ public:
      * @param v20, v21, v22, v23 The values of the components of the third row.
      * @param v30, v31, v32, v33 The values of the components of the fourth row.
      */
-    mat4(float v00, float v01, float v02, float v03,
-         float v10, float v11, float v12, float v13,
-         float v20, float v21, float v22, float v23,
-         float v30, float v31, float v32, float v33);
+    constexpr mat4(float v00, float v01, float v02, float v03,
+                   float v10, float v11, float v12, float v13,
+                   float v20, float v21, float v22, float v23,
+                   float v30, float v31, float v32, float v33)
+        : values{
+            { v00, v10, v20, v30 },
+            { v01, v11, v21, v31 },
+            { v02, v12, v22, v32 },
+            { v03, v13, v23, v33 }
+        } { }
 
     /**
      * @brief Constructs a mat4 with a specific value for each component of the 3 first columns
@@ -39,16 +51,28 @@ public:
      * @param v10, v11, v12 The values of the first three components of the second row.
      * @param v20, v21, v22 The values of the first three components of the third row.
      */
-    mat4(float v00, float v01, float v02,
-         float v10, float v11, float v12,
-         float v20, float v21, float v22);
+    constexpr mat4(float v00, float v01, float v02,
+                   float v10, float v11, float v12,
+                   float v20, float v21, float v22)
+        : values{
+            { v00, v10, v20, 0.0f },
+            { v01, v11, v21, 0.0f },
+            { v02, v12, v22, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 1.0f }
+        } { }
 
     /**
      * @brief Constructs a mat4 which is the identity matrix multiplied by a scalar.
      * Each value of the diagonal is equal to the scalar and the rest is zeros.
      * @param scalar The value for the components on the diagonal.
      */
-    explicit mat4(float scalar);
+    explicit constexpr mat4(float scalar)
+        : values{
+            { scalar, 0.0f, 0.0f, 0.0f },
+            { 0.0f, scalar, 0.0f, 0.0f },
+            { 0.0f, 0.0f, scalar, 0.0f },
+            { 0.0f, 0.0f, 0.0f, scalar }
+        } { }
 
     /**
      * @brief Accesses an element of the mat4.
@@ -56,7 +80,7 @@ public:
      * @param column The column's index.
      * @return A reference to the element.
      */
-    inline float& operator ()(int row, int column) { return values[column][row]; }
+    constexpr float& operator ()(int row, int column) { return values[column][row]; }
 
     /**
      * @brief Accesses an element of the mat4.
@@ -64,7 +88,7 @@ public:
      * @param column The column's index.
      * @return A const reference to the element.
      */
-    inline const float& operator ()(int row, int column) const { return values[column][row]; }
+    constexpr const float& operator ()(int row, int column) const { return values[column][row]; }
 
     /**
      * @brief Applies a transform that scales by the same factor in all 3 directions.
@@ -169,7 +193,7 @@ public:
     mat4& rotate_z(float angle);
 
 private:
-    float values[4][4]; ///< The values of the mat4.
+    alignas(16) float values[4][4]; ///< The values of the mat4.
 };
 
 /**
@@ -16,7 +16,7 @@ struct quaternion {
     /**
      * @brief Constructs a quaternion with all coefficients set to 0.
      */
-    quaternion();
+    constexpr quaternion() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) { }
 
     /**
      * @brief Constructs a quaternion with a specific value for each coefficient.
@@ -25,7 +25,7 @@ struct quaternion {
      * @param z The value for the coefficient of the k imaginary unit.
      * @param w The value for the real part of the quaternion.
      */
-    quaternion(float x, float y, float z, float w);
+    constexpr quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) { }
 
     /**
      * @brief Adds another quaternion to this one.
@@ -0,0 +1,51 @@
+/***************************************************************************************************
+ * @file  simd.hpp
+ * @brief Compile-time selection of the SIMD instruction sets used by the maths module
+ **************************************************************************************************/
+
+#pragma once
+
+/**
+ * The maths module uses SSE whenever the target supports it (always the case on x86-64) and AVX
+ * when the code is compiled with -mavx2 (see the ENABLE_AVX CMake option). Defining MATHS_NO_SIMD
+ * forces the scalar code paths, which is useful to compare results: every SIMD kernel performs the
+ * exact same floating point operations in the same order as its scalar counterpart, so both give
+ * bit-identical results as long as the compiler is not allowed to contract them into FMAs.
+ */
+
+#if !defined(MATHS_NO_SIMD) && (defined(__SSE__) || defined(_M_X64))
+#define MATHS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(MATHS_USE_SSE) && defined(__AVX__)
+#define MATHS_USE_AVX
+#include <immintrin.h>
+#endif
+
+#ifdef MATHS_USE_SSE
+/**
+ * @brief Selects the lanes of a where the mask is set and the lanes of b elsewhere.
+ * @param mask The selection mask, each lane being either all ones or all zeros.
+ * @param a The values selected where the mask is set.
+ * @param b The values selected where the mask isn't set.
+ * @return The blended vector.
+ */
+inline __m128 simd_select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/**
+ * @brief Computes the linear combination c0 * v.x + c1 * v.y + c2 * v.z + c3 * v.w of 4 columns,
+ * accumulating from left to right like the scalar code does.
+ * @param columns A pointer to the 16 floats of the 4 consecutive columns.
+ * @param v The coefficients of the combination.
+ * @return The resulting column.
+ */
+inline __m128 simd_combine_columns(const float* columns, __m128 v) {
+    __m128 result = _mm_mul_ps(_mm_loadu_ps(columns), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(columns + 4), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(columns + 8), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+    return _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(columns + 12), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+#endif
@@ -5,16 +5,130 @@
 
 #pragma once
 
+#include <cmath>
+#include "constants.hpp"
+#include "functions.hpp"
+
 /**
  * @brief Converts degrees to radians.
  * @param deg The angle in degrees.
  * @return The angle in radians.
  */
-float degrees_to_radians(float deg);
+constexpr float degrees_to_radians(float deg) {
+    return deg * PI_F / 180.0f;
+}
 
 /**
  * @brief Converts radians to degrees.
  * @param rad The angle in radians.
  * @return The angle in degrees.
  */
-float radians_to_degrees(float rad);
\ No newline at end of file
+constexpr float radians_to_degrees(float rad) {
+    return rad * 180.0f / PI_F;
+}
+
+/**
+ * @brief Computes the sine of an angle. Uses std::sin at runtime and a Taylor series when evaluated
+ * at compile time, the result being computed in double precision then rounded.
+ * @param angle The angle in radians.
+ * @return The sine of the angle.
+ */
+constexpr float constexpr_sin(float angle) {
+    if consteval {
+        constexpr double pi = 3.14159265358979323846;
+
+        // Brings the angle in [-pi ; pi]
+        double x = angle;
+        x -= 2.0 * pi * static_cast<long long>(x / (2.0 * pi));
+        if(x > pi) { x -= 2.0 * pi; }
+        if(x < -pi) { x += 2.0 * pi; }
+
+        double term = x;
+        double sum = x;
+        for(int i = 1 ; i < 30 ; ++i) {
+            term *= -x * x / ((2 * i) * (2 * i + 1));
+            sum += term;
+        }
+
+        return static_cast<float>(sum);
+    } else {
+        return std::sin(angle);
+    }
+}
+
+/**
+ * @brief Computes the cosine of an angle. Uses std::cos at runtime and a Taylor series when
+ * evaluated at compile time, the result being computed in double precision then rounded.
+ * @param angle The angle in radians.
+ * @return The cosine of the angle.
+ */
+constexpr float constexpr_cos(float angle) {
+    if consteval {
+        constexpr double pi = 3.14159265358979323846;
+
+        // Brings the angle in [-pi ; pi]
+        double x = angle;
+        x -= 2.0 * pi * static_cast<long long>(x / (2.0 * pi));
+        if(x > pi) { x -= 2.0 * pi; }
+        if(x < -pi) { x += 2.0 * pi; }
+
+        double term = 1.0;
+        double sum = 1.0;
+        for(int i = 1 ; i < 30 ; ++i) {
+            term *= -x * x / ((2 * i - 1) * (2 * i));
+            sum += term;
+        }
+
+        return static_cast<float>(sum);
+    } else {
+        return std::cos(angle);
+    }
+}
+
+/**
+ * @brief Computes the angle between the positive x axis and the point (x, y). Uses std::atan2 at
+ * runtime and a Taylor series of atan when evaluated at compile time, the result being computed in
+ * double precision then rounded.
+ * @param y The y coordinate of the point.
+ * @param x The x coordinate of the point.
+ * @return The angle in radians, in [-pi ; pi].
+ */
+constexpr float constexpr_atan2(float y, float x) {
+    if consteval {
+        constexpr double pi = 3.14159265358979323846;
+
+        if(x == 0.0f && y == 0.0f) { return 0.0f; }
+
+        // atan(t) for |t| <= 1, the argument is reduced with atan(t) = 2 * atan(t / (1 + sqrt(1 + t^2)))
+        auto atan = [](double t) -> double {
+            double factor = 1.0;
+            for(int i = 0 ; i < 3 ; ++i) {
+                double root = 1.0 + t * t;
+                double s = root;
+                for(int j = 0 ; j < 64 ; ++j) { s = 0.5 * (s + root / s); }
+                t /= 1.0 + s;
+                factor *= 2.0;
+            }
+
+            double term = t;
+            double sum = t;
+            for(int i = 1 ; i < 30 ; ++i) {
+                term *= -t * t;
+                sum += term / (2 * i + 1);
+            }
+
+            return factor * sum;
+        };
+
+        const double abs_x = x < 0.0f ? -static_cast<double>(x) : x;
+        const double abs_y = y < 0.0f ? -static_cast<double>(y) : y;
+
+        double angle = abs_y <= abs_x ? atan(abs_y / abs_x) : 0.5 * pi - atan(abs_x / abs_y);
+        if(x < 0.0f) { angle = pi - angle; }
+        if(y < 0.0f) { angle = -angle; }
+
+        return static_cast<float>(angle);
+    } else {
+        return std::atan2(y, x);
+    }
+}
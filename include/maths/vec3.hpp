@@ -10,7 +10,7 @@
 using vec3 = vector3<float>;
 // using dvec3 = vector3<double>;
 // using ivec3 = vector3<int>;
-// using uvec3 = vector3<unsigned int>;
+using uvec3 = vector3<unsigned int>;
 // using lvec3 = vector3<long>;
 using llvec3 = vector3<long long>;
 // using ulvec3 = vector3<unsigned long>;
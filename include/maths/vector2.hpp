@@ -20,39 +20,39 @@ struct vector2 {
     /**
      * @brief Constructs a vector2 with all components set to 0 (or default initialized in the case of a class).
      */
-    vector2() : x(), y() { }
+    constexpr vector2() : x(), y() { }
 
     /**
      * @brief Constructs a vector2 with a specific value for each component.
      * @param x The value of the x component.
      * @param y The value of the y component.
      */
-    vector2(Type x, Type y) : x(x), y(y) { }
+    constexpr vector2(Type x, Type y) : x(x), y(y) { }
 
     /**
      * @brief Constructs a vector2 with its components specified by a vector3's first 2 components.
      * @param xyz The value of the xy (and the ignored z) components.
      */
-    vector2(const vector3<Type>& xyz) : x(xyz.x), y(xyz.y) { }
+    constexpr vector2(const vector3<Type>& xyz) : x(xyz.x), y(xyz.y) { }
 
     /**
      * @brief Constructs a vector2 with its components specified by a vector4's first 2 components.
      * @param xyzw The value of the xy (and the ignored z and w) components.
      */
-    vector2(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y) { }
+    constexpr vector2(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y) { }
 
     /**
      * @brief Constructs a vector2 with the same value for each component.
      * @param value The value of each component.
      */
-    explicit vector2(Type value) : x(value), y(value) { }
+    explicit constexpr vector2(Type value) : x(value), y(value) { }
 
     /**
      * @brief Adds another vector2's components to the current instance's components.
      * @param vec The vector2 to add.
      * @return A reference to this instance.
      */
-    vector2& operator +=(const vector2& vec) {
+    constexpr vector2& operator +=(const vector2& vec) {
         x += vec.x;
         y += vec.y;
 
@@ -64,7 +64,7 @@ struct vector2 {
      * @param vec The vector2 to subtract by.
      * @return A reference to this instance.
      */
-    vector2& operator -=(const vector2& vec) {
+    constexpr vector2& operator -=(const vector2& vec) {
         x -= vec.x;
         y -= vec.y;
 
@@ -76,7 +76,7 @@ struct vector2 {
      * @param vec The vector2 to multiply by.
      * @return A reference to this instance.
      */
-    vector2& operator *=(const vector2& vec) {
+    constexpr vector2& operator *=(const vector2& vec) {
         x *= vec.x;
         y *= vec.y;
 
@@ -88,7 +88,7 @@ struct vector2 {
      * @param vec The vector2 to divide by.
      * @return A reference to this instance.
      */
-    vector2& operator /=(const vector2& vec) {
+    constexpr vector2& operator /=(const vector2& vec) {
         x /= vec.x;
         y /= vec.y;
 
@@ -100,7 +100,7 @@ struct vector2 {
      * @param value The value to add.
      * @return A reference to this instance.
      */
-    vector2& operator +=(Type value) {
+    constexpr vector2& operator +=(Type value) {
         x += value;
         y += value;
 
@@ -112,7 +112,7 @@ struct vector2 {
      * @param value The value to subtract by.
      * @return A reference to this instance.
      */
-    vector2& operator -=(Type value) {
+    constexpr vector2& operator -=(Type value) {
         x -= value;
         y -= value;
 
@@ -124,7 +124,7 @@ struct vector2 {
      * @param value The value to multiply by.
      * @return A reference to this instance.
      */
-    vector2& operator *=(Type value) {
+    constexpr vector2& operator *=(Type value) {
         x *= value;
         y *= value;
 
@@ -136,7 +136,7 @@ struct vector2 {
      * @param value The value to divide by.
      * @return A reference to this instance.
      */
-    vector2& operator /=(Type value) {
+    constexpr vector2& operator /=(Type value) {
         x /= value;
         y /= value;
 
@@ -148,7 +148,7 @@ struct vector2 {
      * @param other The vector2 to compare with.
      * @return Whether the two vector2 are equal.
      */
-    bool operator ==(const vector2& other) const {
+    constexpr bool operator ==(const vector2& other) const {
         return x == other.x && y == other.y;
     }
 
@@ -157,7 +157,7 @@ struct vector2 {
      * @param other The vector2 to compare with.
      * @return Whether the two vector2 are different.
      */
-    bool operator !=(const vector2& other) const {
+    constexpr bool operator !=(const vector2& other) const {
         return x != other.x || y != other.y;
     }
 
@@ -196,7 +196,7 @@ std::istream& operator >>(std::istream& stream, vector2<Type>& vec) {
  *  @return The component-wise sum of the two vector2.
  */
 template <typename Type>
-vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x + right.x,
         left.y + right.y
@@ -209,7 +209,7 @@ vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise subtraction of the first vector2 by the second.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x - right.x,
         left.y - right.y
@@ -222,7 +222,7 @@ vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise product of the two vector2.
  */
 template <typename Type>
-vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x * right.x,
         left.y * right.y
@@ -235,7 +235,7 @@ vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise division of the first vector2 by the second.
  */
 template <typename Type>
-vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x / right.x,
         left.y / right.y
@@ -248,7 +248,7 @@ vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise sum of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator +(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator +(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x + value,
         vec.y + value
@@ -261,7 +261,7 @@ vector2<Type> operator +(const vector2<Type>& vec, Type value) {
  *  @return The component-wise subtraction of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator -(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x - value,
         vec.y - value
@@ -274,7 +274,7 @@ vector2<Type> operator -(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator *(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator *(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x * value,
         vec.y * value
@@ -287,7 +287,7 @@ vector2<Type> operator *(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator *(Type value, const vector2<Type>& vec) {
+constexpr vector2<Type> operator *(Type value, const vector2<Type>& vec) {
     return vector2<Type>(
         value * vec.x,
         value * vec.y
@@ -300,7 +300,7 @@ vector2<Type> operator *(Type value, const vector2<Type>& vec) {
  *  @return The component-wise division of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator /(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator /(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x / value,
         vec.y / value
@@ -313,6 +313,6 @@ vector2<Type> operator /(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by -1.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& vec) {
+constexpr vector2<Type> operator -(const vector2<Type>& vec) {
     return vector2(-vec.x, -vec.y);
 }
\ No newline at end of file
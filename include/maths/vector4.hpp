@@ -19,7 +19,7 @@ struct vector4 {
     /**
      * @brief Constructs a vector4 with all components set to 0 (or default initialized in the case of a class).
      */
-    vector4() : x(), y(), z(), w() { }
+    constexpr vector4() : x(), y(), z(), w() { }
 
     /**
      * @brief Constructs a vector4 with a specific value for each component.
@@ -28,7 +28,7 @@ struct vector4 {
      * @param z The value of the z component.
      * @param w The value of the w component.
      */
-    vector4(Type x, Type y, Type z, Type w) : x(x), y(y), z(z), w(w) { }
+    constexpr vector4(Type x, Type y, Type z, Type w) : x(x), y(y), z(z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with its first 2 components specified by a vector2 and its last 2
@@ -37,7 +37,7 @@ struct vector4 {
      * @param z The value of the z component.
      * @param w The value of the w component.
      */
-    vector4(const vector2<Type>& xy, float z, float w) : x(xy.x), y(xy.y), z(z), w(w) { }
+    constexpr vector4(const vector2<Type>& xy, float z, float w) : x(xy.x), y(xy.y), z(z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with its first 2 components specified by a vector2 and its last 2
@@ -45,7 +45,7 @@ struct vector4 {
      * @param xy The value of the x and y components.
      * @param zw The value of the z and w components.
      */
-    vector4(const vector2<Type>& xy, const vector2<Type> zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) { }
+    constexpr vector4(const vector2<Type>& xy, const vector2<Type> zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) { }
 
     /**
      * @brief Constructs a vector4 with its first 3 components specified by a vector3 and its last
@@ -53,20 +53,20 @@ struct vector4 {
      * @param xyz The value of the x, y and z components
      * @param w The value of the w component.
      */
-    vector4(const vector3<Type>& xyz, float w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) { }
+    constexpr vector4(const vector3<Type>& xyz, float w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with the same value for each component.
      * @param value The value of each component.
      */
-    explicit vector4(Type value) : x(value), y(value), z(value), w(value) { }
+    explicit constexpr vector4(Type value) : x(value), y(value), z(value), w(value) { }
 
     /**
      * @brief Adds another vector4's components to the current instance's components.
      * @param vec The vector4 to add.
      * @return A reference to this instance.
      */
-    vector4& operator +=(const vector4& vec) {
+    constexpr vector4& operator +=(const vector4& vec) {
         x += vec.x;
         y += vec.y;
         z += vec.z;
@@ -80,7 +80,7 @@ struct vector4 {
      * @param vec The vector4 to subtract by.
      * @return A reference to this instance.
      */
-    vector4& operator -=(const vector4& vec) {
+    constexpr vector4& operator -=(const vector4& vec) {
         x -= vec.x;
         y -= vec.y;
         z -= vec.z;
@@ -94,7 +94,7 @@ struct vector4 {
      * @param vec The vector4 to multiply by.
      * @return A reference to this instance.
      */
-    vector4& operator *=(const vector4& vec) {
+    constexpr vector4& operator *=(const vector4& vec) {
         x *= vec.x;
         y *= vec.y;
         z *= vec.z;
@@ -108,7 +108,7 @@ struct vector4 {
      * @param vec The vector4 to divide by.
      * @return A reference to this instance.
      */
-    vector4& operator /=(const vector4& vec) {
+    constexpr vector4& operator /=(const vector4& vec) {
         x /= vec.x;
         y /= vec.y;
         z /= vec.z;
@@ -122,7 +122,7 @@ struct vector4 {
      * @param value The value to add.
      * @return A reference to this instance.
      */
-    vector4& operator +=(Type value) {
+    constexpr vector4& operator +=(Type value) {
         x += value;
         y += value;
         z += value;
@@ -136,7 +136,7 @@ struct vector4 {
      * @param value The value to subtract by.
      * @return A reference to this instance.
      */
-    vector4& operator -=(Type value) {
+    constexpr vector4& operator -=(Type value) {
         x -= value;
         y -= value;
         z -= value;
@@ -150,7 +150,7 @@ struct vector4 {
      * @param value The value to multiply by.
      * @return A reference to this instance.
      */
-    vector4& operator *=(Type value) {
+    constexpr vector4& operator *=(Type value) {
         x *= value;
         y *= value;
         z *= value;
@@ -164,7 +164,7 @@ struct vector4 {
      * @param value The value to divide by.
      * @return A reference to this instance.
      */
-    vector4& operator /=(Type value) {
+    constexpr vector4& operator /=(Type value) {
         x /= value;
         y /= value;
         z /= value;
@@ -178,7 +178,7 @@ struct vector4 {
      * @param other The vector4 to compare with.
      * @return Whether the two vector4 are equal.
      */
-    bool operator ==(const vector4& other) const {
+    constexpr bool operator ==(const vector4& other) const {
         return x == other.x && y == other.y && z == other.z && w == other.w;
     }
 
@@ -187,7 +187,7 @@ struct vector4 {
      * @param other The vector4 to compare with.
      * @return Whether the two vector4 are different.
      */
-    bool operator !=(const vector4& other) const {
+    constexpr bool operator !=(const vector4& other) const {
         return x != other.x || y != other.y || z != other.z || w != other.w;
     }
 
@@ -229,7 +229,7 @@ std::istream& operator >>(std::istream& stream, vector4<Type>& vec) {
  *  @return The component-wise sum of the two vector4.
  */
 template <typename Type>
-vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x + right.x,
         left.y + right.y,
@@ -244,7 +244,7 @@ vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise subtraction of the first vector4 by the second.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x - right.x,
         left.y - right.y,
@@ -259,7 +259,7 @@ vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise product of the two vector4.
  */
 template <typename Type>
-vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x * right.x,
         left.y * right.y,
@@ -274,7 +274,7 @@ vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise division of the first vector4 by the second.
  */
 template <typename Type>
-vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x / right.x,
         left.y / right.y,
@@ -289,7 +289,7 @@ vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise sum of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator +(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator +(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x + value,
         vec.y + value,
@@ -304,7 +304,7 @@ vector4<Type> operator +(const vector4<Type>& vec, Type value) {
  *  @return The component-wise subtraction of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator -(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x - value,
         vec.y - value,
@@ -319,7 +319,7 @@ vector4<Type> operator -(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator *(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator *(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x * value,
         vec.y * value,
@@ -334,7 +334,7 @@ vector4<Type> operator *(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator *(Type value, const vector4<Type>& vec) {
+constexpr vector4<Type> operator *(Type value, const vector4<Type>& vec) {
     return vector4<Type>(
         value * vec.x,
         value * vec.y,
@@ -349,7 +349,7 @@ vector4<Type> operator *(Type value, const vector4<Type>& vec) {
  *  @return The component-wise division of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator /(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator /(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x / value,
         vec.y / value,
@@ -364,6 +364,6 @@ vector4<Type> operator /(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by -1.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& vec) {
+constexpr vector4<Type> operator -(const vector4<Type>& vec) {
     return vector4(-vec.x, -vec.y, -vec.z, -vec.w);
 }
@@ -8,7 +8,10 @@
 #include <vector>
 
 #include "Attribute.hpp"
+#include "MeshBuffer.hpp"
+#include "culling/AABB.hpp"
 #include "glad/glad.h"
+#include "maths/mat3.hpp"
 #include "maths/mat4.hpp"
 #include "maths/vec2.hpp"
 #include "maths/vec3.hpp"
@@ -21,6 +24,31 @@ enum class Primitive : unsigned char {
     TRIANGLES,
 };
 
+/**
+ * @struct MeshLOD
+ * @brief A level of detail of a mesh: a range of its index buffer and the error of the simplification
+ * that created it.
+ */
+struct MeshLOD {
+    unsigned int offset; ///< The position of the level's first index in the index buffer.
+    unsigned int count;  ///< The amount of indices of the level.
+    float error;         ///< The simplification error, relative to the radius of the mesh's bounds.
+};
+
+/**
+ * @struct Meshlet
+ * @brief A cluster of neighboring triangles of a mesh: a range of its index buffer with the bounds
+ * used to cull it as a whole.
+ */
+struct Meshlet {
+    unsigned int offset; ///< The position of the meshlet's first index in the index buffer.
+    unsigned int count;  ///< The amount of indices of the meshlet.
+    vec3 center;         ///< The center of the meshlet's local space bounding sphere.
+    float radius;        ///< The radius of the bounding sphere.
+    vec3 cone_axis;      ///< The average normal of the meshlet's triangles.
+    float cone_cutoff;   ///< The sine of the angle between the axis and the furthest normal, 1 if unbounded.
+};
+
 /**
  * @class Mesh
  * @brief
@@ -30,7 +58,55 @@ public:
     explicit Mesh(Primitive primitive = Primitive::NONE);
     ~Mesh();
 
-    void draw() const;
+    /**
+     * @brief Moves a mesh, which gives its allocation in its mesh buffer to the new one.
+     * @param mesh The moved mesh, whose buffers aren't bound anymore.
+     */
+    Mesh(Mesh&& mesh) noexcept;
+
+    /**
+     * @brief Frees the mesh's allocation then moves another mesh, giving its allocation to this one.
+     * @param mesh The moved mesh, whose buffers aren't bound anymore.
+     * @return This mesh.
+     */
+    Mesh& operator =(Mesh&& mesh) noexcept;
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator =(const Mesh&) = delete;
+
+    /**
+     * @brief Draws the mesh.
+     * @param lod The level of detail to draw, 0 being the full mesh. Clamped to the coarsest level.
+     */
+    void draw(unsigned int lod = 0) const;
+
+    /**
+     * @brief Draws several instances of the mesh with a single draw call, the shader reading the data
+     * of each instance from gl_BaseInstance + gl_InstanceID.
+     * @param instance_count The amount of instances.
+     * @param first_instance The index of the first instance, read as gl_BaseInstance.
+     * @param lod The level of detail to draw, 0 being the full mesh. Clamped to the coarsest level.
+     */
+    void draw_instanced(unsigned int instance_count, unsigned int first_instance, unsigned int lod = 0) const;
+
+    /**
+     * @brief Builds the indirect draw command drawing instances of the indexed mesh from its mesh
+     * buffer.
+     * @param lod The level of detail to draw, 0 being the full mesh. Clamped to the coarsest level.
+     * @param instance_count The amount of instances.
+     * @param first_instance The index of the first instance, read as gl_BaseInstance.
+     * @return The command.
+     */
+    DrawElementsIndirectCommand get_draw_command(unsigned int lod, unsigned int instance_count,
+                                                 unsigned int first_instance) const;
+
+    /**
+     * @brief Draws commands of indexed meshes sharing this mesh's buffer and primitive with a single
+     * multi draw call, the commands being read from the bound indirect buffer.
+     * @param first_command The index of the first command in the indirect buffer.
+     * @param command_count The amount of commands.
+     */
+    void draw_indirect(unsigned int first_command, unsigned int command_count) const;
 
     void set_primitive(Primitive primitive);
 
@@ -53,6 +129,11 @@ public:
      */
     size_t get_indices_amount() const;
 
+    /**
+     * @return The amount of triangles in the mesh, 0 if its primitive isn't triangles.
+     */
+    size_t get_triangle_count() const;
+
     AttributeType get_attribute_type(Attribute attribute);
 
     /**
@@ -64,12 +145,117 @@ public:
     void get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) const;
 
     /**
-     * @brief Delete OpenGL buffers and clears the vertices array and the indices array.
+     * @return The local space bounding box of the mesh, computed each time its buffers are bound.
+     */
+    const AABB& get_bounds() const;
+
+    /**
+     * @return The id of the vertex array of the mesh's buffer, 0 if its buffers aren't bound.
+     */
+    unsigned int get_vao() const;
+
+    /**
+     * @return An id ordering the meshes by vertex array then by the order their buffers were bound.
+     */
+    unsigned int get_sort_id() const;
+
+    /**
+     * @return The buffer the mesh's vertices and indices were allocated from, nullptr if its buffers
+     * aren't bound.
+     */
+    const MeshBuffer* get_buffer() const;
+
+    /**
+     * @return A pointer to the position of the first vertex, nullptr if the mesh doesn't have
+     * positions. Consecutive positions are separated by the stride.
+     */
+    const float* get_positions() const;
+
+    /**
+     * @param attribute The attribute.
+     * @return A pointer to the attribute's value of the first vertex, nullptr if the mesh doesn't have
+     * the attribute. Consecutive values are separated by the stride.
+     */
+    const float* get_attribute_data(Attribute attribute) const;
+
+    /**
+     * @return The amount of floats between the start of two consecutive vertices.
+     */
+    unsigned int get_stride() const;
+
+    /**
+     * @return The indices of the mesh, empty if its vertices are drawn in order.
+     */
+    const std::vector<unsigned int>& get_indices() const;
+
+    /**
+     * @brief Builds coarser levels of detail of a triangle mesh by simplifying each level into the
+     * next one with quadric error metrics, until a level doesn't remove enough triangles. The levels
+     * share the vertex buffer and are stored after the indices in the index buffer, so this needs to
+     * be called before binding the buffers. Does nothing if the mesh doesn't have triangle indices.
+     * @param lod_count The maximum amount of levels, including the full mesh.
+     * @param triangle_ratio The wanted ratio between the amount of triangles of two consecutive levels.
+     */
+    void generate_lods(unsigned int lod_count = 4, float triangle_ratio = 0.5f);
+
+    /**
+     * @brief Chooses the coarsest level of detail whose error is invisible at a certain screen size.
+     * @param screen_size The screen size of the mesh's bounds, see AABB::get_screen_size.
+     * @return The level of detail.
+     */
+    unsigned int select_lod(float screen_size) const;
+
+    /**
+     * @return The amount of levels of detail, including the full mesh.
+     */
+    unsigned int get_lod_count() const;
+
+    /**
+     * @brief Splits the triangles of the full mesh into meshlets, reordering its indices so that the
+     * triangles of each meshlet are contiguous. Needs to be called before binding the buffers. Does
+     * nothing if the mesh doesn't have triangle indices or fits in a single meshlet.
+     * @param max_vertices The maximum amount of vertices of a meshlet.
+     * @param max_triangles The maximum amount of triangles of a meshlet.
+     */
+    void generate_meshlets(unsigned int max_vertices = 64, unsigned int max_triangles = 124);
+
+    /**
+     * @return The meshlets of the mesh, empty if it wasn't split.
+     */
+    const std::vector<Meshlet>& get_meshlets() const;
+
+    /**
+     * @brief Finds the meshlets that are at least partially inside of a frustum and, optionally, that
+     * have triangles facing the camera. The tests are done in local space. Consecutive visible
+     * meshlets are merged into a single range of indices.
+     * @param frustum The view frustum.
+     * @param model The global model matrix of the mesh.
+     * @param cull_backfaces Whether meshlets whose triangles all face away from the camera are culled.
+     * @param counts Stores the amount of indices of each range. Is cleared.
+     * @param offsets Stores the byte offset of each range in the mesh buffer's index buffer. Is cleared.
+     * @return The amount of visible triangles.
+     */
+    unsigned int cull_meshlets(const Frustum& frustum, const affine3x4& model, bool cull_backfaces,
+                               std::vector<int>& counts, std::vector<const void*>& offsets) const;
+
+    /**
+     * @brief Culls the meshlets of the full mesh then draws the visible ones with a single multi draw
+     * call. Draws the full mesh if it doesn't have meshlets.
+     * @param frustum The view frustum.
+     * @param model The global model matrix of the mesh.
+     * @param cull_backfaces Whether meshlets whose triangles all face away from the camera are culled,
+     * should only be enabled when face culling is.
+     * @return The amount of triangles drawn.
+     */
+    unsigned int draw_meshlets(const Frustum& frustum, const affine3x4& model, bool cull_backfaces) const;
+
+    /**
+     * @brief Frees the mesh's allocation and clears the vertices array and the indices array.
      */
     void clear();
 
     /**
-     * @brief Delete OpenGL buffers.
+     * @brief Frees the mesh's allocation in its mesh buffer.
      */
     void delete_buffers();
 
@@ -82,6 +268,18 @@ public:
      */
     void apply_model_matrix(const mat4& model);
 
+    /**
+     * @brief Appends the vertices and indices of another mesh, transforming its positions and normals
+     * like apply_model_matrix does, so that meshes can be merged into a single one. The indices of the
+     * other mesh are offset by the amount of vertices already in this one, sequential indices being
+     * added if it isn't indexed. An empty mesh takes the primitive and the attributes of the other one.
+     * The buffers need to be bound again afterwards.
+     * @param mesh The mesh to append, with the same primitive and attributes.
+     * @param model The model matrix applied to the positions.
+     * @param normal_matrix The normal matrix applied to the normals.
+     */
+    void append_transformed(const Mesh& mesh, const mat4& model, const mat3& normal_matrix);
+
     /**
      * @brief  Enables an attribute by setting its data type.
      * @param attribute The attribute to enable.
@@ -111,6 +309,10 @@ public:
     void add_triangle(unsigned int top, unsigned int left, unsigned int right);
     void add_face(unsigned int topL, unsigned int bottomL, unsigned int bottomR, unsigned int topR);
 
+    /**
+     * @brief Computes the bounds of the mesh then uploads its vertices and indices to ranges allocated
+     * from the mesh buffer of its vertex layout, freeing its previous allocation.
+     */
     void bind_buffers();
 
     void push_value(float value);
@@ -120,10 +322,16 @@ public:
     void push_values(const float* values, unsigned int n);
 
     void push_indices_buffer(const std::vector<unsigned int>& indices);
+    void push_indices(const unsigned int* indices, unsigned int n);
 
 private:
     unsigned int get_attribute_offset(Attribute attribute) const;
 
+    /**
+     * @return Whether the mesh can be drawn, warning about why it can't otherwise.
+     */
+    bool can_be_drawn() const;
+
     template <typename Type, typename... Args>
     void add_vertex_helper(unsigned int attribute_id, Type&& value, Args&&... attribute_values) {
         while(attributes[attribute_id] == AttributeType::NONE) { ++attribute_id; }
@@ -155,9 +363,19 @@ private:
     std::vector<float> data;
     std::vector<unsigned int> indices;
 
-    unsigned int VAO;
-    unsigned int VBO;
-    unsigned int EBO;
+    std::vector<unsigned int> lod_indices; ///< The indices of the coarser levels of detail.
+    std::vector<MeshLOD> lods;             ///< The levels of detail, empty if there aren't any.
+    std::vector<Meshlet> meshlets;         ///< The meshlets of the full mesh, empty if it wasn't split.
+
+    mutable std::vector<int> meshlet_draw_counts;          ///< The index counts of the last meshlet draw.
+    mutable std::vector<const void*> meshlet_draw_offsets; ///< The index offsets of the last meshlet draw.
+    mutable std::vector<int> meshlet_draw_base_vertices;   ///< The base vertices of the last meshlet draw.
+
+    AABB bounds; ///< The local space bounding box of the mesh.
+
+    MeshBuffer* buffer;        ///< The buffer the mesh was allocated from, nullptr if it wasn't.
+    MeshAllocation allocation; ///< The ranges of the buffer allocated to the mesh.
+    unsigned int id;           ///< The order in which the mesh's buffers were bound.
 };
 
 inline unsigned int get_opengl_enum_for_primitive(Primitive primitive) {
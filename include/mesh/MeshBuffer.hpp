@@ -0,0 +1,171 @@
+/***************************************************************************************************
+ * @file  MeshBuffer.hpp
+ * @brief Declaration of the MeshBuffer class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Attribute.hpp"
+
+/**
+ * @struct DrawElementsIndirectCommand
+ * @brief The parameters of an indexed draw read by glMultiDrawElementsIndirect, laid out like OpenGL
+ * expects them.
+ */
+struct DrawElementsIndirectCommand {
+    unsigned int count;          ///< The amount of indices.
+    unsigned int instance_count; ///< The amount of instances.
+    unsigned int first_index;    ///< The position of the first index in the index buffer.
+    int base_vertex;             ///< The value added to each index.
+    unsigned int base_instance;  ///< The index of the first instance, read as gl_BaseInstance.
+};
+
+/**
+ * @struct MeshAllocation
+ * @brief The ranges of the vertex and index buffers of a mesh buffer allocated to a mesh.
+ */
+struct MeshAllocation {
+    unsigned int first_vertex; ///< The position of the mesh's first vertex in the vertex buffer.
+    unsigned int vertex_count; ///< The amount of vertices of the mesh.
+    unsigned int first_index;  ///< The position of the mesh's first index in the index buffer.
+    unsigned int index_count;  ///< The amount of indices of the mesh, levels of detail included.
+};
+
+/**
+ * @class MeshBuffer
+ * @brief A vertex buffer and an index buffer shared by every mesh with the same vertex layout, with the
+ * vertex array describing them. Meshes allocate ranges of both buffers instead of creating their own,
+ * so that drawing any mesh of the layout only needs the same vertex array to be bound and that meshes
+ * of the layout can be drawn together with a single multi draw call. Indices are relative to the
+ * mesh's first vertex, which is given to the draw calls as their base vertex. Free ranges are found
+ * with a first fit search and merged with their neighbors when freed. The buffers grow geometrically
+ * when they're full, their content being copied on the GPU.
+ */
+class MeshBuffer {
+public:
+    /**
+     * @brief Creates an empty buffer for a vertex layout. The OpenGL buffers are only created by the
+     * first allocation.
+     * @param attributes The type of each attribute, AttributeType::NONE for disabled ones.
+     */
+    explicit MeshBuffer(const AttributeType* attributes);
+
+    /**
+     * @brief Frees the vertex array and the buffers.
+     */
+    ~MeshBuffer();
+
+    MeshBuffer(const MeshBuffer&) = delete;
+    MeshBuffer& operator =(const MeshBuffer&) = delete;
+
+    /**
+     * @brief Packs a vertex layout into an integer, the same for every layout with the same attributes.
+     * @param attributes The type of each attribute.
+     * @return The key of the layout.
+     */
+    static unsigned int get_layout_key(const AttributeType* attributes);
+
+    /**
+     * @brief Allocates ranges of the buffers for a mesh, growing them if they don't have enough space.
+     * @param vertex_count The amount of vertices.
+     * @param index_count The amount of indices, 0 if the mesh isn't indexed.
+     * @return The allocated ranges.
+     */
+    MeshAllocation allocate(unsigned int vertex_count, unsigned int index_count);
+
+    /**
+     * @brief Uploads vertices to the vertex buffer.
+     * @param first_vertex The position of the first vertex in the buffer.
+     * @param vertices The vertices, with the layout's attributes.
+     * @param vertex_count The amount of vertices.
+     */
+    void upload_vertices(unsigned int first_vertex, const float* vertices, unsigned int vertex_count) const;
+
+    /**
+     * @brief Uploads indices to the index buffer.
+     * @param first_index The position of the first index in the buffer.
+     * @param indices The indices, relative to the first vertex of their mesh.
+     * @param index_count The amount of indices.
+     */
+    void upload_indices(unsigned int first_index, const unsigned int* indices, unsigned int index_count) const;
+
+    /**
+     * @brief Frees ranges allocated by this buffer, merging them with the neighboring free ranges.
+     * @param allocation The ranges.
+     */
+    void free(const MeshAllocation& allocation);
+
+    /**
+     * @return The id of the vertex array.
+     */
+    unsigned int get_vao() const;
+
+    /**
+     * @return The amount of vertices that fit in the vertex buffer.
+     */
+    unsigned int get_vertex_capacity() const;
+
+    /**
+     * @return The amount of indices that fit in the index buffer.
+     */
+    unsigned int get_index_capacity() const;
+
+private:
+    /**
+     * @struct Range
+     * @brief A free range of one of the buffers.
+     */
+    struct Range {
+        unsigned int offset; ///< The position of the first element.
+        unsigned int count;  ///< The amount of elements.
+    };
+
+    /**
+     * @brief Finds the first free range large enough for some elements and removes them from it,
+     * growing the capacity if there isn't any.
+     * @param free_ranges The free ranges, sorted by offset.
+     * @param capacity The capacity of the buffer, increased if it's too small.
+     * @param min_capacity The capacity the buffer is given when it first grows.
+     * @param count The amount of elements.
+     * @return The position of the first allocated element.
+     */
+    static unsigned int allocate_range(std::vector<Range>& free_ranges, unsigned int& capacity,
+                                       unsigned int min_capacity, unsigned int count);
+
+    /**
+     * @brief Adds a range to the free ranges, merging it with its neighbors.
+     * @param free_ranges The free ranges, sorted by offset.
+     * @param offset The position of the first element of the range.
+     * @param count The amount of elements.
+     */
+    static void free_range(std::vector<Range>& free_ranges, unsigned int offset, unsigned int count);
+
+    /**
+     * @brief Replaces a buffer by a larger one, copying its content.
+     * @param buffer The id of the buffer, replaced.
+     * @param size The size of the content in bytes.
+     * @param new_size The size of the new buffer in bytes.
+     */
+    static void grow_buffer(unsigned int& buffer, std::size_t size, std::size_t new_size);
+
+    /**
+     * @brief Attaches the buffers to the vertex array and describes the layout's attributes.
+     */
+    void attach_buffers() const;
+
+    AttributeType attributes[ATTRIBUTE_AMOUNT]; ///< The type of each attribute of the layout.
+    unsigned int stride;                        ///< The amount of floats of a vertex.
+
+    unsigned int VAO; ///< The vertex array.
+    unsigned int VBO; ///< The vertex buffer.
+    unsigned int EBO; ///< The index buffer.
+
+    unsigned int vertex_capacity; ///< The amount of vertices that fit in the vertex buffer.
+    unsigned int index_capacity;  ///< The amount of indices that fit in the index buffer.
+
+    std::vector<Range> free_vertex_ranges; ///< The free ranges of the vertex buffer, sorted by offset.
+    std::vector<Range> free_index_ranges;  ///< The free ranges of the index buffer, sorted by offset.
+};
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <filesystem>
+#include <limits>
 #include <vector>
 #include "Material.hpp"
 #include "maths/vec3.hpp"
@@ -27,10 +28,22 @@ public:
     explicit Model(const std::filesystem::path& path);
 
     /**
-     * @brief Performs a draw call for each of the model's meshes with a certain shader.
+     * @brief Performs a draw call for each of the model's meshes with a certain shader, choosing the
+     * level of detail of each mesh from its share of the model's screen size.
      * @param shader The shader to perform the draw calls with.
+     * @param screen_size The screen size of the model's bounds, see AABB::get_screen_size. The full
+     * meshes are drawn by default.
      */
-    void draw(const Shader& shader);
+    void draw(const Shader& shader, float screen_size = std::numeric_limits<float>::infinity());
+
+    /**
+     * @brief Chooses the level of detail of one of the model's meshes from its share of the model's
+     * screen size, the share being the ratio of their radii.
+     * @param mesh_index The index of the mesh.
+     * @param screen_size The screen size of the model's bounds, see AABB::get_screen_size.
+     * @return The level of detail of the mesh.
+     */
+    unsigned int select_lod(unsigned int mesh_index, float screen_size) const;
 
     /**
      * @brief Applies a model matrix to each mesh in the model.
@@ -40,6 +53,11 @@ public:
 
     void get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) const;
 
+    /**
+     * @return The local space bounding box of the model, containing the bounds of all its meshes.
+     */
+    const AABB& get_bounds() const;
+
 private:
     /**
      * @brief Parse a .obj file and reads all of its data into the model's buffers.
@@ -53,6 +71,11 @@ private:
      */
     void parse_mtl_file(const std::filesystem::path& path);
 
+    /**
+     * @brief Computes the bounding box of the model from the bounding boxes of its meshes.
+     */
+    void compute_bounds();
+
     /**
      * @brief Add a mesh to the model.
      * @param positions The positions indexed by the first component of each vertex index.
@@ -67,4 +90,5 @@ private:
 
     std::vector<Mesh> meshes;  ///< The meshes composing the model.
     std::vector<Material> materials; ///< The model's materials.
+    AABB bounds;                     ///< The local space bounding box of the model.
 };
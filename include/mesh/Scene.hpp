@@ -7,9 +7,14 @@
 
 #include <filesystem>
 #include "cgltf.h"
+#include "culling/AABB.hpp"
+#include "culling/Frustum.hpp"
+#include "culling/OcclusionCuller.hpp"
+#include "culling/PVS.hpp"
 #include "maths/Transform.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/MRMaterial.hpp"
+#include "RenderQueue.hpp"
 
 struct AttributeInfo {
     Attribute attribute;
@@ -24,6 +29,9 @@ struct MeshInfo {
     ~MeshInfo();
     Mesh mesh;
     MRMaterial* material;
+
+    AABB bounds;                                     ///< The local space bounds of the primitive.
+    mutable unsigned char last_failed_frustum_plane; ///< The frustum plane that last culled the primitive.
 };
 
 /**
@@ -32,22 +40,130 @@ struct MeshInfo {
  */
 class Scene {
 public:
+    /**
+     * @brief Loads a scene from a GLTF file, along with its potentially visible sets if they were baked
+     * in a .pvs file next to it.
+     * @param path The path to the GLTF file.
+     */
     explicit Scene(const std::filesystem::path& path);
     ~Scene();
 
     void draw(const mat4& view_projection_matrix, const Transform& transform) const;
 
+    /**
+     * @brief Adds a draw packet to a render queue for each primitive whose bounds, once transformed, are
+     * at least partially inside of a frustum and large enough on the screen to be seen, with a level of
+     * detail chosen from its screen size. If the PVS is enabled and the camera is inside of its grid,
+     * only the primitives potentially visible from the camera's cell are tested. Primitives passing
+     * these tests are then culled by occlusion if it is enabled. Transparent primitives are added to
+     * the transparent pass.
+     * @param render_queue The render queue.
+     * @param entity The entity drawing the packets, which calls draw_packet with them.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param transform The transform of the scene.
+     * @param frustum The view frustum.
+     * @param occlusion_culler The occlusion culler whose occluders are rasterized, nullptr if occlusion
+     * culling is disabled.
+     * @return The amount of primitives added.
+     */
+    unsigned int enqueue(RenderQueue& render_queue, const Entity* entity, const mat4& view_projection_matrix,
+                         const Transform& transform, const Frustum& frustum,
+                         const OcclusionCuller* occlusion_culler) const;
+
+    /**
+     * @brief Rasterizes the opaque primitives inside of a frustum covering the most of the screen that
+     * are cheap enough to rasterize as occluders.
+     * @param occlusion_culler The occlusion culler, between its begin and build_hierarchy calls.
+     * @param transform The transform of the scene.
+     * @param frustum The view frustum.
+     * @return The amount of primitives rasterized.
+     */
+    unsigned int rasterize_occluders(OcclusionCuller& occlusion_culler, const Transform& transform,
+                                     const Frustum& frustum) const;
+
+    /**
+     * @brief Draws the primitive of a packet added by enqueue. Primitives drawn at full detail that were
+     * split into meshlets only draw their meshlets inside of the frustum and, when face culling is
+     * enabled, facing the camera.
+     * @param packet The packet.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param transform The transform of the scene.
+     * @param frustum The view frustum.
+     * @return The amount of triangles skipped by meshlet culling.
+     */
+    unsigned int draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Transform& transform,
+                             const Frustum& frustum) const;
+
+    /**
+     * @return The amount of primitives in the scene.
+     */
+    unsigned int get_primitive_count() const;
+
+    /**
+     * @return The local space bounds of every primitive of the scene.
+     */
+    const AABB& get_bounds() const;
+
+    /**
+     * @return The amount of primitives that the PVS culled during the last call to enqueue.
+     */
+    unsigned int get_pvs_culled_primitive_count() const;
+
+    /**
+     * @return The amount of primitives that occlusion culled during the last call to enqueue.
+     */
+    unsigned int get_occluded_primitive_count() const;
+
+    /**
+     * @brief Bakes the potentially visible sets of the primitives, then saves them next to the GLTF
+     * file so that they're loaded with the scene from then on. Transparent primitives don't hide the
+     * ones behind them.
+     * @param resolution The amount of cells along the longest axis of the scene's bounds.
+     */
+    void bake_pvs(unsigned int resolution = 32);
+
+    /**
+     * @return The potentially visible sets of the primitives, empty if they weren't baked.
+     */
+    const PVS& get_pvs() const;
+
     static void check_cgltf_result(cgltf_result result, const std::string& error_message);
     static std::string cgltf_primitive_type_to_string(cgltf_primitive_type primitive_type);
     static std::string cgltf_attribute_type_to_string(cgltf_attribute_type attribute_type);
     static std::string cgltf_type_to_string(cgltf_type type);
 
+    bool is_pvs_enabled; ///< Whether the PVS is used when drawing.
+
 private:
     MeshInfo** meshes;
     unsigned int meshes_count;
     unsigned int* primitives_count;
 
     std::vector<vector2<unsigned int>> indices_order;
+    AABB bounds; ///< The local space bounds of every primitive.
+
+    mutable unsigned int pvs_culled_primitive_count;               ///< The primitives culled by the PVS last enqueue.
+    mutable unsigned int occluded_primitive_count;                 ///< The primitives culled by occlusion last enqueue.
+    mutable std::vector<std::pair<float, unsigned int>> occluders; ///< The occluder candidates and their coverage.
+
+    std::filesystem::path pvs_path; ///< The path of the PVS file next to the GLTF file.
+    PVS pvs;                        ///< The potentially visible sets, indexed like indices_order.
+    unsigned int transparent_count; ///< The amount of transparent primitives, last in indices_order.
+
+    /**
+     * @brief Sets the uniforms of a primitive's shader then draws it.
+     * @param view_projection_matrix The projection matrix multiplied by the view matrix.
+     * @param transform The transform of the scene.
+     * @param mesh_info The primitive.
+     * @param lod The level of detail to draw.
+     * @param frustum The view frustum used to cull the meshlets of the full mesh, nullptr to draw the
+     * whole mesh.
+     * @param cull_backfaces Whether meshlets facing away from the camera are culled.
+     * @return The amount of triangles drawn.
+     */
+    static unsigned int draw_primitive(const mat4& view_projection_matrix, const Transform& transform,
+                                       const MeshInfo& mesh_info, unsigned int lod = 0, const Frustum* frustum = nullptr,
+                                       bool cull_backfaces = false);
 
     void load(const std::filesystem::path& path);
     static void read_attribute(AttributeInfo& attribute_info, const cgltf_attribute& c_attribute);
@@ -0,0 +1,27 @@
+/***************************************************************************************************
+ * @file  meshlets.hpp
+ * @brief Declaration of functions aimed at splitting triangle meshes into meshlets
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "Mesh.hpp"
+
+/**
+ * @brief Splits triangles of a mesh into meshlets, small clusters of neighboring triangles that can be
+ * culled as a whole. Meshlets are grown greedily from a seed triangle, always adding the adjacent
+ * triangle that brings the fewest new vertices, until either limit is reached.\n
+ * The indices are reordered so that the triangles of each meshlet are contiguous. Each meshlet has a
+ * bounding sphere and a cone containing the normals of its triangles, which is used to cull meshlets
+ * whose triangles all face away from the camera.
+ * @param mesh The mesh, whose primitive needs to be triangles.
+ * @param indices The indices of the triangles to split. Are reordered.
+ * @param max_vertices The maximum amount of unique vertices of a meshlet.
+ * @param max_triangles The maximum amount of triangles of a meshlet.
+ * @return The meshlets, in the order of the reordered indices.
+ */
+std::vector<Meshlet> build_meshlets(const Mesh& mesh,
+                                    std::vector<unsigned int>& indices,
+                                    unsigned int max_vertices,
+                                    unsigned int max_triangles);
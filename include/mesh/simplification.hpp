@@ -0,0 +1,32 @@
+/***************************************************************************************************
+ * @file  simplification.hpp
+ * @brief Declaration of functions aimed at simplifying triangle meshes
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "Mesh.hpp"
+
+/**
+ * @brief Simplifies triangles of a mesh with quadric error metrics (Garland & Heckbert). Vertices are
+ * collapsed onto one of their neighbors in order of increasing error, so the result only references
+ * existing vertices and can share the mesh's vertex buffer.\n
+ * Vertices sharing a position are collapsed together, each of them onto the neighbor's vertex with
+ * the closest normal and texture coordinates, whose difference is added to the error. Vertices on the
+ * borders of the mesh are never collapsed and collapses that would flip a triangle are rejected.
+ * @param mesh The mesh, whose primitive needs to be triangles.
+ * @param indices The indices of the triangles to simplify, for example those of a previous level of
+ * detail.
+ * @param target_index_count The wanted amount of indices.
+ * @param max_error The maximum error of a collapse, relative to the radius of the mesh's bounds.
+ * @param error Stores the maximum error of the collapses that were done, relative to the radius of
+ * the mesh's bounds.
+ * @return The indices of the simplified triangles, more than the wanted amount if the maximum error
+ * was reached first.
+ */
+std::vector<unsigned int> simplify_mesh(const Mesh& mesh,
+                                        const std::vector<unsigned int>& indices,
+                                        std::size_t target_index_count,
+                                        float max_error,
+                                        float& error);
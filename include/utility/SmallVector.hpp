@@ -0,0 +1,113 @@
+/***************************************************************************************************
+ * @file  SmallVector.hpp
+ * @brief Declaration of the SmallVector class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @class SmallVector
+ * @brief A dynamic array storing its first elements inside of itself, only allocating memory once it
+ * holds more of them. Restricted to trivially copyable types, which are moved with memcpy.
+ * @tparam Type The type of the elements.
+ * @tparam InlineCapacity The amount of elements stored without allocating memory.
+ */
+template <typename Type, std::size_t InlineCapacity>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "SmallVector only holds trivially copyable types.");
+
+public:
+    /**
+     * @brief Creates an empty small vector.
+     */
+    SmallVector() : elements(inline_elements), element_count(0), capacity(InlineCapacity) { }
+
+    /**
+     * @brief Frees the allocated memory, if any.
+     */
+    ~SmallVector() {
+        if(elements != inline_elements) { delete[] elements; }
+    }
+
+    SmallVector(const SmallVector&) = delete;
+    SmallVector& operator =(const SmallVector&) = delete;
+
+    /**
+     * @brief Adds an element at the end, doubling the capacity if it is full.
+     * @param element The element.
+     */
+    void push_back(const Type& element) {
+        if(element_count == capacity) {
+            Type* new_elements = new Type[2 * capacity];
+            std::memcpy(new_elements, elements, element_count * sizeof(Type));
+            if(elements != inline_elements) { delete[] elements; }
+
+            elements = new_elements;
+            capacity *= 2;
+        }
+
+        elements[element_count++] = element;
+    }
+
+    /**
+     * @return The amount of elements.
+     */
+    std::size_t size() const { return element_count; }
+
+    /**
+     * @return Whether there aren't any elements.
+     */
+    bool empty() const { return element_count == 0; }
+
+    /**
+     * @param index The index of an element.
+     * @return A reference to the element.
+     */
+    Type& operator [](std::size_t index) { return elements[index]; }
+
+    /**
+     * @param index The index of an element.
+     * @return A const reference to the element.
+     */
+    const Type& operator [](std::size_t index) const { return elements[index]; }
+
+    /**
+     * @return A reference to the first element.
+     */
+    Type& front() { return elements[0]; }
+
+    /**
+     * @return A reference to the last element.
+     */
+    Type& back() { return elements[element_count - 1]; }
+
+    /**
+     * @return A pointer to the first element.
+     */
+    Type* begin() { return elements; }
+
+    /**
+     * @return A pointer past the last element.
+     */
+    Type* end() { return elements + element_count; }
+
+    /**
+     * @return A const pointer to the first element.
+     */
+    const Type* begin() const { return elements; }
+
+    /**
+     * @return A const pointer past the last element.
+     */
+    const Type* end() const { return elements + element_count; }
+
+private:
+    Type* elements;                       ///< The elements, either the inline ones or allocated ones.
+    std::size_t element_count;            ///< The amount of elements.
+    std::size_t capacity;                 ///< The amount of elements that fit without reallocating.
+    Type inline_elements[InlineCapacity]; ///< The storage of the first elements.
+};
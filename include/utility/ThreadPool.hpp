@@ -0,0 +1,81 @@
+/***************************************************************************************************
+ * @file  ThreadPool.hpp
+ * @brief Declaration of the ThreadPool class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A pool of worker threads that run batches of tasks. The thread submitting a batch takes part
+ * in it as thread 0 and waits for every task to be done before returning.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Signature of a task: receives the task's index and the index of the thread running it.
+     */
+    using Task = std::function<void(unsigned int task_index, unsigned int thread_index)>;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param thread_count The total amount of threads, including the one submitting the tasks. Uses
+     * the amount of hardware threads if 0 is passed.
+     */
+    explicit ThreadPool(unsigned int thread_count = 0);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+
+    /**
+     * @brief Runs a batch of tasks on every thread and waits for all of them to be done. Tasks are
+     * taken in increasing order by the first available thread. A single task is directly run by the
+     * calling thread.
+     * @param task_count The amount of tasks.
+     * @param task The function called for each task.
+     */
+    void run(unsigned int task_count, const Task& task);
+
+    /**
+     * @return The total amount of threads, including the one submitting the tasks.
+     */
+    unsigned int get_thread_count() const;
+
+private:
+    /**
+     * @brief Waits for batches and runs their tasks until the pool is destroyed.
+     * @param thread_index The index of the worker thread.
+     */
+    void worker_loop(unsigned int thread_index);
+
+    /**
+     * @brief Runs the tasks of the current batch until there are none left.
+     * @param thread_index The index of the thread running the tasks.
+     */
+    void run_tasks(unsigned int thread_index);
+
+    std::vector<std::thread> workers; ///< The worker threads.
+
+    std::mutex mutex;                        ///< Protects the state of the current batch.
+    std::condition_variable start_condition; ///< Notified when a batch starts or the pool stops.
+    std::condition_variable done_condition;  ///< Notified when every worker is done with a batch.
+
+    const Task* current_task;            ///< The function of the current batch.
+    unsigned int task_count;             ///< The amount of tasks in the current batch.
+    std::atomic<unsigned int> next_task; ///< The index of the next task to run.
+    unsigned int busy_workers;           ///< The amount of workers still running the batch.
+    unsigned int batch_id;               ///< Incremented for each batch so workers notice new ones.
+    bool is_stopping;                    ///< Whether the workers need to stop.
+};
@@ -0,0 +1,14 @@
+/***************************************************************************************************
+ * @file  flat_instanced.frag
+ * @brief Fragment shader that renders instances with the flat color of each instance
+ **************************************************************************************************/
+
+#version 460 core
+
+in vec4 v_color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = v_color;
+}
@@ -0,0 +1,38 @@
+/***************************************************************************************************
+ * @file  default_instanced.vert
+ * @brief Default vertex shader, drawing instances whose model and normal matrix are read from the
+ * instance buffer
+ **************************************************************************************************/
+
+#version 460 core
+
+layout (location = 0) in vec3 a_position;
+layout (location = 1) in vec3 a_normal;
+layout (location = 2) in vec2 a_tex_coords;
+
+struct Instance {
+    mat4 model;
+    mat3 normal_matrix;
+    vec4 color;
+};
+
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+out vec3 v_position;
+out vec3 v_normal;
+out vec2 v_tex_coords;
+
+uniform mat4 u_view_projection;
+
+void main() {
+    Instance instance = instances[gl_BaseInstance + gl_InstanceID];
+    vec4 pos = instance.model * vec4(a_position, 1.0f);
+
+    gl_Position = u_view_projection * pos;
+
+    v_position = pos.xyz;
+    v_normal = normalize(instance.normal_matrix * a_normal);
+    v_tex_coords = a_tex_coords;
+}
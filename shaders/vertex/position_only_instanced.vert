@@ -0,0 +1,30 @@
+/***************************************************************************************************
+ * @file  position_only_instanced.vert
+ * @brief Vertex shader that only handles positions, drawing instances whose model and color are read
+ * from the instance buffer
+ **************************************************************************************************/
+
+#version 460 core
+
+layout (location = 0) in vec3 a_position;
+
+struct Instance {
+    mat4 model;
+    mat3 normal_matrix;
+    vec4 color;
+};
+
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+out vec4 v_color;
+
+uniform mat4 u_view_projection;
+
+void main() {
+    Instance instance = instances[gl_BaseInstance + gl_InstanceID];
+
+    gl_Position = u_view_projection * instance.model * vec4(a_position, 1.0f);
+    v_color = instance.color;
+}
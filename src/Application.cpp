@@ -11,6 +11,7 @@
 #include "debug.hpp"
 #include "entities/entities.hpp"
 #include "EventHandler.hpp"
+#include "GLState.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -65,6 +66,10 @@ Application::Application()
                                  "shaders/vertex/position_only.vert",
                                  "shaders/fragment/flat.frag"
                              });
+    AssetManager::add_shader("flat instanced", {
+                                 "shaders/vertex/position_only_instanced.vert",
+                                 "shaders/fragment/flat_instanced.frag"
+                             });
     AssetManager::add_shader("lambert", {
                                  "shaders/vertex/position_and_normal.vert",
                                  "shaders/fragment/lambert.frag"
@@ -73,6 +78,10 @@ Application::Application()
                                  "shaders/vertex/default.vert",
                                  "shaders/fragment/blinn_phong.frag"
                              });
+    AssetManager::add_shader("blinn-phong instanced", {
+                                 "shaders/vertex/default_instanced.vert",
+                                 "shaders/fragment/blinn_phong.frag"
+                             });
     AssetManager::add_shader("metallic-roughness", {
                                  "shaders/vertex/default.vert",
                                  "shaders/fragment/metallic_roughness.frag"
@@ -125,7 +134,6 @@ void Application::run() {
                                                                         AssetManager::get_shader("flat"),
                                                                         AssetManager::get_mesh("icosphere 1"));
     light->transform.set_local_position(0.0f, 100.0f, 0.0f);
-    const vec3& light_position = light->transform.get_local_position_reference();
     const vec4& light_color = light->color;
 
     /* Models */ {
@@ -180,8 +188,15 @@ void Application::run() {
     // spheres->transform.set_local_position(vec3(0.0f, 11.0f, -20.0f));
     // light->transform.set_local_position(vec3(0.0f, 0.0f, 5.0f));
 
+    scene_graph.insert_in_culling_structures(root);
+
+#if defined(DEBUG_ENABLE_FRUSTUM_TESTS) && defined(DEBUG_FREEZE_FRUSTUM_TESTS)
+    scene_graph.freeze(test_AABBs_root);
+#endif
+
     /* Main Loop */
     while(!Window::should_close()) {
+        GLState::new_frame();
         EventHandler::poll_and_handle_events();
 
         ImGui_ImplOpenGL3_NewFrame();
@@ -193,15 +208,18 @@ void Application::run() {
 
         vec3 camera_position = camera.get_position();
         vec3 camera_direction = camera.get_direction();
-        frustum.view_projection = camera.get_view_projection_matrix();
+        frustum.update(camera.get_view_projection_matrix());
 
         // test_AABBs_root->transform.set_local_orientation(0.0f, 10.0f * EventHandler::get_time(), 0.0f);
-        root->update_transform_and_children();
+        scene_graph.update_transforms();
+        const vec3 light_position = light->transform.get_global_position();
 
         draw_background();
+        GLState::set_polygon_mode(EventHandler::is_wireframe_enabled() ? GL_LINE : GL_FILL);
 
-        /* Blinn-Phong Shader */ {
-            const Shader& shader = AssetManager::get_shader("blinn-phong");
+        /* Blinn-Phong Shaders */
+        for(const char* name : { "blinn-phong", "blinn-phong instanced" }) {
+            const Shader& shader = AssetManager::get_shader(name);
             shader.use();
 
             shader.set_uniform("u_camera_position", camera_position);
@@ -278,9 +296,8 @@ void Application::draw_post_processing() const {
     shader.set_uniform_if_exists("u_test3", uniform_test_conditions[2]);
     framebuffer.bind_texture(0);
 
-    if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
+    GLState::set_polygon_mode(GL_FILL);
     AssetManager::get_mesh("screen").draw();
-    if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
 }
 
 void Application::draw_background() const {
@@ -292,9 +309,8 @@ void Application::draw_background() const {
     shader.set_uniform("u_camera_right", camera.get_right_vector());
     shader.set_uniform("u_camera_up", camera.get_up_vector());
 
-    if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
+    GLState::set_polygon_mode(GL_FILL);
     AssetManager::get_mesh("screen").draw();
-    if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
 }
 
 void Application::draw_imgui_debug_window() {
@@ -311,9 +327,28 @@ void Application::draw_imgui_debug_window() {
     ImGui::Text("delta: %fs", EventHandler::get_delta());
 
     ImGui::NewLine();
-    ImGui::Text("Total Drawable Entities: %d", DrawableEntity::total_drawable_entities);
-    ImGui::Text("Total Not Hidden Entities: %d", DrawableEntity::total_not_hidden_entities);
-    ImGui::Text("Total Drawn Entities: %d", DrawableEntity::total_drawn_entities);
+    ImGui::Text("Total Drawable Entities: %d", DrawableEntity::statistics.drawable_entities);
+    ImGui::Text("Total Not Hidden Entities: %d", DrawableEntity::statistics.not_hidden_entities);
+    ImGui::Text("Total Drawn Entities: %d", DrawableEntity::statistics.drawn_entities);
+    ImGui::Text("BVH Entities: %d, Height: %d", scene_graph.bvh.get_entity_count(), scene_graph.bvh.get_height());
+    ImGui::Combo("Culling Method", reinterpret_cast<int*>(&scene_graph.culling_method), "BVH\0Batched SIMD\0");
+    ImGui::Text("Culling Time: %fms", scene_graph.get_culling_time());
+    ImGui::Checkbox("Occlusion Culling", &scene_graph.is_occlusion_culling_enabled);
+    ImGui::Text("Occluders: %d, Triangles: %d", scene_graph.get_occluder_count(),
+                scene_graph.occlusion_culler.get_rasterized_triangle_count());
+    ImGui::Text("Occluded Entities: %d", DrawableEntity::statistics.occluded_entities);
+    ImGui::Text("Occlusion Time: %fms", scene_graph.get_occlusion_time());
+    ImGui::Text("Meshlet Culled Triangles: %d", DrawableEntity::statistics.culled_meshlet_triangles);
+    ImGui::Text("PVS Culled Entities: %d", DrawableEntity::statistics.pvs_culled_entities);
+    ImGui::Text("Updated Transforms: %d", scene_graph.transform_system.get_updated_count());
+    ImGui::Text("Draw Packets: %d", scene_graph.get_render_queue().size());
+    ImGui::Text("Draw Calls: %d, Multi Draw Indirect: %d", scene_graph.get_render_queue().get_draw_call_count(),
+                scene_graph.get_render_queue().get_batch_count());
+    ImGui::Text("Batched Packets: %d, Commands: %d", scene_graph.get_render_queue().get_batched_packet_count(),
+                scene_graph.get_render_queue().get_command_count());
+    ImGui::Text("Shader Changes: %d, State Changes: %d", scene_graph.get_render_queue().get_shader_change_count(),
+                scene_graph.get_render_queue().get_state_change_count());
+    ImGui::Text("GL State Calls: %d, Elided: %d", GLState::get_issued_call_count(), GLState::get_elided_call_count());
 
     ImGui::NewLine();
     ImGui::DragFloat("Light Intensity", &light_intensity, 0.25f, 1.0f, 100.0f);
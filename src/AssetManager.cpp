@@ -153,6 +153,18 @@ Shader& AssetManager::get_relevant_shader_from_mesh(const Mesh& mesh) {
     }
 }
 
+Shader* AssetManager::get_instanced_shader_ptr(const Shader& shader) {
+    for(const auto& [name, other_shader] : get().shaders) {
+        if(&other_shader == &shader) { return get_shader_ptr(name + " instanced"); }
+    }
+
+    return nullptr;
+}
+
+MeshBuffer& AssetManager::get_mesh_buffer(const AttributeType* attributes) {
+    return get().mesh_buffers.try_emplace(MeshBuffer::get_layout_key(attributes), attributes).first->second;
+}
+
 AssetManager::AssetManager() { }
 
 AssetManager::~AssetManager() {
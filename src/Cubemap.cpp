@@ -6,11 +6,12 @@
 #include "Cubemap.hpp"
 
 #include "glad/glad.h"
+#include "GLState.hpp"
 #include "Image.hpp"
 
 Cubemap::Cubemap(const std::initializer_list<std::filesystem::path>& paths) {
     glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+    GLState::bind_texture(0, GL_TEXTURE_CUBE_MAP, id);
 
     unsigned int i = 0;
     for(const std::filesystem::path& path : paths) {
@@ -32,12 +33,12 @@ Cubemap::Cubemap(const std::initializer_list<std::filesystem::path>& paths) {
 }
 
 Cubemap::~Cubemap() {
+    GLState::forget_texture(id);
     glDeleteTextures(1, &id);
 }
 
 void Cubemap::bind(unsigned int texUnit) const {
-    glActiveTexture(GL_TEXTURE0 + texUnit);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+    GLState::bind_texture(texUnit, GL_TEXTURE_CUBE_MAP, id);
 }
 
 unsigned int Cubemap::get_id() const {
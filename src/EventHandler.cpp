@@ -8,6 +8,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "callbacks.hpp"
+#include "GLState.hpp"
 
 void EventHandler::poll_and_handle_events() {
     glfwPollEvents();
@@ -129,11 +130,10 @@ EventHandler::EventHandler()
         b_is_cursor_visible = !b_is_cursor_visible;
     });
     associate_action_to_key(GLFW_KEY_F, false, [this] {
-        (b_is_face_culling_enabled ? glDisable : glEnable)(GL_CULL_FACE);
         b_is_face_culling_enabled = !b_is_face_culling_enabled;
+        GLState::set_face_culling(b_is_face_culling_enabled);
     });
     associate_action_to_key(GLFW_KEY_Z, false, [this] {
-        glPolygonMode(GL_FRONT_AND_BACK, b_is_wireframe_enabled ? GL_FILL : GL_LINE);
         b_is_wireframe_enabled = !b_is_wireframe_enabled;
     });
 
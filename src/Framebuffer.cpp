@@ -5,9 +5,11 @@
 
 #include "Framebuffer.hpp"
 
+#include "GLState.hpp"
+
 Framebuffer::Framebuffer(unsigned int width, unsigned int height) : FBO(0), RBO(0), width(width), height(height) {
     glGenFramebuffers(1, &FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::bind_framebuffer(FBO);
 
     texture.create(width, height, nullptr, GL_RGBA32F);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.get_id(), 0);
@@ -21,18 +23,19 @@ Framebuffer::Framebuffer(unsigned int width, unsigned int height) : FBO(0), RBO(
         throw std::runtime_error("Couldn't create framebuffer");
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bind_framebuffer(0);
+    GLState::bind_texture(0, GL_TEXTURE_2D, 0);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
 }
 
 Framebuffer::~Framebuffer() {
     glDeleteRenderbuffers(1, &RBO);
+    GLState::forget_framebuffer(FBO);
     glDeleteFramebuffers(1, &FBO);
 }
 
 void Framebuffer::bind() const {
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::bind_framebuffer(FBO);
 }
 
 unsigned int Framebuffer::get_texture_id() const {
@@ -48,5 +51,5 @@ vec2 Framebuffer::get_resolution() const {
 }
 
 void Framebuffer::bind_default() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::bind_framebuffer(0);
 }
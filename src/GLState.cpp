@@ -0,0 +1,130 @@
+/***************************************************************************************************
+ * @file  GLState.cpp
+ * @brief Implementation of the GLState class
+ **************************************************************************************************/
+
+#include "GLState.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "glad/glad.h"
+
+/**
+ * @brief The value of a tracked id that doesn't match any object, so that the next change is issued.
+ */
+static constexpr unsigned int GL_STATE_UNKNOWN_ID = std::numeric_limits<unsigned int>::max();
+
+GLState::GLState()
+    : program(0), vertex_array(0), framebuffer(0), active_texture_unit(0), textures_2D{ }, cubemap_textures{ },
+      b_is_blending_enabled(false), b_is_depth_test_enabled(false), b_is_face_culling_enabled(false),
+      polygon_mode(GL_FILL), issued_call_count(0), elided_call_count(0), last_frame_issued_call_count(0),
+      last_frame_elided_call_count(0) { }
+
+template <typename Type>
+bool GLState::change(Type& value, Type new_value) {
+    GLState& state = get();
+
+    if(value == new_value) {
+        ++state.elided_call_count;
+        return false;
+    }
+
+    value = new_value;
+    ++state.issued_call_count;
+    return true;
+}
+
+void GLState::use_program(unsigned int program) {
+    if(change(get().program, program)) { glUseProgram(program); }
+}
+
+void GLState::bind_vertex_array(unsigned int vertex_array) {
+    if(change(get().vertex_array, vertex_array)) { glBindVertexArray(vertex_array); }
+}
+
+void GLState::bind_texture(unsigned int unit, unsigned int target, unsigned int texture) {
+    if(unit >= MAX_TEXTURE_UNITS) {
+        throw std::runtime_error("Texture unit " + std::to_string(unit) + " isn't tracked.");
+    }
+
+    GLState& state = get();
+    unsigned int* textures;
+    switch(target) {
+        case GL_TEXTURE_2D:
+            textures = state.textures_2D;
+            break;
+        case GL_TEXTURE_CUBE_MAP:
+            textures = state.cubemap_textures;
+            break;
+        default:
+            throw std::runtime_error("Texture target " + std::to_string(target) + " isn't tracked.");
+    }
+
+    // The unit is made active even if the texture is already bound since it may be edited right after
+    if(change(state.active_texture_unit, unit)) { glActiveTexture(GL_TEXTURE0 + unit); }
+    if(change(textures[unit], texture)) { glBindTexture(target, texture); }
+}
+
+void GLState::bind_framebuffer(unsigned int framebuffer) {
+    if(change(get().framebuffer, framebuffer)) { glBindFramebuffer(GL_FRAMEBUFFER, framebuffer); }
+}
+
+void GLState::set_blending(bool enabled) {
+    if(change(get().b_is_blending_enabled, enabled)) { (enabled ? glEnable : glDisable)(GL_BLEND); }
+}
+
+void GLState::set_depth_test(bool enabled) {
+    if(change(get().b_is_depth_test_enabled, enabled)) { (enabled ? glEnable : glDisable)(GL_DEPTH_TEST); }
+}
+
+void GLState::set_face_culling(bool enabled) {
+    if(change(get().b_is_face_culling_enabled, enabled)) { (enabled ? glEnable : glDisable)(GL_CULL_FACE); }
+}
+
+bool GLState::is_face_culling_enabled() {
+    return get().b_is_face_culling_enabled;
+}
+
+void GLState::set_polygon_mode(unsigned int mode) {
+    if(change(get().polygon_mode, mode)) { glPolygonMode(GL_FRONT_AND_BACK, mode); }
+}
+
+void GLState::forget_program(unsigned int program) {
+    GLState& state = get();
+    if(state.program == program) { state.program = GL_STATE_UNKNOWN_ID; }
+}
+
+void GLState::forget_vertex_array(unsigned int vertex_array) {
+    GLState& state = get();
+    if(state.vertex_array == vertex_array) { state.vertex_array = 0; }
+}
+
+void GLState::forget_texture(unsigned int texture) {
+    GLState& state = get();
+    for(unsigned int unit = 0 ; unit < MAX_TEXTURE_UNITS ; ++unit) {
+        if(state.textures_2D[unit] == texture) { state.textures_2D[unit] = 0; }
+        if(state.cubemap_textures[unit] == texture) { state.cubemap_textures[unit] = 0; }
+    }
+}
+
+void GLState::forget_framebuffer(unsigned int framebuffer) {
+    GLState& state = get();
+    if(state.framebuffer == framebuffer) { state.framebuffer = 0; }
+}
+
+void GLState::new_frame() {
+    GLState& state = get();
+    state.last_frame_issued_call_count = state.issued_call_count;
+    state.last_frame_elided_call_count = state.elided_call_count;
+    state.issued_call_count = 0;
+    state.elided_call_count = 0;
+}
+
+unsigned int GLState::get_issued_call_count() {
+    return get().last_frame_issued_call_count;
+}
+
+unsigned int GLState::get_elided_call_count() {
+    return get().last_frame_elided_call_count;
+}
@@ -0,0 +1,271 @@
+/***************************************************************************************************
+ * @file  RenderQueue.cpp
+ * @brief Implementation of the RenderQueue class
+ **************************************************************************************************/
+
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include "entities/Entity.hpp"
+#include "glad/glad.h"
+
+/**
+ * @brief The amount of bits of the shader field of the sort keys.
+ */
+static constexpr unsigned int RENDER_KEY_SHADER_BITS = 8;
+
+/**
+ * @brief The amount of bits of the texture field of the sort keys.
+ */
+static constexpr unsigned int RENDER_KEY_TEXTURE_BITS = 10;
+
+/**
+ * @brief The amount of bits of the material field of the sort keys.
+ */
+static constexpr unsigned int RENDER_KEY_MATERIAL_BITS = 8;
+
+/**
+ * @brief The amount of bits of the mesh field of the sort keys.
+ */
+static constexpr unsigned int RENDER_KEY_MESH_BITS = 12;
+
+/**
+ * @brief The amount of bits of the depth field of the sort keys.
+ */
+static constexpr unsigned int RENDER_KEY_DEPTH_BITS = 24;
+
+/**
+ * @brief The amount of bits of the state fields, which are contiguous in both layouts.
+ */
+static constexpr unsigned int RENDER_KEY_STATE_BITS = RENDER_KEY_SHADER_BITS + RENDER_KEY_TEXTURE_BITS
+                                                      + RENDER_KEY_MATERIAL_BITS + RENDER_KEY_MESH_BITS;
+
+/**
+ * @brief The index of the first bit of the pass, which uses the 2 highest bits.
+ */
+static constexpr unsigned int RENDER_KEY_PASS_SHIFT = RENDER_KEY_STATE_BITS + RENDER_KEY_DEPTH_BITS;
+
+static_assert(RENDER_KEY_PASS_SHIFT == 62, "The fields of the sort keys need to leave 2 bits for the pass.");
+
+/**
+ * @brief The binding point of the instance buffer, which the instanced shaders read from.
+ */
+static constexpr unsigned int RENDER_QUEUE_INSTANCE_BINDING = 0;
+
+/**
+ * @brief The minimum amount of packets drawn with a multi draw call.
+ */
+static constexpr unsigned int RENDER_QUEUE_MIN_BATCH_SIZE = 2;
+
+static_assert(sizeof(InstanceData) == 128, "InstanceData needs to match the std430 layout of the shaders.");
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect commands need to be tightly packed.");
+
+/**
+ * @param bits The amount of bits.
+ * @return A mask of the lowest bits.
+ */
+static constexpr uint64_t low_bits_mask(unsigned int bits) {
+    return (uint64_t(1) << bits) - 1;
+}
+
+/**
+ * @param key A sort key.
+ * @return The state fields of the key, whatever its pass.
+ */
+static uint64_t get_key_state(uint64_t key) {
+    if(key >> RENDER_KEY_PASS_SHIFT == RENDER_PASS_OPAQUE) { key >>= RENDER_KEY_DEPTH_BITS; }
+    return key & low_bits_mask(RENDER_KEY_STATE_BITS);
+}
+
+RenderQueue::RenderQueue()
+    : instance_buffer(0), instance_buffer_capacity(0), indirect_buffer(0), indirect_buffer_capacity(0),
+      shader_change_count(0), state_change_count(0), draw_call_count(0), batched_packet_count(0) { }
+
+RenderQueue::~RenderQueue() {
+    if(instance_buffer != 0) { glDeleteBuffers(1, &instance_buffer); }
+    if(indirect_buffer != 0) { glDeleteBuffers(1, &indirect_buffer); }
+}
+
+uint64_t RenderQueue::make_key(RenderPass pass, unsigned int shader, unsigned int texture, unsigned int material,
+                               unsigned int mesh, float depth) {
+    uint64_t state = shader & low_bits_mask(RENDER_KEY_SHADER_BITS);
+    state = state << RENDER_KEY_TEXTURE_BITS | (texture & low_bits_mask(RENDER_KEY_TEXTURE_BITS));
+    state = state << RENDER_KEY_MATERIAL_BITS | (material & low_bits_mask(RENDER_KEY_MATERIAL_BITS));
+    state = state << RENDER_KEY_MESH_BITS | (mesh & low_bits_mask(RENDER_KEY_MESH_BITS));
+
+    // The bits of positive floats are in the same order as the floats so the highest ones give a
+    // quantized depth that works whatever the range of the depths
+    uint64_t quantized_depth = std::bit_cast<uint32_t>(depth > 0.0f ? depth : 0.0f) >> (31 - RENDER_KEY_DEPTH_BITS);
+
+    const uint64_t pass_bits = uint64_t(pass) << RENDER_KEY_PASS_SHIFT;
+    if(pass == RENDER_PASS_OPAQUE) { return pass_bits | state << RENDER_KEY_DEPTH_BITS | quantized_depth; }
+
+    quantized_depth = ~quantized_depth & low_bits_mask(RENDER_KEY_DEPTH_BITS);
+    return pass_bits | quantized_depth << RENDER_KEY_STATE_BITS | state;
+}
+
+unsigned int RenderQueue::get_material_id(const void* material) {
+    // The lowest bits of an address are always 0 because of the alignment
+    return static_cast<unsigned int>(reinterpret_cast<std::uintptr_t>(material) / alignof(std::max_align_t));
+}
+
+void RenderQueue::clear() {
+    packets.clear();
+}
+
+void RenderQueue::push(uint64_t key, const Entity* entity, unsigned int index, unsigned int lod,
+                       bool can_be_batched) {
+    packets.emplace_back(key, entity, index, lod, can_be_batched);
+}
+
+void RenderQueue::sort() {
+    // The histograms of every byte are built in a single pass over the keys
+    unsigned int histograms[8][256] = { };
+    for(const DrawPacket& packet : packets) {
+        for(unsigned int byte = 0 ; byte < 8 ; ++byte) { ++histograms[byte][(packet.key >> 8 * byte) & 0xFF]; }
+    }
+
+    sorted_packets.resize(packets.size());
+
+    for(unsigned int byte = 0 ; byte < 8 ; ++byte) {
+        unsigned int* histogram = histograms[byte];
+
+        // Every key has the same byte so the pass wouldn't move anything
+        if(packets.empty() || histogram[(packets.front().key >> 8 * byte) & 0xFF] == packets.size()) { continue; }
+
+        unsigned int offset = 0;
+        for(unsigned int digit = 0 ; digit < 256 ; ++digit) {
+            const unsigned int count = histogram[digit];
+            histogram[digit] = offset;
+            offset += count;
+        }
+
+        for(const DrawPacket& packet : packets) {
+            sorted_packets[histogram[(packet.key >> 8 * byte) & 0xFF]++] = packet;
+        }
+        packets.swap(sorted_packets);
+    }
+}
+
+void RenderQueue::submit(const mat4& view_projection_matrix, const Frustum& frustum) {
+    build_batches();
+    if(!batches.empty()) {
+        upload_buffer(GL_SHADER_STORAGE_BUFFER, instance_buffer, instance_buffer_capacity, instances.data(),
+                      instances.size() * sizeof(InstanceData));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RENDER_QUEUE_INSTANCE_BINDING, instance_buffer);
+
+        upload_buffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer, indirect_buffer_capacity, commands.data(),
+                      commands.size() * sizeof(DrawElementsIndirectCommand));
+    }
+
+    shader_change_count = 0;
+    state_change_count = 0;
+    draw_call_count = 0;
+    batched_packet_count = 0;
+
+    unsigned int batch_index = 0;
+    for(unsigned int i = 0 ; i < packets.size() ;) {
+        const DrawPacket& packet = packets[i];
+
+        if(draw_call_count > 0) {
+            const uint64_t state = get_key_state(packet.key);
+            const uint64_t previous_state = get_key_state(packets[i - 1].key);
+
+            if(state >> (RENDER_KEY_STATE_BITS - RENDER_KEY_SHADER_BITS)
+               != previous_state >> (RENDER_KEY_STATE_BITS - RENDER_KEY_SHADER_BITS)) {
+                ++shader_change_count;
+            }
+            if(state != previous_state) { ++state_change_count; }
+        }
+        ++draw_call_count;
+
+        if(batch_index < batches.size() && batches[batch_index].packet_index == i) {
+            const Batch& batch = batches[batch_index++];
+            packet.entity->draw_batch(&packet, batch.packet_count, batch.first_command, batch.command_count,
+                                      view_projection_matrix);
+            batched_packet_count += batch.packet_count;
+            i += batch.packet_count;
+        } else {
+            packet.entity->draw_packet(packet, view_projection_matrix, frustum);
+            ++i;
+        }
+    }
+}
+
+unsigned int RenderQueue::size() const {
+    return packets.size();
+}
+
+unsigned int RenderQueue::get_shader_change_count() const {
+    return shader_change_count;
+}
+
+unsigned int RenderQueue::get_state_change_count() const {
+    return state_change_count;
+}
+
+unsigned int RenderQueue::get_draw_call_count() const {
+    return draw_call_count;
+}
+
+unsigned int RenderQueue::get_batch_count() const {
+    return batches.size();
+}
+
+unsigned int RenderQueue::get_batched_packet_count() const {
+    return batched_packet_count;
+}
+
+unsigned int RenderQueue::get_command_count() const {
+    return commands.size();
+}
+
+void RenderQueue::build_batches() {
+    batches.clear();
+    instances.clear();
+    commands.clear();
+
+    for(unsigned int i = 0 ; i < packets.size() ;) {
+        const DrawPacket& packet = packets[i];
+        if(!packet.can_be_batched) {
+            ++i;
+            continue;
+        }
+
+        // Packets with the same pass, shader, texture and material are consecutive once sorted whatever
+        // their mesh, but ids sharing the same bits can make different states look the same and meshes
+        // may not share the same buffer so the entity checks them
+        const uint64_t batch_state = get_key_state(packet.key) >> RENDER_KEY_MESH_BITS;
+        unsigned int run_end = i + 1;
+        while(run_end < packets.size() && packets[run_end].can_be_batched
+              && packets[run_end].key >> RENDER_KEY_PASS_SHIFT == packet.key >> RENDER_KEY_PASS_SHIFT
+              && get_key_state(packets[run_end].key) >> RENDER_KEY_MESH_BITS == batch_state) {
+            ++run_end;
+        }
+
+        const unsigned int first_instance = instances.size();
+        const unsigned int first_command = commands.size();
+        const unsigned int packet_count = packet.entity->add_to_batch(&packet, run_end - i, instances, commands);
+
+        if(packet_count >= RENDER_QUEUE_MIN_BATCH_SIZE) {
+            batches.emplace_back(i, packet_count, first_command, commands.size() - first_command);
+            i += packet_count;
+        } else {
+            instances.resize(first_instance);
+            commands.resize(first_command);
+            ++i;
+        }
+    }
+}
+
+void RenderQueue::upload_buffer(unsigned int target, unsigned int& buffer, std::size_t& capacity, const void* data,
+                                std::size_t size) {
+    if(buffer == 0) { glGenBuffers(1, &buffer); }
+    glBindBuffer(target, buffer);
+
+    if(size > capacity) { capacity = std::max(size, 2 * capacity); }
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, size, data);
+}
@@ -5,10 +5,110 @@
 
 #include "SceneGraph.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include "AssetManager.hpp"
 #include "entities/DrawableEntity.hpp"
 #include "imgui.h"
 
-SceneGraph::SceneGraph() : root("Scene Graph"), selected_entity(nullptr) { }
+/**
+ * @brief The amount of culling tasks created for each thread.
+ */
+static constexpr unsigned int CULLING_TASKS_PER_THREAD = 4;
+
+/**
+ * @brief The maximum amount of occluders rasterized each frame.
+ */
+static constexpr unsigned int OCCLUSION_MAX_OCCLUDERS = 32;
+
+/**
+ * @brief Entities with more triangles are too expensive to rasterize as occluders.
+ */
+static constexpr unsigned int OCCLUSION_MAX_OCCLUDER_TRIANGLES = 4096;
+
+/**
+ * @brief The minimum part of the screen covered by the screen rectangle of an occluder.
+ */
+static constexpr float OCCLUSION_MIN_OCCLUDER_COVERAGE = 0.01f;
+
+/**
+ * @brief The cells of the merged meshes of a frozen subtree are split until they have at most this
+ * amount of vertices, or a single entity.
+ */
+static constexpr std::size_t STATIC_BATCH_MAX_CELL_VERTICES = 1 << 16;
+
+/**
+ * @brief Lists the visible mesh entities of a subtree that weren't baked yet.
+ * @param entity The root of the subtree.
+ * @param mesh_entities The list to add the entities to.
+ */
+static void find_mesh_entities(Entity* entity, std::vector<MeshEntity*>& mesh_entities) {
+    if(!entity->get_local_visibility()) { return; }
+
+    MeshEntity* mesh_entity = dynamic_cast<MeshEntity*>(entity);
+    if(mesh_entity != nullptr && !mesh_entity->is_baked && mesh_entity->mesh.get_vertices_amount() > 0) {
+        mesh_entities.push_back(mesh_entity);
+    }
+
+    for(Entity* child : entity->children) { find_mesh_entities(child, mesh_entities); }
+}
+
+/**
+ * @param entity A drawable entity.
+ * @return The center of the entity's world bounds, its global position if it doesn't have any.
+ */
+static vec3 get_world_center(const DrawableEntity* entity) {
+    return entity->aabb == nullptr ? entity->transform.get_global_position() : entity->world_bounds.center;
+}
+
+/**
+ * @brief Recursively splits a range of entities in two halves along the longest axis of their centers
+ * until each range is a cell whose meshes are small enough to be merged.
+ * @param begin The first entity of the range.
+ * @param end The end of the range.
+ * @param cells Stores the ranges of the cells.
+ */
+static void split_into_cells(std::vector<MeshEntity*>::iterator begin, std::vector<MeshEntity*>::iterator end,
+                             std::vector<std::pair<std::vector<MeshEntity*>::iterator,
+                                                   std::vector<MeshEntity*>::iterator>>& cells) {
+    std::size_t vertex_count = 0;
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+
+    for(auto entity = begin ; entity != end ; ++entity) {
+        vertex_count += (*entity)->mesh.get_vertices_amount();
+
+        const vec3 center = get_world_center(*entity);
+        for(int axis = 0 ; axis < 3 ; ++axis) {
+            min[axis] = std::min(min[axis], center[axis]);
+            max[axis] = std::max(max[axis], center[axis]);
+        }
+    }
+
+    if(vertex_count <= STATIC_BATCH_MAX_CELL_VERTICES || end - begin == 1) {
+        cells.emplace_back(begin, end);
+        return;
+    }
+
+    const vec3 extent = max - min;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    const auto middle = begin + (end - begin) / 2;
+    std::nth_element(begin, middle, end, [axis](const MeshEntity* a, const MeshEntity* b) {
+        return get_world_center(a)[axis] < get_world_center(b)[axis];
+    });
+
+    split_into_cells(begin, middle, cells);
+    split_into_cells(middle, end, cells);
+}
+
+SceneGraph::SceneGraph()
+    : root("Scene Graph"), culling_method(CULLING_METHOD_BVH), is_occlusion_culling_enabled(false),
+      selected_entity(nullptr), culling_time(0.0f), occluder_count(0), occlusion_time(0.0f), merged_mesh_count(0) {
+    root.arena = &entity_arena;
+    root.transform.attach(transform_system, &root);
+}
 
 void SceneGraph::add_imgui_node_tree() {
     ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow;
@@ -31,12 +131,222 @@ void SceneGraph::add_selected_entity_editor_to_imgui_window() const {
     }
 }
 
-void SceneGraph::draw(const mat4& view_projection_matrix, const Frustum& frustum) const {
-    DrawableEntity::total_drawable_entities = 0;
-    DrawableEntity::total_not_hidden_entities = 0;
-    DrawableEntity::total_drawn_entities = 0;
+void SceneGraph::insert_in_culling_structures(Entity* entity) {
+    DrawableEntity* drawable = dynamic_cast<DrawableEntity*>(entity);
+    if(drawable != nullptr && !drawable->is_in_bvh()) {
+        drawable->insert_in_bvh(bvh);
+        drawable->insert_in_aabb_arrays(aabb_arrays);
+    }
+
+    const SceneEntity* scene_entity = dynamic_cast<const SceneEntity*>(entity);
+    if(scene_entity != nullptr && std::ranges::find(scene_entities, scene_entity) == scene_entities.end()) {
+        scene_entities.push_back(scene_entity);
+    }
+
+    for(Entity* child : entity->children) { insert_in_culling_structures(child); }
+}
+
+void SceneGraph::update_transforms() {
+    transform_system.update(thread_pool);
+}
+
+Entity* SceneGraph::freeze(Entity* subtree) {
+    // The global models are baked so they need to be up to date
+    update_transforms();
+
+    std::vector<MeshEntity*> mesh_entities;
+    find_mesh_entities(subtree, mesh_entities);
+
+    // There are only a few groups so a linear search is enough
+    std::vector<std::vector<MeshEntity*>> groups;
+    for(MeshEntity* entity : mesh_entities) {
+        auto group = std::find_if(groups.begin(), groups.end(), [entity](const std::vector<MeshEntity*>& group) {
+            return group.front()->can_be_merged_with(*entity);
+        });
+
+        if(group == groups.end()) {
+            groups.emplace_back(1, entity);
+        } else {
+            group->push_back(entity);
+        }
+    }
+
+    Entity* merged_entities = root.add_child<Entity>(subtree->name + " (frozen)");
+    std::vector<std::pair<std::vector<MeshEntity*>::iterator, std::vector<MeshEntity*>::iterator>> cells;
+
+    for(std::vector<MeshEntity*>& group : groups) {
+        cells.clear();
+        split_into_cells(group.begin(), group.end(), cells);
+
+        for(const auto& [begin, end] : cells) {
+            const std::string name = "merged mesh " + std::to_string(merged_mesh_count++);
+            Mesh& merged_mesh = AssetManager::add_mesh(name);
+
+            for(auto entity = begin ; entity != end ; ++entity) {
+                const Transform& transform = (*entity)->transform;
+                merged_mesh.append_transformed((*entity)->mesh, transform.get_global_affine_model().get_matrix(),
+                                               transform.get_normal_matrix());
+            }
+
+            merged_mesh.bind_buffers();
+            (*begin)->add_merged_child(*merged_entities, name, merged_mesh);
+        }
+    }
+
+    for(MeshEntity* entity : mesh_entities) { entity->bake(); }
+
+    // The merged meshes are in world space and the root doesn't move, so their entities' global models
+    // are the identity once computed
+    update_transforms();
+    for(Entity* child : merged_entities->children) { static_cast<MeshEntity*>(child)->create_aabb(); }
+    insert_in_culling_structures(merged_entities);
+
+    return merged_entities;
+}
+
+void SceneGraph::draw(const mat4& view_projection_matrix, const Frustum& frustum) {
+    DrawableEntity::statistics = DrawStatistics();
+
+    const auto culling_start = std::chrono::steady_clock::now();
+    cull(frustum);
+    culling_time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - culling_start).count();
+
+    occluder_count = 0;
+    occlusion_time = 0.0f;
+
+    if(is_occlusion_culling_enabled) {
+        const auto occlusion_start = std::chrono::steady_clock::now();
+        cull_occluded(view_projection_matrix, frustum);
+        occlusion_time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - occlusion_start).count();
+    }
+
+    render_queue.clear();
+    for(const DrawableEntity* entity : visible_entities) {
+        entity->enqueue_visible(render_queue, view_projection_matrix, frustum);
+    }
+    root.enqueue(render_queue, view_projection_matrix, frustum, is_occlusion_culling_enabled ? &occlusion_culler : nullptr);
+
+    render_queue.sort();
+    render_queue.submit(view_projection_matrix, frustum);
+}
+
+void SceneGraph::cull(const Frustum& frustum) {
+    const unsigned int thread_count = thread_pool.get_thread_count();
+
+    // Several tasks per thread so that the threads that finish early can take some of the work
+    unsigned int task_count;
+    unsigned int range_size = 0;
+
+    if(culling_method == CULLING_METHOD_BVH) {
+        bvh.split(CULLING_TASKS_PER_THREAD * thread_count, subtrees);
+        task_count = subtrees.size();
+    } else {
+        // Ranges are multiples of 8 boxes so that every thread can use full SIMD iterations
+        const unsigned int wanted_task_count = CULLING_TASKS_PER_THREAD * thread_count;
+        range_size = (aabb_arrays.size() + wanted_task_count - 1) / wanted_task_count;
+        range_size = std::max(8u, (range_size + 7) & ~7u);
+        task_count = (aabb_arrays.size() + range_size - 1) / range_size;
+    }
+
+    task_visible_entities.resize(std::max<std::size_t>(task_visible_entities.size(), task_count));
+    thread_statistics.assign(thread_count, DrawStatistics());
+
+    thread_pool.run(task_count, [&](unsigned int task_index, unsigned int thread_index) {
+        std::vector<DrawableEntity*>& entities = task_visible_entities[task_index];
+        entities.clear();
+
+        if(culling_method == CULLING_METHOD_BVH) {
+            bvh.query(frustum, subtrees[task_index], entities);
+        } else {
+            thread_local std::vector<unsigned int> visible_indices;
+            visible_indices.clear();
+
+            const unsigned int begin = task_index * range_size;
+            aabb_arrays.cull(frustum, begin, std::min(begin + range_size, aabb_arrays.size()), visible_indices);
+
+            for(unsigned int index : visible_indices) { entities.push_back(aabb_arrays.get_entity(index)); }
+        }
+
+        // Entities too small to be seen aren't drawn, hidden and baked ones aren't in the culling structures
+        std::erase_if(entities, [&](const DrawableEntity* entity) {
+            return entity->world_bounds.get_screen_size(frustum.view_projection) < SMALL_FEATURE_SCREEN_SIZE;
+        });
+        thread_statistics[thread_index].drawn_entities += entities.size();
+    });
+
+    // Merges the visible entities in the order of the tasks so that the draw order is deterministic
+    visible_entities.clear();
+    for(unsigned int i = 0 ; i < task_count ; ++i) {
+        visible_entities.insert(visible_entities.end(), task_visible_entities[i].begin(), task_visible_entities[i].end());
+    }
+
+    for(const DrawStatistics& statistics : thread_statistics) { DrawableEntity::statistics += statistics; }
+}
+
+void SceneGraph::cull_occluded(const mat4& view_projection_matrix, const Frustum& frustum) {
+    occlusion_culler.begin(view_projection_matrix);
+
+    // Chooses the entities covering the most of the screen that are cheap enough to rasterize
+    occluders.clear();
+    for(DrawableEntity* entity : visible_entities) {
+        const unsigned int triangle_count = entity->get_occluder_triangle_count();
+        if(triangle_count == 0 || triangle_count > OCCLUSION_MAX_OCCLUDER_TRIANGLES) { continue; }
+
+        const float coverage = occlusion_culler.get_screen_coverage(entity->world_bounds);
+        if(coverage >= OCCLUSION_MIN_OCCLUDER_COVERAGE) { occluders.emplace_back(coverage, entity); }
+    }
+
+    occluder_count = std::min<std::size_t>(occluders.size(), OCCLUSION_MAX_OCCLUDERS);
+    std::partial_sort(occluders.begin(), occluders.begin() + occluder_count, occluders.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for(unsigned int i = 0 ; i < occluder_count ; ++i) { occluders[i].second->rasterize_occluder(occlusion_culler); }
+
+    // The primitives of the scenes are drawn while walking the graph, they're tested when they're enqueued
+    for(const SceneEntity* scene_entity : scene_entities) {
+        occluder_count += scene_entity->rasterize_occluders(occlusion_culler, frustum);
+    }
+    occlusion_culler.build_hierarchy();
+
+    // Tests the visible entities in ranges, each range being tested by a task
+    const unsigned int entity_count = visible_entities.size();
+    const unsigned int wanted_task_count = CULLING_TASKS_PER_THREAD * thread_pool.get_thread_count();
+    const unsigned int range_size = std::max(1u, (entity_count + wanted_task_count - 1) / wanted_task_count);
+    const unsigned int task_count = (entity_count + range_size - 1) / range_size;
+
+    occlusion_results.resize(entity_count);
+
+    thread_pool.run(task_count, [&](unsigned int task_index, unsigned int) {
+        const unsigned int end = std::min(entity_count, (task_index + 1) * range_size);
+        for(unsigned int i = task_index * range_size ; i < end ; ++i) {
+            occlusion_results[i] = occlusion_culler.is_visible(visible_entities[i]->world_bounds);
+        }
+    });
+
+    unsigned int kept_count = 0;
+    for(unsigned int i = 0 ; i < entity_count ; ++i) {
+        if(occlusion_results[i]) { visible_entities[kept_count++] = visible_entities[i]; }
+    }
+    visible_entities.resize(kept_count);
+
+    DrawableEntity::statistics.occluded_entities = entity_count - kept_count;
+    DrawableEntity::statistics.drawn_entities -= entity_count - kept_count;
+}
+
+float SceneGraph::get_culling_time() const {
+    return culling_time;
+}
+
+float SceneGraph::get_occlusion_time() const {
+    return occlusion_time;
+}
+
+unsigned int SceneGraph::get_occluder_count() const {
+    return occluder_count;
+}
 
-    root.draw(view_projection_matrix, frustum);
+const RenderQueue& SceneGraph::get_render_queue() const {
+    return render_queue;
 }
 
 void SceneGraph::add_entity_to_imgui_node_tree(Entity* entity) {
@@ -8,6 +8,7 @@
 #include <fstream>
 #include <glad/glad.h>
 #include <sstream>
+#include "GLState.hpp"
 
 #ifdef DEBUG
 #include "debug.hpp"
@@ -33,6 +34,7 @@ Shader& Shader::operator=(const Shader& shader) {
 
 void Shader::free() {
     if(id == 0) { return; }
+    GLState::forget_program(id);
     glDeleteProgram(id);
 #ifdef DEBUG_LOG_SHADER_LIFETIME
     std::cout << "Freed shader program '" << name << "'.\n";
@@ -89,7 +91,7 @@ void Shader::create(const std::initializer_list<std::filesystem::path>& paths_li
     std::cout << "Created shader program '" << name << "'.\n";
 #endif
 
-    glUseProgram(0);
+    GLState::use_program(0);
 }
 
 unsigned int Shader::compile_shader(const std::filesystem::path& path) {
@@ -154,7 +156,7 @@ unsigned int Shader::compile_shader(const std::filesystem::path& path) {
 }
 
 void Shader::use() const {
-    glUseProgram(id);
+    GLState::use_program(id);
 }
 
 bool Shader::does_uniform_exist(const std::string& uniform) const {
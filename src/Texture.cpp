@@ -6,6 +6,7 @@
 #include "Texture.hpp"
 
 #include <glad/glad.h>
+#include "GLState.hpp"
 
 #include "AssetManager.hpp"
 
@@ -181,6 +182,7 @@ void Texture::init() {
 
 void Texture::free() {
     if(id == 0) { return; }
+    GLState::forget_texture(id);
     glDeleteTextures(1, &id);
 #ifdef DEBUG_LOG_TEXTURE_LIFETIME
     std::cout << "Freed texture " << id << ".\n";
@@ -342,8 +344,7 @@ void Texture::create(const std::filesystem::path& parent_path, const cgltf_textu
 }
 
 void Texture::bind(unsigned int texUnit) const {
-    glActiveTexture(GL_TEXTURE0 + texUnit);
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLState::bind_texture(texUnit, GL_TEXTURE_2D, id);
 }
 
 bool Texture::is_default_texture() const {
@@ -7,6 +7,7 @@
 
 #include <glad/glad.h>
 #include <unordered_set>
+#include "GLState.hpp"
 
 static void glfw_error_callback(int code, const char* message) {
     std::cerr << "GLFW Error '" << code << "' : " << message << '\n';
@@ -136,15 +137,15 @@ Window::Window()
     /* ---- OpenGL ---- */
     glViewport(0, 0, width, height);
 
-    glEnable(GL_CULL_FACE);
+    GLState::set_face_culling(true);
     glEnable(GL_PROGRAM_POINT_SIZE);
 
-    glEnable(GL_DEPTH_TEST);
+    GLState::set_depth_test(true);
     glDepthFunc(GL_LEQUAL);
     glClearColor(0.1, 0.1f, 0.1f, 1.0f);
     glClearDepth(1.0f);
 
-    glEnable(GL_BLEND);
+    GLState::set_blending(true);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glEnable(GL_DEBUG_OUTPUT);
@@ -154,8 +155,7 @@ Window::Window()
 
     // Sets the default texture to a plain magenta color
     constexpr unsigned char magenta[3]{ 255, 0, 255 };
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bind_texture(0, GL_TEXTURE_2D, 0);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, magenta);
 }
 
@@ -5,63 +5,71 @@
 
 #include "culling/AABB.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "maths/geometry.hpp"
 
 AABB::AABB()
-    : points(
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f),
-        vec4(0.0f, 0.0f, 0.0f, 1.0f)
-    ) { }
+    : center(0.0f), extent(0.0f) { }
 
 AABB::AABB(const vec3& min_point, const vec3& max_point)
-    : points(
-        vec4(min_point, 1.0f),
-        vec4(min_point.x, min_point.y, max_point.z, 1.0f),
-        vec4(min_point.x, max_point.y, min_point.z, 1.0f),
-        vec4(min_point.x, max_point.y, max_point.z, 1.0f),
-        vec4(max_point.x, min_point.y, min_point.z, 1.0f),
-        vec4(max_point.x, min_point.y, max_point.z, 1.0f),
-        vec4(max_point.x, max_point.y, min_point.z, 1.0f),
-        vec4(max_point, 1.0f)
-    ) { }
-
-bool AABB::is_in_frustum(const mat4& mvp_matrix) const {
-    unsigned int planes[6]{ 0, 0, 0, 0, 0, 0 };
-
-    for(const vec4& point : points) {
-        vec4 p = mvp_matrix * point;
-        if(p.x < -p.w) { ++planes[0]; }
-        if(p.x > p.w) { ++planes[1]; }
-        if(p.y < -p.w) { ++planes[2]; }
-        if(p.y > p.w) { ++planes[3]; }
-        if(p.z < -p.w) { ++planes[4]; }
-        if(p.z > p.w) { ++planes[5]; }
-    }
-
-    for(unsigned int points_on_or_above_plane : planes) {
-        if(points_on_or_above_plane == 8) { return false; }
-    }
-
-    return true;
+    : center(0.5f * (min_point.x + max_point.x), 0.5f * (min_point.y + max_point.y), 0.5f * (min_point.z + max_point.z)),
+      extent(0.5f * (max_point.x - min_point.x), 0.5f * (max_point.y - min_point.y), 0.5f * (max_point.z - min_point.z)) { }
+
+vec3 AABB::get_min_point() const {
+    return vec3(center.x - extent.x, center.y - extent.y, center.z - extent.z);
+}
+
+vec3 AABB::get_max_point() const {
+    return vec3(center.x + extent.x, center.y + extent.y, center.z + extent.z);
+}
+
+AABB AABB::transformed(const affine3x4& model) const {
+    AABB result;
+    result.center = model * center;
+
+    // Projects the extent of the box on each axis using the absolute values of the linear part
+    result.extent = vec3(
+        std::abs(model(0, 0)) * extent.x + std::abs(model(0, 1)) * extent.y + std::abs(model(0, 2)) * extent.z,
+        std::abs(model(1, 0)) * extent.x + std::abs(model(1, 1)) * extent.y + std::abs(model(1, 2)) * extent.z,
+        std::abs(model(2, 0)) * extent.x + std::abs(model(2, 1)) * extent.y + std::abs(model(2, 2)) * extent.z
+    );
+
+    return result;
 }
 
-mat4 AABB::get_global_model_matrix(const Transform& transform) const {
-    mat4 global_model = transform.get_global_model();
-    vec4 min = global_model * points[0];
-    vec4 max = global_model * points[7];
+AABB AABB::merged(const AABB& other) const {
+    const vec3 min = get_min_point();
+    const vec3 max = get_max_point();
+    const vec3 other_min = other.get_min_point();
+    const vec3 other_max = other.get_max_point();
 
-    vec3 center(0.5f * (min.x + max.x), 0.5f * (min.y + max.y), 0.5f * (min.z + max.z));
+    return AABB(vec3(std::min(min.x, other_min.x), std::min(min.y, other_min.y), std::min(min.z, other_min.z)),
+                vec3(std::max(max.x, other_max.x), std::max(max.y, other_max.y), std::max(max.z, other_max.z)));
+}
+
+bool AABB::is_in_frustum(const Frustum& frustum, unsigned char& last_failed_plane) const {
+    return frustum.is_aabb_visible(center, extent, last_failed_plane);
+}
+
+float AABB::get_screen_size(const mat4& view_projection_matrix) const {
+    const mat4& vp = view_projection_matrix;
+    const float radius = length(extent);
+
+    // The last row gives the depth of the center and, the view matrix being a rotation, the length of
+    // the second row's first 3 values is the projection's vertical scale
+    const float depth = vp(3, 0) * center.x + vp(3, 1) * center.y + vp(3, 2) * center.z + vp(3, 3);
+    if(depth <= radius) { return std::numeric_limits<float>::infinity(); }
+
+    return radius * length(vec3(vp(1, 0), vp(1, 1), vp(1, 2))) / depth;
+}
 
+mat4 AABB::get_model_matrix() const {
     return mat4(
-        max.x - center.x, 0.0f, 0.0f, center.x,
-        0.0f, max.y - center.y, 0.0f, center.y,
-        0.0f, 0.0f, max.z - center.z, center.z,
+        extent.x, 0.0f, 0.0f, center.x,
+        0.0f, extent.y, 0.0f, center.y,
+        0.0f, 0.0f, extent.z, center.z,
         0.0f, 0.0f, 0.0f, 1.0f
     );
 }
@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * @file  AABBArrays.cpp
+ * @brief Implementation of the AABBArrays class
+ **************************************************************************************************/
+
+#include "culling/AABBArrays.hpp"
+
+#include <bit>
+#include <cmath>
+#include "entities/DrawableEntity.hpp"
+#include "maths/simd.hpp"
+
+/**
+ * @brief Adds the indices of the set bits of a mask, offset by a first index.
+ */
+static inline void push_indices_from_mask(unsigned int mask, unsigned int first, std::vector<unsigned int>& indices) {
+    while(mask != 0) {
+        indices.push_back(first + std::countr_zero(mask));
+        mask &= mask - 1;
+    }
+}
+
+unsigned int AABBArrays::add(DrawableEntity* entity, const AABB& bounds) {
+    center_x.push_back(bounds.center.x);
+    center_y.push_back(bounds.center.y);
+    center_z.push_back(bounds.center.z);
+    extent_x.push_back(bounds.extent.x);
+    extent_y.push_back(bounds.extent.y);
+    extent_z.push_back(bounds.extent.z);
+    entities.push_back(entity);
+
+    return entities.size() - 1;
+}
+
+void AABBArrays::remove(unsigned int index) {
+    const unsigned int last = entities.size() - 1;
+
+    if(index != last) {
+        center_x[index] = center_x[last];
+        center_y[index] = center_y[last];
+        center_z[index] = center_z[last];
+        extent_x[index] = extent_x[last];
+        extent_y[index] = extent_y[last];
+        extent_z[index] = extent_z[last];
+        entities[index] = entities[last];
+        entities[index]->aabb_arrays_index = index;
+    }
+
+    center_x.pop_back();
+    center_y.pop_back();
+    center_z.pop_back();
+    extent_x.pop_back();
+    extent_y.pop_back();
+    extent_z.pop_back();
+    entities.pop_back();
+}
+
+void AABBArrays::set(unsigned int index, const AABB& bounds) {
+    center_x[index] = bounds.center.x;
+    center_y[index] = bounds.center.y;
+    center_z[index] = bounds.center.z;
+    extent_x[index] = bounds.extent.x;
+    extent_y[index] = bounds.extent.y;
+    extent_z[index] = bounds.extent.z;
+}
+
+void AABBArrays::cull(const Frustum& frustum, std::vector<unsigned int>& visible_indices) const {
+    cull(frustum, 0, entities.size(), visible_indices);
+}
+
+void AABBArrays::cull(const Frustum& frustum, unsigned int begin, unsigned int end,
+                      std::vector<unsigned int>& visible_indices) const {
+    unsigned int i = begin;
+
+    // Each box is outside if, for any plane, dot(normal, center) + d < -dot(abs(normal), extent)
+
+#ifdef MATHS_USE_AVX
+    for(; i + 8 <= end ; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&center_x[i]);
+        const __m256 y = _mm256_loadu_ps(&center_y[i]);
+        const __m256 z = _mm256_loadu_ps(&center_z[i]);
+        const __m256 ex = _mm256_loadu_ps(&extent_x[i]);
+        const __m256 ey = _mm256_loadu_ps(&extent_y[i]);
+        const __m256 ez = _mm256_loadu_ps(&extent_z[i]);
+
+        __m256 outside = _mm256_setzero_ps();
+
+        for(const vec4& plane : frustum.planes) {
+            __m256 distance = _mm256_mul_ps(_mm256_set1_ps(plane.x), x);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.y), y));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+
+            __m256 radius = _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), ex);
+            radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), ey));
+            radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), ez));
+
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_sub_ps(_mm256_setzero_ps(), radius), _CMP_LT_OQ));
+        }
+
+        push_indices_from_mask(~_mm256_movemask_ps(outside) & 0xFF, i, visible_indices);
+    }
+#endif
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= end ; i += 4) {
+        const __m128 x = _mm_loadu_ps(&center_x[i]);
+        const __m128 y = _mm_loadu_ps(&center_y[i]);
+        const __m128 z = _mm_loadu_ps(&center_z[i]);
+        const __m128 ex = _mm_loadu_ps(&extent_x[i]);
+        const __m128 ey = _mm_loadu_ps(&extent_y[i]);
+        const __m128 ez = _mm_loadu_ps(&extent_z[i]);
+
+        __m128 outside = _mm_setzero_ps();
+
+        for(const vec4& plane : frustum.planes) {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(plane.x), x);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.y), y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+            __m128 radius = _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex);
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_sub_ps(_mm_setzero_ps(), radius)));
+        }
+
+        push_indices_from_mask(~_mm_movemask_ps(outside) & 0xF, i, visible_indices);
+    }
+#endif
+
+    for(; i < end ; ++i) {
+        bool is_outside = false;
+
+        for(const vec4& plane : frustum.planes) {
+            const float distance = plane.x * center_x[i] + plane.y * center_y[i] + plane.z * center_z[i] + plane.w;
+            const float radius = std::abs(plane.x) * extent_x[i] + std::abs(plane.y) * extent_y[i]
+                                 + std::abs(plane.z) * extent_z[i];
+
+            if(distance < -radius) {
+                is_outside = true;
+                break;
+            }
+        }
+
+        if(!is_outside) { visible_indices.push_back(i); }
+    }
+}
+
+DrawableEntity* AABBArrays::get_entity(unsigned int index) const {
+    return entities[index];
+}
+
+unsigned int AABBArrays::size() const {
+    return entities.size();
+}
@@ -0,0 +1,343 @@
+/***************************************************************************************************
+ * @file  BVH.cpp
+ * @brief Implementation of the BVH class
+ **************************************************************************************************/
+
+#include "culling/BVH.hpp"
+
+#include <algorithm>
+#include "entities/DrawableEntity.hpp"
+
+/**
+ * @brief Ratio of the extent of an entity's bounds added around the box of its leaf.
+ */
+static constexpr float BVH_MARGIN_RATIO = 0.1f;
+
+/**
+ * @brief Calculates the surface area of a box, the cost used to choose where leaves are inserted.
+ */
+static inline float surface_area(const vec3& min, const vec3& max) {
+    const float x = max.x - min.x;
+    const float y = max.y - min.y;
+    const float z = max.z - min.z;
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+/**
+ * @brief Calculates the minimum of two points component by component.
+ */
+static inline vec3 component_min(const vec3& a, const vec3& b) {
+    return vec3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+}
+
+/**
+ * @brief Calculates the maximum of two points component by component.
+ */
+static inline vec3 component_max(const vec3& a, const vec3& b) {
+    return vec3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+}
+
+/**
+ * @brief Calculates the surface area of the union of two nodes' boxes.
+ */
+static inline float union_surface_area(const BVHNode& a, const BVHNode& b) {
+    return surface_area(component_min(a.min, b.min), component_max(a.max, b.max));
+}
+
+BVH::BVH() : root(BVH_NULL_NODE), free_list(BVH_NULL_NODE), entity_count(0) { }
+
+int BVH::insert(DrawableEntity* entity, const AABB& bounds) {
+    const int leaf = allocate_node();
+    const vec3 margin = BVH_MARGIN_RATIO * bounds.extent;
+
+    BVHNode& node = nodes[leaf];
+    node.min = bounds.get_min_point() - margin;
+    node.max = bounds.get_max_point() + margin;
+    node.height = 0;
+    node.entity = entity;
+
+    insert_leaf(leaf);
+    ++entity_count;
+
+    return leaf;
+}
+
+void BVH::remove(int leaf) {
+    remove_leaf(leaf);
+    free_node(leaf);
+    --entity_count;
+}
+
+void BVH::update(int leaf, const AABB& bounds) {
+    BVHNode& node = nodes[leaf];
+    const vec3 min = bounds.get_min_point();
+    const vec3 max = bounds.get_max_point();
+
+    if(node.min.x <= min.x && node.min.y <= min.y && node.min.z <= min.z
+       && max.x <= node.max.x && max.y <= node.max.y && max.z <= node.max.z) {
+        return;
+    }
+
+    remove_leaf(leaf);
+
+    const vec3 margin = BVH_MARGIN_RATIO * bounds.extent;
+    nodes[leaf].min = min - margin;
+    nodes[leaf].max = max + margin;
+
+    insert_leaf(leaf);
+}
+
+void BVH::query(const Frustum& frustum, std::vector<DrawableEntity*>& visible_entities) {
+    if(root != BVH_NULL_NODE) { query(frustum, root, visible_entities); }
+}
+
+void BVH::query(const Frustum& frustum, int subtree, std::vector<DrawableEntity*>& visible_entities) {
+    // Nodes to visit and their plane masks, one stack per thread
+    thread_local std::vector<std::pair<int, unsigned char>> query_stack;
+
+    query_stack.clear();
+    query_stack.emplace_back(subtree, FRUSTUM_ALL_PLANES_MASK);
+
+    while(!query_stack.empty()) {
+        auto [index, plane_mask] = query_stack.back();
+        query_stack.pop_back();
+
+        BVHNode& node = nodes[index];
+
+        if(plane_mask != 0) {
+            // Leaves are tested with the exact bounds of their entity instead of their enlarged box
+            if(node.is_leaf()) {
+                const AABB& bounds = node.entity->world_bounds;
+                if(!frustum.is_aabb_visible(bounds.center, bounds.extent, node.last_failed_plane, plane_mask)) {
+                    continue;
+                }
+            } else {
+                const vec3 center = 0.5f * (node.min + node.max);
+                const vec3 extent = 0.5f * (node.max - node.min);
+                if(!frustum.is_aabb_visible(center, extent, node.last_failed_plane, plane_mask)) { continue; }
+            }
+        }
+
+        if(node.is_leaf()) {
+            visible_entities.push_back(node.entity);
+        } else {
+            query_stack.emplace_back(node.right, plane_mask);
+            query_stack.emplace_back(node.left, plane_mask);
+        }
+    }
+}
+
+void BVH::split(unsigned int subtree_count, std::vector<int>& subtrees) const {
+    subtrees.clear();
+    if(root == BVH_NULL_NODE) { return; }
+
+    subtrees.push_back(root);
+
+    while(subtrees.size() < subtree_count) {
+        // Finds the highest subtree, the first one in case of equality to keep the split deterministic
+        std::size_t highest = 0;
+        for(std::size_t i = 1 ; i < subtrees.size() ; ++i) {
+            if(nodes[subtrees[i]].height > nodes[subtrees[highest]].height) { highest = i; }
+        }
+
+        const BVHNode& node = nodes[subtrees[highest]];
+        if(node.is_leaf()) { break; }
+
+        subtrees[highest] = node.left;
+        subtrees.insert(subtrees.begin() + highest + 1, node.right);
+    }
+}
+
+void BVH::clear() {
+    nodes.clear();
+    root = BVH_NULL_NODE;
+    free_list = BVH_NULL_NODE;
+    entity_count = 0;
+}
+
+int BVH::get_height() const {
+    return root == BVH_NULL_NODE ? 0 : nodes[root].height;
+}
+
+unsigned int BVH::get_entity_count() const {
+    return entity_count;
+}
+
+int BVH::allocate_node() {
+    if(free_list == BVH_NULL_NODE) {
+        nodes.emplace_back();
+        free_list = static_cast<int>(nodes.size()) - 1;
+        nodes.back().parent = BVH_NULL_NODE;
+    }
+
+    const int index = free_list;
+    BVHNode& node = nodes[index];
+    free_list = node.parent;
+
+    node.parent = BVH_NULL_NODE;
+    node.left = BVH_NULL_NODE;
+    node.right = BVH_NULL_NODE;
+    node.height = 0;
+    node.last_failed_plane = 0;
+    node.entity = nullptr;
+
+    return index;
+}
+
+void BVH::free_node(int node) {
+    nodes[node].parent = free_list;
+    nodes[node].height = -1;
+    free_list = node;
+}
+
+void BVH::insert_leaf(int leaf) {
+    if(root == BVH_NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = BVH_NULL_NODE;
+        return;
+    }
+
+    // Finds the best sibling by descending towards the child with the lowest insertion cost
+    int index = root;
+    while(!nodes[index].is_leaf()) {
+        const BVHNode& node = nodes[index];
+        const BVHNode& leaf_node = nodes[leaf];
+
+        const float area = surface_area(node.min, node.max);
+        const float combined_area = union_surface_area(node, leaf_node);
+
+        // Cost of creating a new parent for this node and the leaf
+        const float cost = 2.0f * combined_area;
+
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto get_child_cost = [&](const BVHNode& child) {
+            const float child_cost = union_surface_area(child, leaf_node);
+            return (child.is_leaf() ? child_cost : child_cost - surface_area(child.min, child.max)) + inheritance_cost;
+        };
+
+        const float left_cost = get_child_cost(nodes[node.left]);
+        const float right_cost = get_child_cost(nodes[node.right]);
+
+        if(cost < left_cost && cost < right_cost) { break; }
+
+        index = left_cost < right_cost ? node.left : node.right;
+    }
+
+    // Creates a new parent for the sibling and the leaf
+    const int sibling = index;
+    const int old_parent = nodes[sibling].parent;
+    const int new_parent = allocate_node();
+
+    BVHNode& parent_node = nodes[new_parent];
+    parent_node.parent = old_parent;
+    parent_node.left = sibling;
+    parent_node.right = leaf;
+    parent_node.min = component_min(nodes[sibling].min, nodes[leaf].min);
+    parent_node.max = component_max(nodes[sibling].max, nodes[leaf].max);
+    parent_node.height = nodes[sibling].height + 1;
+
+    if(old_parent == BVH_NULL_NODE) {
+        root = new_parent;
+    } else if(nodes[old_parent].left == sibling) {
+        nodes[old_parent].left = new_parent;
+    } else {
+        nodes[old_parent].right = new_parent;
+    }
+
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+
+    refit_ancestors(new_parent);
+}
+
+void BVH::remove_leaf(int leaf) {
+    if(leaf == root) {
+        root = BVH_NULL_NODE;
+        return;
+    }
+
+    const int parent = nodes[leaf].parent;
+    const int grand_parent = nodes[parent].parent;
+    const int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    // Replaces the parent by the sibling
+    if(grand_parent == BVH_NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = BVH_NULL_NODE;
+    } else {
+        if(nodes[grand_parent].left == parent) {
+            nodes[grand_parent].left = sibling;
+        } else {
+            nodes[grand_parent].right = sibling;
+        }
+
+        nodes[sibling].parent = grand_parent;
+    }
+
+    free_node(parent);
+    nodes[leaf].parent = BVH_NULL_NODE;
+
+    if(grand_parent != BVH_NULL_NODE) { refit_ancestors(grand_parent); }
+}
+
+void BVH::refit_ancestors(int node) {
+    while(node != BVH_NULL_NODE) {
+        node = balance(node);
+        refit_node(node);
+        node = nodes[node].parent;
+    }
+}
+
+int BVH::balance(int a) {
+    if(nodes[a].is_leaf() || nodes[a].height < 2) { return a; }
+
+    const int b = nodes[a].left;
+    const int c = nodes[a].right;
+    const int balance = nodes[c].height - nodes[b].height;
+
+    if(balance >= -1 && balance <= 1) { return a; }
+
+    // Rotates the highest child up, the other child staying under a
+    const int up = balance > 1 ? c : b;
+    const int other = balance > 1 ? b : c;
+    const int f = nodes[up].left;
+    const int g = nodes[up].right;
+
+    nodes[up].left = a;
+    nodes[up].parent = nodes[a].parent;
+    nodes[a].parent = up;
+
+    if(nodes[up].parent == BVH_NULL_NODE) {
+        root = up;
+    } else if(nodes[nodes[up].parent].left == a) {
+        nodes[nodes[up].parent].left = up;
+    } else {
+        nodes[nodes[up].parent].right = up;
+    }
+
+    // The highest grandchild stays under the rotated child, the other one moves under a
+    const int kept = nodes[f].height > nodes[g].height ? f : g;
+    const int moved = kept == f ? g : f;
+
+    nodes[up].right = kept;
+    nodes[a].left = other;
+    nodes[a].right = moved;
+    nodes[moved].parent = a;
+
+    refit_node(a);
+    refit_node(up);
+
+    return up;
+}
+
+void BVH::refit_node(int node) {
+    BVHNode& parent = nodes[node];
+    const BVHNode& left = nodes[parent.left];
+    const BVHNode& right = nodes[parent.right];
+
+    parent.min = component_min(left.min, right.min);
+    parent.max = component_max(left.max, right.max);
+    parent.height = 1 + std::max(left.height, right.height);
+}
@@ -4,3 +4,127 @@
  **************************************************************************************************/
 
 #include "culling/Frustum.hpp"
+
+#include <cmath>
+#include "maths/geometry.hpp"
+
+/**
+ * @brief Calculates the signed distance between a plane and a point.
+ */
+static inline float signed_distance(const vec4& plane, const vec3& point) {
+    return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+/**
+ * @brief Calculates the projection of the half diagonal of an AABB on the normal of a plane.
+ */
+static inline float projected_radius(const vec4& plane, const vec3& extent) {
+    return std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+}
+
+void Frustum::update(const mat4& view_projection_matrix) {
+    view_projection = view_projection_matrix;
+
+    const mat4& m = view_projection_matrix;
+    for(int i = 0 ; i < 3 ; ++i) {
+        planes[2 * i] = vec4(m(3, 0) + m(i, 0), m(3, 1) + m(i, 1), m(3, 2) + m(i, 2), m(3, 3) + m(i, 3));
+        planes[2 * i + 1] = vec4(m(3, 0) - m(i, 0), m(3, 1) - m(i, 1), m(3, 2) - m(i, 2), m(3, 3) - m(i, 3));
+    }
+
+    for(vec4& plane : planes) {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane.x /= length;
+        plane.y /= length;
+        plane.z /= length;
+        plane.w /= length;
+    }
+
+    // Intersection of the left, right and bottom planes
+    const vec3 n1(planes[FRUSTUM_PLANE_LEFT].x, planes[FRUSTUM_PLANE_LEFT].y, planes[FRUSTUM_PLANE_LEFT].z);
+    const vec3 n2(planes[FRUSTUM_PLANE_RIGHT].x, planes[FRUSTUM_PLANE_RIGHT].y, planes[FRUSTUM_PLANE_RIGHT].z);
+    const vec3 n3(planes[FRUSTUM_PLANE_BOTTOM].x, planes[FRUSTUM_PLANE_BOTTOM].y, planes[FRUSTUM_PLANE_BOTTOM].z);
+
+    const vec3 n2_cross_n3 = cross(n2, n3);
+    const vec3 n3_cross_n1 = cross(n3, n1);
+    const vec3 n1_cross_n2 = cross(n1, n2);
+
+    position = -(planes[FRUSTUM_PLANE_LEFT].w * n2_cross_n3 + planes[FRUSTUM_PLANE_RIGHT].w * n3_cross_n1
+                 + planes[FRUSTUM_PLANE_BOTTOM].w * n1_cross_n2) / dot(n1, n2_cross_n3);
+}
+
+bool Frustum::is_aabb_visible(const vec3& center, const vec3& extent, unsigned char& last_failed_plane) const {
+    const vec4& cached_plane = planes[last_failed_plane];
+    if(signed_distance(cached_plane, center) < -projected_radius(cached_plane, extent)) { return false; }
+
+    for(unsigned char i = 0 ; i < 6 ; ++i) {
+        if(i == last_failed_plane) { continue; }
+
+        if(signed_distance(planes[i], center) < -projected_radius(planes[i], extent)) {
+            last_failed_plane = i;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::is_aabb_visible(const vec3& center, const vec3& extent,
+                              unsigned char& last_failed_plane, unsigned char& plane_mask) const {
+    if(plane_mask & 1 << last_failed_plane) {
+        const vec4& cached_plane = planes[last_failed_plane];
+        if(signed_distance(cached_plane, center) < -projected_radius(cached_plane, extent)) { return false; }
+    }
+
+    for(unsigned char i = 0 ; i < 6 ; ++i) {
+        if(!(plane_mask & 1 << i)) { continue; }
+
+        const float distance = signed_distance(planes[i], center);
+        const float radius = projected_radius(planes[i], extent);
+
+        if(distance < -radius) {
+            last_failed_plane = i;
+            return false;
+        }
+
+        if(distance >= radius) { plane_mask &= ~(1 << i); }
+    }
+
+    return true;
+}
+
+bool Frustum::is_sphere_visible(const vec3& center, float radius, unsigned char& last_failed_plane) const {
+    if(signed_distance(planes[last_failed_plane], center) < -radius) { return false; }
+
+    for(unsigned char i = 0 ; i < 6 ; ++i) {
+        if(i == last_failed_plane) { continue; }
+
+        if(signed_distance(planes[i], center) < -radius) {
+            last_failed_plane = i;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::is_sphere_visible(const vec3& center, float radius,
+                                unsigned char& last_failed_plane, unsigned char& plane_mask) const {
+    if(plane_mask & 1 << last_failed_plane && signed_distance(planes[last_failed_plane], center) < -radius) {
+        return false;
+    }
+
+    for(unsigned char i = 0 ; i < 6 ; ++i) {
+        if(!(plane_mask & 1 << i)) { continue; }
+
+        const float distance = signed_distance(planes[i], center);
+
+        if(distance < -radius) {
+            last_failed_plane = i;
+            return false;
+        }
+
+        if(distance >= radius) { plane_mask &= ~(1 << i); }
+    }
+
+    return true;
+}
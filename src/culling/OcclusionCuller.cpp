@@ -0,0 +1,277 @@
+/***************************************************************************************************
+ * @file  OcclusionCuller.cpp
+ * @brief Implementation of the OcclusionCuller class
+ **************************************************************************************************/
+
+#include "culling/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "maths/simd.hpp"
+
+/**
+ * @brief Areas of triangles below this amount of square pixels are skipped.
+ */
+static constexpr float OCCLUSION_MIN_TRIANGLE_AREA = 1e-6f;
+
+/**
+ * @brief Boxes are brought closer by this depth when tested, so that an occluder whose surface lies on
+ * its box isn't culled by its own depths because of rounding errors.
+ */
+static constexpr float OCCLUSION_DEPTH_BIAS = 1e-5f;
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height)
+    : width(width), height(height), rasterized_triangle_count(0) {
+    if(width == 0 || height == 0 || width % 4 != 0) {
+        throw std::runtime_error("Occlusion buffer's width needs to be a non zero multiple of 4");
+    }
+
+    // Each level halves the previous one, rounding up, until it is a single texel
+    unsigned int level_width = width;
+    unsigned int level_height = height;
+
+    while(true) {
+        levels.emplace_back(level_width * level_height, 1.0f);
+        level_widths.push_back(level_width);
+        level_heights.push_back(level_height);
+
+        if(level_width == 1 && level_height == 1) { break; }
+
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+}
+
+void OcclusionCuller::begin(const mat4& view_projection_matrix) {
+    view_projection = view_projection_matrix;
+    std::fill(levels[0].begin(), levels[0].end(), 1.0f);
+    rasterized_triangle_count = 0;
+}
+
+void OcclusionCuller::rasterize_mesh(const affine3x4& model, const Mesh& mesh) {
+    const float* positions = mesh.get_positions();
+    if(mesh.get_primitive() != Primitive::TRIANGLES || positions == nullptr) { return; }
+
+    const mat4 model_view_projection = view_projection * model;
+    const unsigned int stride = mesh.get_stride();
+    const std::size_t vertex_count = mesh.get_vertices_amount();
+
+    clip_positions.resize(vertex_count);
+    for(std::size_t i = 0 ; i < vertex_count ; ++i) {
+        const float* position = positions + i * stride;
+        clip_positions[i] = model_view_projection * vec4(position[0], position[1], position[2], 1.0f);
+    }
+
+    // Triangles with a vertex in front of the near plane are skipped instead of being clipped, which
+    // only makes the occluder smaller
+    auto rasterize = [&](unsigned int i0, unsigned int i1, unsigned int i2) {
+        const vec4& p0 = clip_positions[i0];
+        const vec4& p1 = clip_positions[i1];
+        const vec4& p2 = clip_positions[i2];
+        if(p0.z < -p0.w || p1.z < -p1.w || p2.z < -p2.w) { return; }
+
+        auto to_screen = [&](const vec4& p) {
+            const float inverse_w = 1.0f / p.w;
+            return vec3((p.x * inverse_w * 0.5f + 0.5f) * width,
+                        (p.y * inverse_w * 0.5f + 0.5f) * height,
+                        p.z * inverse_w);
+        };
+
+        rasterize_triangle(to_screen(p0), to_screen(p1), to_screen(p2));
+    };
+
+    const std::vector<unsigned int>& indices = mesh.get_indices();
+    if(indices.empty()) {
+        for(unsigned int i = 0 ; i + 2 < vertex_count ; i += 3) { rasterize(i, i + 1, i + 2); }
+    } else {
+        for(std::size_t i = 0 ; i + 2 < indices.size() ; i += 3) {
+            rasterize(indices[i], indices[i + 1], indices[i + 2]);
+        }
+    }
+}
+
+void OcclusionCuller::build_hierarchy() {
+    for(std::size_t level = 1 ; level < levels.size() ; ++level) {
+        const std::vector<float>& source = levels[level - 1];
+        const unsigned int source_width = level_widths[level - 1];
+        const unsigned int source_height = level_heights[level - 1];
+        std::vector<float>& destination = levels[level];
+
+        // Children outside of an odd sized source are clamped to its last row or column
+        for(unsigned int y = 0 ; y < level_heights[level] ; ++y) {
+            const unsigned int y0 = 2 * y;
+            const unsigned int y1 = std::min(y0 + 1, source_height - 1);
+
+            for(unsigned int x = 0 ; x < level_widths[level] ; ++x) {
+                const unsigned int x0 = 2 * x;
+                const unsigned int x1 = std::min(x0 + 1, source_width - 1);
+
+                destination[y * level_widths[level] + x] = std::max(
+                    std::max(source[y0 * source_width + x0], source[y0 * source_width + x1]),
+                    std::max(source[y1 * source_width + x0], source[y1 * source_width + x1])
+                );
+            }
+        }
+    }
+}
+
+float OcclusionCuller::get_screen_coverage(const AABB& bounds) const {
+    float min_x, min_y, max_x, max_y, min_depth;
+    if(!project_bounds(bounds, min_x, min_y, max_x, max_y, min_depth)) { return 1.0f; }
+
+    const float screen_width = static_cast<float>(width);
+    const float screen_height = static_cast<float>(height);
+
+    const float covered_width = std::clamp(max_x, 0.0f, screen_width) - std::clamp(min_x, 0.0f, screen_width);
+    const float covered_height = std::clamp(max_y, 0.0f, screen_height) - std::clamp(min_y, 0.0f, screen_height);
+
+    return covered_width * covered_height / (screen_width * screen_height);
+}
+
+bool OcclusionCuller::is_visible(const AABB& bounds) const {
+    float min_x, min_y, max_x, max_y, min_depth;
+    if(!project_bounds(bounds, min_x, min_y, max_x, max_y, min_depth)) { return true; }
+    if(max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(width) || min_y >= static_cast<float>(height)) {
+        return true;
+    }
+
+    // Every pixel touched by the rectangle, not only the ones whose center is inside of it
+    const unsigned int x0 = static_cast<unsigned int>(std::max(min_x, 0.0f));
+    const unsigned int y0 = static_cast<unsigned int>(std::max(min_y, 0.0f));
+    const unsigned int x1 = std::min(static_cast<unsigned int>(max_x), width - 1);
+    const unsigned int y1 = std::min(static_cast<unsigned int>(max_y), height - 1);
+
+    // Goes up the hierarchy until the rectangle covers at most 2x2 texels
+    unsigned int level = 0;
+    while(level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        ++level;
+    }
+
+    const std::vector<float>& depths = levels[level];
+    const unsigned int level_width = level_widths[level];
+    const float biased_depth = min_depth - OCCLUSION_DEPTH_BIAS;
+
+    for(unsigned int y = y0 >> level ; y <= y1 >> level ; ++y) {
+        for(unsigned int x = x0 >> level ; x <= x1 >> level ; ++x) {
+            if(biased_depth <= depths[y * level_width + x]) { return true; }
+        }
+    }
+
+    return false;
+}
+
+unsigned int OcclusionCuller::get_rasterized_triangle_count() const {
+    return rasterized_triangle_count;
+}
+
+bool OcclusionCuller::project_bounds(const AABB& bounds, float& min_x, float& min_y, float& max_x, float& max_y,
+                                     float& min_depth) const {
+    min_x = min_y = min_depth = std::numeric_limits<float>::max();
+    max_x = max_y = std::numeric_limits<float>::lowest();
+
+    for(unsigned int corner = 0 ; corner < 8 ; ++corner) {
+        const vec3 point(bounds.center.x + (corner & 1 ? bounds.extent.x : -bounds.extent.x),
+                         bounds.center.y + (corner & 2 ? bounds.extent.y : -bounds.extent.y),
+                         bounds.center.z + (corner & 4 ? bounds.extent.z : -bounds.extent.z));
+
+        const vec4 clip = view_projection * vec4(point.x, point.y, point.z, 1.0f);
+        if(clip.z < -clip.w) { return false; }
+
+        const float inverse_w = 1.0f / clip.w;
+        const float x = (clip.x * inverse_w * 0.5f + 0.5f) * width;
+        const float y = (clip.y * inverse_w * 0.5f + 0.5f) * height;
+
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+        min_depth = std::min(min_depth, clip.z * inverse_w);
+    }
+
+    return true;
+}
+
+void OcclusionCuller::rasterize_triangle(vec3 a, vec3 b, vec3 c) {
+    // Orders the vertices so that the edge functions are positive inside of the triangle
+    float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+    if(std::abs(area) < OCCLUSION_MIN_TRIANGLE_AREA) { return; }
+    if(area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    // Pixels whose center is inside of the triangle's bounding rectangle
+    const float min_x = std::ceil(std::min({ a.x, b.x, c.x }) - 0.5f);
+    const float min_y = std::ceil(std::min({ a.y, b.y, c.y }) - 0.5f);
+    const float max_x = std::floor(std::max({ a.x, b.x, c.x }) - 0.5f);
+    const float max_y = std::floor(std::max({ a.y, b.y, c.y }) - 0.5f);
+
+    if(max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(width) || min_y >= static_cast<float>(height)) {
+        return;
+    }
+
+    const unsigned int x0 = static_cast<unsigned int>(std::max(min_x, 0.0f));
+    const unsigned int y0 = static_cast<unsigned int>(std::max(min_y, 0.0f));
+    const unsigned int x1 = std::min(static_cast<unsigned int>(max_x), width - 1);
+    const unsigned int y1 = std::min(static_cast<unsigned int>(max_y), height - 1);
+    if(x0 > x1 || y0 > y1) { return; }
+
+    ++rasterized_triangle_count;
+
+    // Edge functions as linear functions of the pixel's center: A * x + B * y + C
+    const float a0 = b.y - c.y, b0 = c.x - b.x, c0 = b.x * c.y - b.y * c.x;
+    const float a1 = c.y - a.y, b1 = a.x - c.x, c1 = c.x * a.y - c.y * a.x;
+    const float a2 = a.y - b.y, b2 = b.x - a.x, c2 = a.x * b.y - a.y * b.x;
+
+    // The depth is interpolated from the first vertex since a constant term in pixel coordinates would be
+    // much larger than the depths, its rounding error being enough for an occluder to occlude itself
+    const float inverse_area = 1.0f / area;
+    const float depth_dx = ((b.z - a.z) * a1 + (c.z - a.z) * a2) * inverse_area;
+    const float depth_dy = ((b.z - a.z) * b1 + (c.z - a.z) * b2) * inverse_area;
+
+    float* depths = levels[0].data();
+
+    for(unsigned int y = y0 ; y <= y1 ; ++y) {
+        const float py = static_cast<float>(y) + 0.5f;
+        const float row_depth = a.z + depth_dy * (py - a.y);
+        float* row = depths + y * width;
+
+        unsigned int x = x0;
+
+#ifdef MATHS_USE_SSE
+        // Blocks of 4 pixels aligned on the buffer, the width being a multiple of 4
+        x = x0 & ~3u;
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+
+        for(; x <= x1 ; x += 4) {
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+            const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), _mm_set1_ps(b0 * py + c0));
+            const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), _mm_set1_ps(b1 * py + c1));
+            const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), _mm_set1_ps(b2 * py + c2));
+
+            const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                             _mm_cmpge_ps(e2, zero));
+            if(_mm_movemask_ps(inside) == 0) { continue; }
+
+            const __m128 depth = _mm_add_ps(_mm_set1_ps(row_depth),
+                                            _mm_mul_ps(_mm_set1_ps(depth_dx), _mm_sub_ps(px, _mm_set1_ps(a.x))));
+            const __m128 previous = _mm_loadu_ps(row + x);
+            const __m128 nearest = _mm_min_ps(previous, depth);
+
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+        }
+#endif
+
+        for(; x <= x1 ; ++x) {
+            const float px = static_cast<float>(x) + 0.5f;
+
+            if(a0 * px + b0 * py + c0 >= 0.0f && a1 * px + b1 * py + c1 >= 0.0f && a2 * px + b2 * py + c2 >= 0.0f) {
+                row[x] = std::min(row[x], row_depth + depth_dx * (px - a.x));
+            }
+        }
+    }
+}
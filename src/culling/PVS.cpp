@@ -0,0 +1,503 @@
+/***************************************************************************************************
+ * @file  PVS.cpp
+ * @brief Implementation of the PVS class
+ **************************************************************************************************/
+
+#include "culling/PVS.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include "maths/fast.hpp"
+#include "maths/geometry.hpp"
+#include "utility/ThreadPool.hpp"
+
+/**
+ * @brief The amount of rays cast in random directions from each cell.
+ */
+static constexpr unsigned int PVS_DIRECTIONAL_RAYS = 256;
+
+/**
+ * @brief The amount of rays cast from each cell towards each object it didn't see yet.
+ */
+static constexpr unsigned int PVS_OBJECT_RAYS = 8;
+
+/**
+ * @brief The maximum amount of triangles in a leaf of the bake's BVH.
+ */
+static constexpr unsigned int PVS_MAX_LEAF_TRIANGLES = 4;
+
+/**
+ * @brief Identifies PVS files.
+ */
+static constexpr char PVS_FILE_MAGIC[4] = { 'P', 'V', 'S', '1' };
+
+/**
+ * @brief Means that a ray didn't hit any object.
+ */
+static constexpr unsigned int PVS_NO_OBJECT = std::numeric_limits<unsigned int>::max();
+
+/**
+ * @struct PVSTriangle
+ * @brief A triangle of an object, stored as a vertex and two edges for ray intersections.
+ */
+struct PVSTriangle {
+    vec3 a;              ///< The first vertex.
+    vec3 edge_ab;        ///< The edge from the first vertex to the second one.
+    vec3 edge_ac;        ///< The edge from the first vertex to the third one.
+    unsigned int object; ///< The index of the triangle's object.
+};
+
+/**
+ * @struct PVSNode
+ * @brief A node of the bake's BVH. The left child of an internal node directly follows it.
+ */
+struct PVSNode {
+    vec3 min;           ///< The minimum corner of the node's bounds.
+    vec3 max;           ///< The maximum corner of the node's bounds.
+    unsigned int first; ///< The first triangle of a leaf, or the right child of an internal node.
+    unsigned int count; ///< The amount of triangles of a leaf, 0 for an internal node.
+};
+
+/**
+ * @class PVSRayCaster
+ * @brief Finds the nearest triangle hit by rays, using a BVH built by splitting the triangles at the
+ * median of their centroids.
+ */
+class PVSRayCaster {
+public:
+    /**
+     * @brief Builds the BVH of triangles.
+     * @param triangles The triangles, which need to outlive the ray caster.
+     */
+    explicit PVSRayCaster(const std::vector<PVSTriangle>& triangles)
+        : triangles(triangles), triangle_indices(triangles.size()) {
+        for(unsigned int i = 0 ; i < triangles.size() ; ++i) { triangle_indices[i] = i; }
+
+        centroids.reserve(triangles.size());
+        for(const PVSTriangle& triangle : triangles) {
+            centroids.push_back(triangle.a + (triangle.edge_ab + triangle.edge_ac) / 3.0f);
+        }
+
+        if(!triangles.empty()) { build(0, triangles.size()); }
+    }
+
+    /**
+     * @brief Finds the nearest triangle hit by a segment.
+     * @param origin The origin of the segment.
+     * @param direction The direction of the segment, whose length is the segment's length.
+     * @param max_distance The maximum distance along the segment, in multiples of its direction.
+     * @param distance Stores the distance of the hit, in multiples of the direction.
+     * @return The object of the nearest triangle, PVS_NO_OBJECT if no triangle was hit.
+     */
+    unsigned int cast(const vec3& origin, const vec3& direction, float max_distance, float& distance) const {
+        unsigned int hit_object = PVS_NO_OBJECT;
+        distance = max_distance;
+        if(nodes.empty()) { return hit_object; }
+
+        const vec3 inverse_direction(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+        unsigned int stack[64];
+        unsigned int stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while(stack_size > 0) {
+            const PVSNode& node = nodes[stack[--stack_size]];
+            if(get_entry_distance(node, origin, inverse_direction, distance) > distance) { continue; }
+
+            if(node.count > 0) {
+                for(unsigned int i = node.first ; i < node.first + node.count ; ++i) {
+                    const PVSTriangle& triangle = triangles[triangle_indices[i]];
+                    float triangle_distance;
+                    if(intersects_triangle(triangle, origin, direction, triangle_distance)
+                       && triangle_distance < distance) {
+                        distance = triangle_distance;
+                        hit_object = triangle.object;
+                    }
+                }
+            } else {
+                // The nearest child is visited first so that its hits discard more of the other one
+                unsigned int near_child = &node - nodes.data() + 1;
+                unsigned int far_child = node.first;
+                if(get_entry_distance(nodes[near_child], origin, inverse_direction, distance)
+                   > get_entry_distance(nodes[far_child], origin, inverse_direction, distance)) {
+                    std::swap(near_child, far_child);
+                }
+
+                stack[stack_size++] = far_child;
+                stack[stack_size++] = near_child;
+            }
+        }
+
+        return hit_object;
+    }
+
+private:
+    /**
+     * @brief Recursively builds the node of a range of triangle indices.
+     * @param begin The first triangle index of the range.
+     * @param end The end of the range.
+     * @return The index of the node.
+     */
+    unsigned int build(unsigned int begin, unsigned int end) {
+        const unsigned int node_index = nodes.size();
+        nodes.emplace_back();
+
+        vec3 min(std::numeric_limits<float>::max());
+        vec3 max(std::numeric_limits<float>::lowest());
+        vec3 centroid_min = min;
+        vec3 centroid_max = max;
+
+        for(unsigned int i = begin ; i < end ; ++i) {
+            const PVSTriangle& triangle = triangles[triangle_indices[i]];
+            for(const vec3& vertex : { triangle.a, triangle.a + triangle.edge_ab, triangle.a + triangle.edge_ac }) {
+                min = vec3(std::min(min.x, vertex.x), std::min(min.y, vertex.y), std::min(min.z, vertex.z));
+                max = vec3(std::max(max.x, vertex.x), std::max(max.y, vertex.y), std::max(max.z, vertex.z));
+            }
+
+            const vec3& centroid = centroids[triangle_indices[i]];
+            centroid_min = vec3(std::min(centroid_min.x, centroid.x), std::min(centroid_min.y, centroid.y),
+                                std::min(centroid_min.z, centroid.z));
+            centroid_max = vec3(std::max(centroid_max.x, centroid.x), std::max(centroid_max.y, centroid.y),
+                                std::max(centroid_max.z, centroid.z));
+        }
+
+        nodes[node_index].min = min;
+        nodes[node_index].max = max;
+
+        const vec3 extent = centroid_max - centroid_min;
+        const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+        if(end - begin <= PVS_MAX_LEAF_TRIANGLES || extent[axis] <= 0.0f) {
+            nodes[node_index].first = begin;
+            nodes[node_index].count = end - begin;
+            return node_index;
+        }
+
+        const unsigned int middle = begin + (end - begin) / 2;
+        std::nth_element(triangle_indices.begin() + begin, triangle_indices.begin() + middle,
+                         triangle_indices.begin() + end, [&](unsigned int a, unsigned int b) {
+                             return centroids[a][axis] < centroids[b][axis];
+                         });
+
+        build(begin, middle);
+        const unsigned int right = build(middle, end);
+
+        nodes[node_index].first = right;
+        nodes[node_index].count = 0;
+        return node_index;
+    }
+
+    /**
+     * @brief Calculates the distance at which a segment enters a node's bounds (slab test).
+     * @return The distance, infinity if the segment doesn't enter them before the maximum distance.
+     */
+    static float get_entry_distance(const PVSNode& node, const vec3& origin, const vec3& inverse_direction,
+                                    float max_distance) {
+        float near = 0.0f;
+        float far = max_distance;
+
+        for(int axis = 0 ; axis < 3 ; ++axis) {
+            float t1 = (node.min[axis] - origin[axis]) * inverse_direction[axis];
+            float t2 = (node.max[axis] - origin[axis]) * inverse_direction[axis];
+            if(t1 > t2) { std::swap(t1, t2); }
+
+            // NaNs from 0 * inf are ignored by the comparisons' order
+            near = t1 > near ? t1 : near;
+            far = t2 < far ? t2 : far;
+            if(near > far) { return std::numeric_limits<float>::infinity(); }
+        }
+
+        return near;
+    }
+
+    /**
+     * @brief Intersects a segment with both sides of a triangle (Möller-Trumbore).
+     */
+    static bool intersects_triangle(const PVSTriangle& triangle, const vec3& origin, const vec3& direction,
+                                    float& distance) {
+        const vec3 p = cross(direction, triangle.edge_ac);
+        const float determinant = dot(triangle.edge_ab, p);
+        if(std::abs(determinant) < 1e-12f) { return false; }
+
+        const float inverse_determinant = 1.0f / determinant;
+        const vec3 s = origin - triangle.a;
+        const float u = dot(s, p) * inverse_determinant;
+        if(u < 0.0f || u > 1.0f) { return false; }
+
+        const vec3 q = cross(s, triangle.edge_ab);
+        const float v = dot(direction, q) * inverse_determinant;
+        if(v < 0.0f || u + v > 1.0f) { return false; }
+
+        distance = dot(triangle.edge_ac, q) * inverse_determinant;
+        return distance > 0.0f;
+    }
+
+    const std::vector<PVSTriangle>& triangles;  ///< The triangles.
+    std::vector<vec3> centroids;                ///< The centroid of each triangle.
+    std::vector<unsigned int> triangle_indices; ///< The triangles, ordered by leaf.
+    std::vector<PVSNode> nodes;                 ///< The nodes, the root being the first one.
+};
+
+/**
+ * @brief Compresses a bitset by replacing each run of zero bytes with a zero followed by its length.
+ */
+static void compress_bitset(const std::vector<unsigned char>& bitset, std::vector<unsigned char>& compressed) {
+    for(std::size_t i = 0 ; i < bitset.size() ;) {
+        if(bitset[i] != 0) {
+            compressed.push_back(bitset[i++]);
+            continue;
+        }
+
+        unsigned char run = 0;
+        while(i < bitset.size() && bitset[i] == 0 && run < 255) {
+            ++run;
+            ++i;
+        }
+
+        compressed.push_back(0);
+        compressed.push_back(run);
+    }
+}
+
+PVS::PVS()
+    : grid_min(0.0f), cell_size(0.0f), cell_counts(0), object_count(0), cached_cell(-1) { }
+
+void PVS::bake(const std::vector<const Mesh*>& objects, const std::vector<bool>& are_occluders,
+               unsigned int resolution) {
+    object_count = objects.size();
+    cell_offsets.clear();
+    data.clear();
+    cached_cell = -1;
+
+    /* Triangles */
+    std::vector<PVSTriangle> triangles;
+    std::vector<unsigned int> object_first_triangles(object_count + 1, 0);
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+
+    for(unsigned int object = 0 ; object < object_count ; ++object) {
+        const Mesh& mesh = *objects[object];
+        const float* positions = mesh.get_positions();
+        const std::vector<unsigned int>& indices = mesh.get_indices();
+        const unsigned int triangle_count = mesh.get_triangle_count();
+
+        auto get_position = [&](std::size_t vertex) {
+            const std::size_t index = indices.empty() ? vertex : indices[vertex];
+            const float* position = positions + index * mesh.get_stride();
+            return vec3(position[0], position[1], position[2]);
+        };
+
+        for(std::size_t i = 0 ; positions != nullptr && i < 3 * static_cast<std::size_t>(triangle_count) ; i += 3) {
+            const vec3 a = get_position(i);
+            const vec3 b = get_position(i + 1);
+            const vec3 c = get_position(i + 2);
+            triangles.push_back({ a, b - a, c - a, object });
+
+            for(const vec3& vertex : { a, b, c }) {
+                min = vec3(std::min(min.x, vertex.x), std::min(min.y, vertex.y), std::min(min.z, vertex.z));
+                max = vec3(std::max(max.x, vertex.x), std::max(max.y, vertex.y), std::max(max.z, vertex.z));
+            }
+        }
+
+        object_first_triangles[object + 1] = triangles.size();
+    }
+
+    if(triangles.empty() || resolution == 0) {
+        cell_counts = uvec3(0);
+        return;
+    }
+
+    /* Grid */
+    const vec3 extent = max - min;
+    const float size = std::max({ extent.x, extent.y, extent.z }) / static_cast<float>(resolution);
+
+    for(int axis = 0 ; axis < 3 ; ++axis) {
+        cell_counts[axis] = std::max(1u, static_cast<unsigned int>(std::ceil(extent[axis] / size)));
+        cell_size[axis] = size;
+    }
+    grid_min = min;
+
+    /* Visibility */
+    std::vector<PVSTriangle> occluder_triangles;
+    for(const PVSTriangle& triangle : triangles) {
+        if(are_occluders[triangle.object]) { occluder_triangles.push_back(triangle); }
+    }
+
+    const PVSRayCaster ray_caster(occluder_triangles);
+    const unsigned int cell_count = get_cell_count();
+    const std::size_t bitset_size = (object_count + 7) / 8;
+    std::vector<std::vector<unsigned char>> cell_data(cell_count);
+
+    ThreadPool thread_pool;
+    thread_pool.run(cell_count, [&](unsigned int cell, unsigned int) {
+        // Seeded with the cell so that baking is deterministic
+        std::minstd_rand generator(cell + 1);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        auto random = [&] { return distribution(generator); };
+
+        const vec3 cell_min = grid_min + cell_size * vec3(static_cast<float>(cell % cell_counts.x),
+                                                          static_cast<float>(cell / cell_counts.x % cell_counts.y),
+                                                          static_cast<float>(cell / (cell_counts.x * cell_counts.y)));
+        auto get_random_point_in_cell = [&] {
+            return cell_min + cell_size * vec3(random(), random(), random());
+        };
+
+        std::vector<unsigned char> bitset(bitset_size, 0);
+        auto set_visible = [&](unsigned int object) { bitset[object / 8] |= 1 << object % 8; };
+        auto is_visible = [&](unsigned int object) { return (bitset[object / 8] >> object % 8 & 1) != 0; };
+
+        for(unsigned int object = 0 ; object < object_count ; ++object) {
+            if(object_first_triangles[object] == object_first_triangles[object + 1]) { set_visible(object); }
+        }
+
+        // Rays in random directions find most of the visible objects
+        for(unsigned int i = 0 ; i < PVS_DIRECTIONAL_RAYS ; ++i) {
+            const float z = 2.0f * random() - 1.0f;
+            const float angle = 2.0f * M_PIf * random();
+            const float radius = fast_sqrt(1.0f - z * z);
+            const vec3 direction(radius * fast_cos(angle), radius * fast_sin(angle), z);
+
+            float distance;
+            const unsigned int object = ray_caster.cast(get_random_point_in_cell(), direction,
+                                                        std::numeric_limits<float>::max(), distance);
+            if(object != PVS_NO_OBJECT) { set_visible(object); }
+        }
+
+        // Rays towards random points of the remaining objects find the small and distant ones
+        for(unsigned int object = 0 ; object < object_count ; ++object) {
+            const unsigned int first_triangle = object_first_triangles[object];
+            const unsigned int triangle_count = object_first_triangles[object + 1] - first_triangle;
+
+            for(unsigned int i = 0 ; i < PVS_OBJECT_RAYS && !is_visible(object) ; ++i) {
+                const PVSTriangle& triangle = triangles[first_triangle + std::min<unsigned int>(
+                                                            random() * triangle_count, triangle_count - 1)];
+                float u = random();
+                float v = random();
+                if(u + v > 1.0f) {
+                    u = 1.0f - u;
+                    v = 1.0f - v;
+                }
+
+                const vec3 origin = get_random_point_in_cell();
+                const vec3 target = triangle.a + u * triangle.edge_ab + v * triangle.edge_ac;
+
+                // The target is reached if no other occluder is hit before it
+                float distance;
+                const unsigned int hit_object = ray_caster.cast(origin, target - origin, 1.0f, distance);
+                if(hit_object == PVS_NO_OBJECT || hit_object == object || distance > 0.999f) { set_visible(object); }
+            }
+        }
+
+        compress_bitset(bitset, cell_data[cell]);
+    });
+
+    cell_offsets.reserve(cell_count + 1);
+    for(const std::vector<unsigned char>& compressed : cell_data) {
+        cell_offsets.push_back(data.size());
+        data.insert(data.end(), compressed.begin(), compressed.end());
+    }
+    cell_offsets.push_back(data.size());
+}
+
+void PVS::save(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if(!file.is_open()) { throw std::runtime_error("Couldn't open file '" + path.string() + '\''); }
+
+    const unsigned int data_size = data.size();
+
+    file.write(PVS_FILE_MAGIC, sizeof(PVS_FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&grid_min), sizeof(grid_min));
+    file.write(reinterpret_cast<const char*>(&cell_size), sizeof(cell_size));
+    file.write(reinterpret_cast<const char*>(&cell_counts), sizeof(cell_counts));
+    file.write(reinterpret_cast<const char*>(&object_count), sizeof(object_count));
+    file.write(reinterpret_cast<const char*>(&data_size), sizeof(data_size));
+    file.write(reinterpret_cast<const char*>(cell_offsets.data()), cell_offsets.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    if(!file) { throw std::runtime_error("Couldn't write PVS file '" + path.string() + '\''); }
+}
+
+void PVS::load(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) { throw std::runtime_error("Couldn't open file '" + path.string() + '\''); }
+
+    char magic[sizeof(PVS_FILE_MAGIC)];
+    unsigned int data_size;
+
+    file.read(magic, sizeof(magic));
+    if(!file || !std::equal(magic, magic + sizeof(magic), PVS_FILE_MAGIC)) {
+        throw std::runtime_error("Format error in PVS file '" + path.string() + "', wrong magic number.");
+    }
+
+    file.read(reinterpret_cast<char*>(&grid_min), sizeof(grid_min));
+    file.read(reinterpret_cast<char*>(&cell_size), sizeof(cell_size));
+    file.read(reinterpret_cast<char*>(&cell_counts), sizeof(cell_counts));
+    file.read(reinterpret_cast<char*>(&object_count), sizeof(object_count));
+    file.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
+
+    cell_offsets.resize(file ? get_cell_count() + 1 : 0);
+    data.resize(file ? data_size : 0);
+    file.read(reinterpret_cast<char*>(cell_offsets.data()), cell_offsets.size() * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    cached_cell = -1;
+
+    if(!file || cell_offsets.back() != data_size || !std::is_sorted(cell_offsets.begin(), cell_offsets.end())) {
+        cell_counts = uvec3(0);
+        cell_offsets.clear();
+        data.clear();
+        throw std::runtime_error("Format error in PVS file '" + path.string() + "', truncated or invalid data.");
+    }
+}
+
+bool PVS::is_empty() const {
+    return get_cell_count() == 0;
+}
+
+unsigned int PVS::get_object_count() const {
+    return object_count;
+}
+
+unsigned int PVS::get_cell_count() const {
+    return cell_counts.x * cell_counts.y * cell_counts.z;
+}
+
+std::size_t PVS::get_compressed_size() const {
+    return data.size();
+}
+
+const std::vector<uint64_t>* PVS::find_visible_objects(const vec3& position) const {
+    if(is_empty()) { return nullptr; }
+
+    int coordinates[3];
+    for(int axis = 0 ; axis < 3 ; ++axis) {
+        const float coordinate = std::floor((position[axis] - grid_min[axis]) / cell_size[axis]);
+        if(!(coordinate >= 0.0f && coordinate < static_cast<float>(cell_counts[axis]))) { return nullptr; }
+        coordinates[axis] = static_cast<int>(coordinate);
+    }
+
+    const int cell = coordinates[0] + static_cast<int>(cell_counts.x) * (coordinates[1] + static_cast<int>(cell_counts.y)
+                                                                          * coordinates[2]);
+    if(cell == cached_cell) { return &cached_visible_objects; }
+
+    // Decompresses the cell's set into words
+    cached_visible_objects.assign((object_count + 63) / 64, 0);
+    unsigned int byte = 0;
+
+    for(unsigned int i = cell_offsets[cell] ; i < cell_offsets[cell + 1] ; ++i) {
+        if(data[i] == 0) {
+            byte += i + 1 < cell_offsets[cell + 1] ? data[++i] : 0;
+        } else {
+            if(byte / 8 < cached_visible_objects.size()) {
+                cached_visible_objects[byte / 8] |= static_cast<uint64_t>(data[i]) << byte % 8 * 8;
+            }
+            ++byte;
+        }
+    }
+
+    cached_cell = cell;
+    return &cached_visible_objects;
+}
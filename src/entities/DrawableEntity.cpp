@@ -7,45 +7,172 @@
 
 #include "AssetManager.hpp"
 #include "debug.hpp"
+#include "maths/geometry.hpp"
 
 DrawableEntity::DrawableEntity(const std::string& name, const Shader& shader)
-    : Entity(name), shader(shader), aabb(nullptr) { }
+    : Entity(name), shader(shader), aabb(nullptr), last_failed_frustum_plane(0),
+      bvh(nullptr), bvh_leaf(BVH_NULL_NODE), aabb_arrays(nullptr), aabb_arrays_index(AABB_ARRAYS_NULL_INDEX),
+      is_baked(false) { }
 
 DrawableEntity::~DrawableEntity() {
-    delete aabb;
+    detach_from_culling_structures();
 }
 
-void DrawableEntity::draw(const mat4& view_projection_matrix, const Frustum& frustum) const {
-    total_drawable_entities++;
+void DrawableEntity::enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                             const OcclusionCuller* occlusion_culler) const {
+    statistics.drawable_entities++;
 
     if(is_visible) {
-        total_not_hidden_entities++;
+        statistics.not_hidden_entities++;
 
-        if(aabb == nullptr || aabb->is_in_frustum(frustum.view_projection * transform.get_global_model())) {
-            total_drawn_entities++;
-            draw(view_projection_matrix);
+        // Entities in a BVH are drawn by querying it and baked ones by their merged mesh
+        if(bvh == nullptr && !is_baked
+           && (aabb == nullptr || (world_bounds.is_in_frustum(frustum, last_failed_frustum_plane)
+                                   && world_bounds.get_screen_size(view_projection_matrix) >= SMALL_FEATURE_SCREEN_SIZE))) {
+            if(aabb != nullptr && occlusion_culler != nullptr && !occlusion_culler->is_visible(world_bounds)) {
+                statistics.occluded_entities++;
+            } else {
+                statistics.drawn_entities++;
+                enqueue_visible(render_queue, view_projection_matrix, frustum);
+            }
+        }
+    }
+
+    enqueue_children(render_queue, view_projection_matrix, frustum, occlusion_culler);
+}
+
+void DrawableEntity::enqueue_visible(RenderQueue& render_queue, const mat4&, const Frustum& frustum) const {
+    render_queue.push(RenderQueue::make_key(RENDER_PASS_OPAQUE, shader.get_id(), 0, 0, 0,
+                                            get_camera_distance(frustum.position)),
+                      this);
+}
 
+void DrawableEntity::draw_packet(const DrawPacket&, const mat4& view_projection_matrix, const Frustum&) const {
+    draw(view_projection_matrix);
+    draw_bounding_box(view_projection_matrix);
+}
+
+void DrawableEntity::draw_bounding_box([[maybe_unused]] const mat4& view_projection_matrix) const {
 #ifdef DEBUG_SHOW_BOUNDING_BOXES
-            if(aabb != nullptr) {
-                const Shader& bounding_volume_shader = AssetManager::get_shader("flat");
-                bounding_volume_shader.use();
-                bounding_volume_shader.set_uniform("u_mvp", view_projection_matrix
-                                                            * aabb->get_global_model_matrix(transform));
-                bounding_volume_shader.set_uniform("u_color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
-                glLineWidth(3.0f);
-                AssetManager::get_mesh("wireframe cube").draw();
-                glLineWidth(1.0f);
-            }
+    if(aabb != nullptr) {
+        const Shader& bounding_volume_shader = AssetManager::get_shader("flat");
+        bounding_volume_shader.use();
+        bounding_volume_shader.set_uniform("u_mvp", view_projection_matrix * world_bounds.get_model_matrix());
+        bounding_volume_shader.set_uniform("u_color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        glLineWidth(3.0f);
+        AssetManager::get_mesh("wireframe cube").draw();
+        glLineWidth(1.0f);
+    }
 #endif
-        }
+}
+
+float DrawableEntity::get_camera_distance(const vec3& camera_position) const {
+    return length((aabb == nullptr ? transform.get_global_position() : world_bounds.center) - camera_position);
+}
+
+void DrawableEntity::add_to_subtree_aggregate(SubtreeAggregate& aggregate) const {
+    aggregate.drawable_count++;
+    if(!is_visible) { return; }
+
+    aggregate.not_hidden_count++;
+
+    // Entities in a BVH are drawn by querying it and baked ones by their merged mesh
+    if(bvh != nullptr || is_baked) { return; }
+
+    if(aabb == nullptr) {
+        aggregate.is_bounded = false;
+    } else {
+        aggregate.add_bounds(world_bounds);
     }
+}
+
+void DrawableEntity::update_world_bounds() {
+    if(aabb == nullptr) { return; }
+
+    world_bounds = aabb->transformed(transform.get_global_affine_model());
+    if(bvh == nullptr) {
+        invalidate_subtree_aggregate();
+    } else if(bvh_leaf != BVH_NULL_NODE) {
+        bvh->update(bvh_leaf, world_bounds);
+    }
+    if(aabb_arrays != nullptr && aabb_arrays_index != AABB_ARRAYS_NULL_INDEX) {
+        aabb_arrays->set(aabb_arrays_index, world_bounds);
+    }
+}
+
+void DrawableEntity::insert_in_bvh(BVH& bvh) {
+    if(aabb == nullptr || is_baked) { return; }
+    if(this->bvh != nullptr && bvh_leaf != BVH_NULL_NODE) { this->bvh->remove(bvh_leaf); }
 
-    for(Entity* child : children) { child->draw(view_projection_matrix, frustum); }
+    this->bvh = &bvh;
+    bvh_leaf = get_visibility() ? bvh.insert(this, world_bounds) : BVH_NULL_NODE;
+    invalidate_subtree_aggregate();
+}
+
+bool DrawableEntity::is_in_bvh() const {
+    return bvh != nullptr;
+}
+
+void DrawableEntity::insert_in_aabb_arrays(AABBArrays& aabb_arrays) {
+    if(aabb == nullptr || is_baked) { return; }
+    if(this->aabb_arrays != nullptr && aabb_arrays_index != AABB_ARRAYS_NULL_INDEX) {
+        this->aabb_arrays->remove(aabb_arrays_index);
+    }
+
+    this->aabb_arrays = &aabb_arrays;
+    aabb_arrays_index = get_visibility() ? aabb_arrays.add(this, world_bounds) : AABB_ARRAYS_NULL_INDEX;
+}
+
+void DrawableEntity::remove_from_culling_structures() {
+    detach_from_culling_structures();
+    if(bvh != nullptr) { invalidate_subtree_aggregate(); }
+
+    bvh = nullptr;
+    aabb_arrays = nullptr;
+}
+
+void DrawableEntity::bake() {
+    remove_from_culling_structures();
+    is_baked = true;
+    invalidate_subtree_aggregate();
+}
+
+unsigned int DrawableEntity::get_occluder_triangle_count() const {
+    return 0;
+}
+
+void DrawableEntity::rasterize_occluder(OcclusionCuller&) const { }
+
+void DrawableEntity::on_visibility_changed(bool is_drawn) {
+    if(is_drawn) {
+        attach_to_culling_structures();
+    } else {
+        detach_from_culling_structures();
+    }
+}
+
+void DrawableEntity::attach_to_culling_structures() {
+    if(bvh != nullptr && bvh_leaf == BVH_NULL_NODE) { bvh_leaf = bvh->insert(this, world_bounds); }
+    if(aabb_arrays != nullptr && aabb_arrays_index == AABB_ARRAYS_NULL_INDEX) {
+        aabb_arrays_index = aabb_arrays->add(this, world_bounds);
+    }
+}
+
+void DrawableEntity::detach_from_culling_structures() {
+    if(bvh != nullptr && bvh_leaf != BVH_NULL_NODE) {
+        bvh->remove(bvh_leaf);
+        bvh_leaf = BVH_NULL_NODE;
+    }
+
+    if(aabb_arrays != nullptr && aabb_arrays_index != AABB_ARRAYS_NULL_INDEX) {
+        aabb_arrays->remove(aabb_arrays_index);
+        aabb_arrays_index = AABB_ARRAYS_NULL_INDEX;
+    }
 }
 
 void DrawableEntity::update_uniforms(const mat4& view_projection_matrix) const {
-    const mat4& global_model = transform.get_global_model_const_reference();
-    shader.set_uniform_if_exists("u_model", global_model);
+    const affine3x4& global_model = transform.get_global_affine_model();
+    shader.set_uniform_if_exists("u_model", global_model.get_matrix());
 
     int u_mvp_location = shader.get_uniform_location("u_mvp");
     if(u_mvp_location != -1) {
@@ -54,6 +181,6 @@ void DrawableEntity::update_uniforms(const mat4& view_projection_matrix) const {
 
     int u_normals_model_matrix_location = shader.get_uniform_location("u_normals_model_matrix");
     if(u_normals_model_matrix_location != -1) {
-        Shader::set_uniform(u_normals_model_matrix_location, transpose_inverse(global_model));
+        Shader::set_uniform(u_normals_model_matrix_location, transform.get_normal_matrix());
     }
 }
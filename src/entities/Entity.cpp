@@ -11,54 +11,119 @@
 #include "entities/DrawableEntity.hpp"
 #include "imgui.h"
 
-Entity::Entity(const std::string& name) : name(name), parent(nullptr), is_visible(true) { }
-
-Entity::~Entity() {
-    for(const Entity* child : children) { delete child; }
-}
+Entity::Entity(const std::string& name)
+    : name(name), parent(nullptr), arena(nullptr), is_visible(true), is_subtree_aggregate_dirty(true), last_failed_subtree_plane(0) { }
 
 void Entity::set_visibility(bool is_visible) {
+    if(this->is_visible == is_visible) { return; }
+
     this->is_visible = is_visible;
-    for(Entity* child : children) { child->set_visibility(is_visible); }
+    invalidate_subtree_aggregate();
+
+    // The subtree of a hidden parent stays hidden
+    if(parent == nullptr || parent->get_visibility()) { propagate_visibility_change(is_visible); }
 }
 
 bool Entity::get_visibility() const {
+    for(const Entity* entity = this ; entity != nullptr ; entity = entity->parent) {
+        if(!entity->is_visible) { return false; }
+    }
+
+    return true;
+}
+
+bool Entity::get_local_visibility() const {
     return is_visible;
 }
 
 void Entity::toggle_visibility() {
-    is_visible = !is_visible;
-    for(Entity* child : children) { child->set_visibility(is_visible); }
+    set_visibility(!is_visible);
 }
 
-void Entity::update_transform_and_children() {
-    if(transform.is_local_model_dirty()) {
-        force_update_transform_and_children();
-    } else {
-        for(Entity* child : children) { child->update_transform_and_children(); }
+void Entity::on_visibility_changed(bool) { }
+
+void Entity::propagate_visibility_change(bool is_drawn) {
+    on_visibility_changed(is_drawn);
+
+    for(Entity* child : children) {
+        if(child->is_visible) { child->propagate_visibility_change(is_drawn); }
     }
 }
 
-void Entity::force_update_transform_and_children() {
-    if(parent != nullptr) {
-        transform.update_global_model(parent->transform.get_global_model());
-    } else {
-        transform.update_global_model();
+void Entity::invalidate_subtree_aggregate() {
+    // The ancestors of a dirty entity are already dirty
+    for(Entity* entity = this ; entity != nullptr && !entity->is_subtree_aggregate_dirty ; entity = entity->parent) {
+        entity->is_subtree_aggregate_dirty = true;
     }
+}
+
+const SubtreeAggregate& Entity::get_subtree_aggregate() const {
+    if(!is_subtree_aggregate_dirty) { return subtree_aggregate; }
 
-    for(Entity* child : children) { child->force_update_transform_and_children(); }
+    SubtreeAggregate aggregate;
+    add_to_subtree_aggregate(aggregate);
+
+    for(const Entity* child : children) {
+        const SubtreeAggregate& child_aggregate = child->get_subtree_aggregate();
+        aggregate.drawable_count += child_aggregate.drawable_count;
+
+        // Nothing is drawn below a hidden entity
+        if(!is_visible) { continue; }
+
+        aggregate.not_hidden_count += child_aggregate.not_hidden_count;
+        aggregate.is_bounded = aggregate.is_bounded && child_aggregate.is_bounded;
+        if(child_aggregate.has_bounds) { aggregate.add_bounds(child_aggregate.bounds); }
+    }
+
+    subtree_aggregate = aggregate;
+    is_subtree_aggregate_dirty = false;
+    return subtree_aggregate;
+}
+
+void Entity::add_to_subtree_aggregate(SubtreeAggregate&) const { }
+
+void Entity::update_world_bounds() { }
+
+void Entity::on_global_model_updated() {
+    update_world_bounds();
 }
 
-void Entity::draw(const mat4& view_projection_matrix, const Frustum& frustum) const {
-    for(Entity* child : children) { child->draw(view_projection_matrix, frustum); }
+void Entity::enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                     const OcclusionCuller* occlusion_culler) const {
+    enqueue_children(render_queue, view_projection_matrix, frustum, occlusion_culler);
 }
 
+void Entity::enqueue_children(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                              const OcclusionCuller* occlusion_culler) const {
+    for(const Entity* child : children) {
+        const SubtreeAggregate& aggregate = child->get_subtree_aggregate();
+
+        // Hidden subtrees are bounded and empty so they're skipped too
+        if(aggregate.is_bounded
+           && (!aggregate.has_bounds || !aggregate.bounds.is_in_frustum(frustum, child->last_failed_subtree_plane))) {
+            DrawableEntity::statistics.drawable_entities += aggregate.drawable_count;
+            DrawableEntity::statistics.not_hidden_entities += aggregate.not_hidden_count;
+            continue;
+        }
+
+        child->enqueue(render_queue, view_projection_matrix, frustum, occlusion_culler);
+    }
+}
+
+void Entity::draw_packet(const DrawPacket&, const mat4&, const Frustum&) const { }
+
+unsigned int Entity::add_to_batch(const DrawPacket*, unsigned int, std::vector<InstanceData>&,
+                                  std::vector<DrawElementsIndirectCommand>&) const {
+    return 0;
+}
+
+void Entity::draw_batch(const DrawPacket*, unsigned int, unsigned int, unsigned int, const mat4&) const { }
+
 void Entity::add_to_object_editor() {
     ImGui::Text("Selected Entity: '%s'", name.c_str());
 
-    if(ImGui::Checkbox("Is Object Visible", &is_visible)) {
-        for(Entity* child : children) { child->set_visibility(is_visible); }
-    }
+    bool is_checked = is_visible;
+    if(ImGui::Checkbox("Is Object Visible", &is_checked)) { set_visibility(is_checked); }
 
     bool is_dirty = ImGui::DragFloat3("Local Position", &transform.get_local_position_reference().x);
 
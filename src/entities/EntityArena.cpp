@@ -0,0 +1,67 @@
+/***************************************************************************************************
+ * @file  EntityArena.cpp
+ * @brief Implementation of the EntityArena class
+ **************************************************************************************************/
+
+#include "entities/EntityArena.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief The amount of entities that fit in the first block of a type.
+ */
+static constexpr unsigned int ENTITY_ARENA_FIRST_BLOCK_CAPACITY = 16;
+
+/**
+ * @brief The maximum amount of entities that fit in a block.
+ */
+static constexpr unsigned int ENTITY_ARENA_MAX_BLOCK_CAPACITY = 4096;
+
+EntityArena::EntityArena()
+    : entity_count(0) { }
+
+EntityArena::~EntityArena() {
+    for(Pool& pool : pools) {
+        for(Block& block : pool.blocks) {
+            for(unsigned int i = 0 ; i < block.count ; ++i) { pool.destroy(block.memory + i * pool.size); }
+            ::operator delete(block.memory, std::align_val_t(pool.alignment));
+        }
+    }
+}
+
+unsigned int EntityArena::size() const {
+    return entity_count;
+}
+
+unsigned int EntityArena::get_block_count() const {
+    unsigned int block_count = 0;
+    for(const Pool& pool : pools) { block_count += pool.blocks.size(); }
+    return block_count;
+}
+
+unsigned int EntityArena::find_pool(std::type_index type, std::size_t size, std::size_t alignment,
+                                    void (*destroy)(void*)) {
+    // There are only a few types of entities so a linear search is enough
+    for(unsigned int i = 0 ; i < pools.size() ; ++i) {
+        if(pools[i].type == type) { return i; }
+    }
+
+    pools.emplace_back(type, size, alignment, destroy);
+    return pools.size() - 1;
+}
+
+void* EntityArena::get_free_slot(unsigned int pool_index) {
+    Pool& pool = pools[pool_index];
+
+    if(pool.blocks.empty() || pool.blocks.back().count == pool.blocks.back().capacity) {
+        const unsigned int capacity = pool.blocks.empty()
+                                          ? ENTITY_ARENA_FIRST_BLOCK_CAPACITY
+                                          : std::min(2 * pool.blocks.back().capacity, ENTITY_ARENA_MAX_BLOCK_CAPACITY);
+
+        std::byte* memory = static_cast<std::byte*>(::operator new(capacity * pool.size, std::align_val_t(pool.alignment)));
+        pool.blocks.emplace_back(memory, capacity, 0);
+    }
+
+    Block& block = pool.blocks.back();
+    return block.memory + block.count * pool.size;
+}
@@ -18,6 +18,25 @@ void FlatShadedMeshEntity::update_uniforms(const mat4& view_projection_matrix) c
     shader.set_uniform_if_exists("u_color", color);
 }
 
+bool FlatShadedMeshEntity::has_transparency() const {
+    return color.w < 1.0f || MeshEntity::has_transparency();
+}
+
+vec4 FlatShadedMeshEntity::get_instance_color() const {
+    return color;
+}
+
+bool FlatShadedMeshEntity::can_be_merged_with(const MeshEntity& other) const {
+    // Entities of the same type are flat shaded mesh entities too
+    return MeshEntity::can_be_merged_with(other) && static_cast<const FlatShadedMeshEntity&>(other).color == color;
+}
+
+MeshEntity* FlatShadedMeshEntity::add_merged_child(Entity& parent, const std::string& name, Mesh& merged_mesh) const {
+    MeshEntity* child = parent.add_child<FlatShadedMeshEntity>(name, shader, merged_mesh, color);
+    child->material = material;
+    return child;
+}
+
 void FlatShadedMeshEntity::add_to_object_editor() {
     MeshEntity::add_to_object_editor();
     ImGui::ColorEdit4("Object color", &color.x);
@@ -5,15 +5,124 @@
 
 #include "entities/MeshEntity.hpp"
 
+#include "AssetManager.hpp"
+#include "debug.hpp"
 #include "imgui.h"
 
 MeshEntity::MeshEntity(const std::string& name, const Shader& shader, Mesh& mesh)
-    : DrawableEntity(name, shader), mesh(mesh), material(nullptr) { }
+    : DrawableEntity(name, shader), mesh(mesh), material(nullptr),
+      instanced_shader(AssetManager::get_instanced_shader_ptr(shader)) { }
 
 void MeshEntity::draw(const mat4& view_projection_matrix) const {
     shader.use();
     update_uniforms(view_projection_matrix);
-    mesh.draw();
+    mesh.draw(aabb == nullptr ? 0 : mesh.select_lod(world_bounds.get_screen_size(view_projection_matrix)));
+}
+
+void MeshEntity::enqueue_visible(RenderQueue& render_queue, const mat4& view_projection_matrix,
+                                 const Frustum& frustum) const {
+    const unsigned int texture = material == nullptr ? 0 : material->diffuse_map.get_id();
+    const uint64_t key = RenderQueue::make_key(has_transparency() ? RENDER_PASS_TRANSPARENT : RENDER_PASS_OPAQUE,
+                                               shader.get_id(), texture, RenderQueue::get_material_id(material),
+                                               mesh.get_sort_id(), get_camera_distance(frustum.position));
+
+    render_queue.push(key, this, 0,
+                      aabb == nullptr ? 0 : mesh.select_lod(world_bounds.get_screen_size(view_projection_matrix)),
+                      instanced_shader != nullptr);
+}
+
+void MeshEntity::draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum&) const {
+    shader.use();
+    update_uniforms(view_projection_matrix);
+    mesh.draw(packet.lod);
+    draw_bounding_box(view_projection_matrix);
+}
+
+unsigned int MeshEntity::add_to_batch(const DrawPacket* packets, unsigned int count,
+                                      std::vector<InstanceData>& instances,
+                                      std::vector<DrawElementsIndirectCommand>& commands) const {
+    // Indirect commands can only draw indexed meshes
+    if(mesh.get_indices().empty() || mesh.get_buffer() == nullptr) { return 0; }
+
+    unsigned int packet_count = 0;
+    const Mesh* previous_mesh = nullptr;
+
+    for( ; packet_count < count ; ++packet_count) {
+        const DrawPacket& packet = packets[packet_count];
+
+        // Only mesh entities add packets that can be batched
+        const MeshEntity* entity = static_cast<const MeshEntity*>(packet.entity);
+        if(&entity->shader != &shader || entity->material != material
+           || entity->mesh.get_buffer() != mesh.get_buffer() || entity->mesh.get_primitive() != mesh.get_primitive()
+           || entity->mesh.get_indices().empty()) {
+            break;
+        }
+
+        if(&entity->mesh == previous_mesh && packet.lod == packets[packet_count - 1].lod) {
+            ++commands.back().instance_count;
+        } else {
+            commands.push_back(entity->mesh.get_draw_command(packet.lod, 1, instances.size()));
+        }
+        previous_mesh = &entity->mesh;
+
+        InstanceData& instance = instances.emplace_back();
+        instance.model = entity->transform.get_global_affine_model().get_matrix();
+
+        const mat3& normal_matrix = entity->transform.get_normal_matrix();
+        for(int column = 0 ; column < 3 ; ++column) {
+            instance.normal_matrix[column] = vec4(normal_matrix(0, column), normal_matrix(1, column),
+                                                  normal_matrix(2, column), 0.0f);
+        }
+
+        instance.color = entity->get_instance_color();
+    }
+
+    return packet_count;
+}
+
+void MeshEntity::draw_batch([[maybe_unused]] const DrawPacket* packets, [[maybe_unused]] unsigned int packet_count,
+                            unsigned int first_command, unsigned int command_count,
+                            const mat4& view_projection_matrix) const {
+    instanced_shader->use();
+    instanced_shader->set_uniform("u_view_projection", view_projection_matrix);
+    if(material != nullptr) { material->update_shader_uniforms(*instanced_shader); }
+
+    mesh.draw_indirect(first_command, command_count);
+
+#ifdef DEBUG_SHOW_BOUNDING_BOXES
+    for(unsigned int i = 0 ; i < packet_count ; ++i) {
+        static_cast<const MeshEntity*>(packets[i].entity)->draw_bounding_box(view_projection_matrix);
+    }
+#endif
+}
+
+bool MeshEntity::has_transparency() const {
+    return material != nullptr && material->has_transparency();
+}
+
+vec4 MeshEntity::get_instance_color() const {
+    return vec4(1.0f);
+}
+
+bool MeshEntity::can_be_merged_with(const MeshEntity& other) const {
+    if(get_type() != other.get_type() || &shader != &other.shader || material != other.material
+       || mesh.get_primitive() != other.mesh.get_primitive()) {
+        return false;
+    }
+
+    for(unsigned int attribute = 0 ; attribute < ATTRIBUTE_AMOUNT ; ++attribute) {
+        if(mesh.get_attribute_type(Attribute(attribute)) != other.mesh.get_attribute_type(Attribute(attribute))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+MeshEntity* MeshEntity::add_merged_child(Entity& parent, const std::string& name, Mesh& merged_mesh) const {
+    MeshEntity* child = parent.add_child<MeshEntity>(name, shader, merged_mesh);
+    child->material = material;
+    return child;
 }
 
 void MeshEntity::update_uniforms(const mat4& view_projection_matrix) const {
@@ -36,8 +145,14 @@ void MeshEntity::add_to_object_editor() {
 }
 
 void MeshEntity::create_aabb() {
-    vec3 min(std::numeric_limits<float>::max());
-    vec3 max(std::numeric_limits<float>::lowest());
-    mesh.get_min_max_axis_aligned_coordinates(min, max);
-    aabb = new AABB(min, max);
+    aabb = &mesh.get_bounds();
+    update_world_bounds();
+}
+
+unsigned int MeshEntity::get_occluder_triangle_count() const {
+    return mesh.get_triangle_count();
+}
+
+void MeshEntity::rasterize_occluder(OcclusionCuller& occlusion_culler) const {
+    occlusion_culler.rasterize_mesh(transform.get_global_affine_model(), mesh);
 }
@@ -15,7 +15,37 @@ ModelEntity::ModelEntity(const std::string& name, const Shader& shader, Model& m
 void ModelEntity::draw(const mat4& view_projection_matrix) const {
     shader.use();
     update_uniforms(view_projection_matrix);
-    model.draw(shader);
+    if(aabb == nullptr) {
+        model.draw(shader);
+    } else {
+        model.draw(shader, world_bounds.get_screen_size(view_projection_matrix));
+    }
+}
+
+void ModelEntity::enqueue_visible(RenderQueue& render_queue, const mat4& view_projection_matrix,
+                                  const Frustum& frustum) const {
+    const float screen_size = aabb == nullptr ? std::numeric_limits<float>::infinity()
+                                              : world_bounds.get_screen_size(view_projection_matrix);
+    const float camera_distance = get_camera_distance(frustum.position);
+
+    for(unsigned int i = 0 ; i < model.meshes.size() ; ++i) {
+        const Material& material = model.materials[i];
+        const RenderPass pass = material.has_transparency() ? RENDER_PASS_TRANSPARENT : RENDER_PASS_OPAQUE;
+        const uint64_t key = RenderQueue::make_key(pass, shader.get_id(), material.diffuse_map.get_id(),
+                                                   RenderQueue::get_material_id(&material),
+                                                   model.meshes[i].get_sort_id(), camera_distance);
+        render_queue.push(key, this, i, model.select_lod(i, screen_size));
+    }
+}
+
+void ModelEntity::draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum&) const {
+    shader.use();
+    update_uniforms(view_projection_matrix);
+    model.materials[packet.index].update_shader_uniforms(shader);
+    model.meshes[packet.index].draw(packet.lod);
+
+    // The bounds are those of the whole model so they're only drawn once
+    if(packet.index == 0) { draw_bounding_box(view_projection_matrix); }
 }
 
 void ModelEntity::add_to_object_editor() {
@@ -42,8 +72,18 @@ void ModelEntity::add_to_object_editor() {
 }
 
 void ModelEntity::create_aabb() {
-    vec3 min(std::numeric_limits<float>::max());
-    vec3 max(std::numeric_limits<float>::lowest());
-    model.get_min_max_axis_aligned_coordinates(min, max);
-    aabb = new AABB(min, max);
+    aabb = &model.get_bounds();
+    update_world_bounds();
+}
+
+unsigned int ModelEntity::get_occluder_triangle_count() const {
+    unsigned int triangle_count = 0;
+    for(const Mesh& mesh : model.meshes) { triangle_count += mesh.get_triangle_count(); }
+    return triangle_count;
+}
+
+void ModelEntity::rasterize_occluder(OcclusionCuller& occlusion_culler) const {
+    for(const Mesh& mesh : model.meshes) {
+        occlusion_culler.rasterize_mesh(transform.get_global_affine_model(), mesh);
+    }
 }
@@ -5,14 +5,65 @@
 
 #include "entities/SceneEntity.hpp"
 
+#include "imgui.h"
+
 SceneEntity::SceneEntity(const std::string& name, const std::filesystem::path& path)
     : Entity(name), scene(path) { }
 
-void SceneEntity::draw(const mat4& view_projection_matrix, const Frustum& frustum) const {
-    if(is_visible) { draw(view_projection_matrix); }
-    for(Entity* child : children) { child->draw(view_projection_matrix, frustum); }
+void SceneEntity::enqueue(RenderQueue& render_queue, const mat4& view_projection_matrix, const Frustum& frustum,
+                          const OcclusionCuller* occlusion_culler) const {
+    DrawStatistics& statistics = DrawableEntity::statistics;
+    statistics.drawable_entities += scene.get_primitive_count();
+
+    if(is_visible) {
+        statistics.not_hidden_entities += scene.get_primitive_count();
+        statistics.drawn_entities += scene.enqueue(render_queue, this, view_projection_matrix, transform, frustum,
+                                                   occlusion_culler);
+        statistics.pvs_culled_entities += scene.get_pvs_culled_primitive_count();
+        statistics.occluded_entities += scene.get_occluded_primitive_count();
+    }
+
+    enqueue_children(render_queue, view_projection_matrix, frustum, occlusion_culler);
+}
+
+unsigned int SceneEntity::rasterize_occluders(OcclusionCuller& occlusion_culler, const Frustum& frustum) const {
+    if(!is_visible) { return 0; }
+    return scene.rasterize_occluders(occlusion_culler, transform, frustum);
+}
+
+void SceneEntity::draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Frustum& frustum) const {
+    DrawableEntity::statistics.culled_meshlet_triangles += scene.draw_packet(packet, view_projection_matrix, transform,
+                                                                             frustum);
 }
 
 void SceneEntity::draw(const mat4& view_projection_matrix) const {
     scene.draw(view_projection_matrix, transform);
 }
+
+void SceneEntity::update_world_bounds() {
+    world_bounds = scene.get_bounds().transformed(transform.get_global_affine_model());
+    invalidate_subtree_aggregate();
+}
+
+void SceneEntity::add_to_subtree_aggregate(SubtreeAggregate& aggregate) const {
+    aggregate.drawable_count += scene.get_primitive_count();
+    if(!is_visible || scene.get_primitive_count() == 0) { return; }
+
+    aggregate.not_hidden_count += scene.get_primitive_count();
+    aggregate.add_bounds(world_bounds);
+}
+
+void SceneEntity::add_to_object_editor() {
+    Entity::add_to_object_editor();
+
+    const PVS& pvs = scene.get_pvs();
+    if(pvs.is_empty()) {
+        ImGui::Text("No PVS");
+    } else {
+        ImGui::Text("PVS: %u cells, %zu bytes", pvs.get_cell_count(), pvs.get_compressed_size());
+        ImGui::Checkbox("Use PVS", &scene.is_pvs_enabled);
+    }
+
+    // Baking takes a while, it only needs to be done again when the scene changes
+    if(ImGui::Button("Bake PVS")) { scene.bake_pvs(); }
+}
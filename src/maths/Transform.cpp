@@ -8,100 +8,123 @@
 #include "maths/geometry.hpp"
 
 Transform::Transform()
-    : local_position(0.0f),
-      local_orientation(0.0f, 0.0f, 0.0f, 1.0f),
-      local_scale(1.0f),
-      is_dirty(true),
-      global_model(1.0f) { }
+    : system(nullptr), index(0) { }
+
+Transform::~Transform() {
+    if(system != nullptr) { system->remove(index); }
+}
+
+void Transform::attach(TransformSystem& system, TransformOwner* owner) {
+    this->system = &system;
+    index = system.add(this, owner, TRANSFORM_NULL_INDEX);
+}
+
+void Transform::attach(TransformOwner* owner, const Transform& parent) {
+    system = parent.system;
+    index = system->add(this, owner, parent.index);
+}
 
 void Transform::set_local_position(const vec3& position) {
-    local_position = position;
-    is_dirty = true;
+    system->local_positions[index] = position;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_position(float x, float y, float z) {
+    vec3& local_position = system->local_positions[index];
     local_position.x = x;
     local_position.y = y;
     local_position.z = z;
-    is_dirty = true;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_orientation(const quaternion& orientation) {
-    local_orientation = orientation;
-    is_dirty = true;
+    system->local_orientations[index] = orientation;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_orientation_euler(const vec3& angles) {
-    local_orientation = euler_to_quaternion(angles);
-    is_dirty = true;
+    system->local_orientations[index] = euler_to_quaternion(angles);
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_orientation(float x, float y, float z, float w) {
+    quaternion& local_orientation = system->local_orientations[index];
     local_orientation.x = x;
     local_orientation.y = y;
     local_orientation.z = z;
     local_orientation.w = w;
-    is_dirty = true;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_scale(const vec3& scale) {
-    local_scale = scale;
-    is_dirty = true;
+    system->local_scales[index] = scale;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_scale(float scale) {
+    vec3& local_scale = system->local_scales[index];
     local_scale.x = local_scale.y = local_scale.z = scale;
-    is_dirty = true;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_scale(float x, float y, float z) {
+    vec3& local_scale = system->local_scales[index];
     local_scale.x = x;
     local_scale.y = y;
     local_scale.z = z;
-    is_dirty = true;
+    system->mark_dirty(index);
 }
 
 void Transform::set_local_model_to_dirty() {
-    is_dirty = true;
+    system->mark_dirty(index);
 }
 
 vec3 Transform::get_local_position() const {
-    return local_position;
+    return system->local_positions[index];
 }
 
 vec3& Transform::get_local_position_reference() {
-    return local_position;
+    return system->local_positions[index];
 }
 
 quaternion Transform::get_local_orientation() const {
-    return local_orientation;
+    return system->local_orientations[index];
 }
 
 quaternion& Transform::get_local_orientation_reference() {
-    return local_orientation;
+    return system->local_orientations[index];
 }
 
 vec3 Transform::get_local_scale() const {
-    return local_scale;
+    return system->local_scales[index];
 }
 
 vec3& Transform::get_local_scale_reference() {
-    return local_scale;
+    return system->local_scales[index];
+}
+
+affine3x4 Transform::compute_local_model() const {
+    return TRS_affine(get_local_position(), get_local_orientation(), get_local_scale());
 }
 
-mat4 Transform::compute_local_model() const {
-    return TRS_matrix(local_position, local_orientation, local_scale);
+mat3 Transform::compute_local_normal_matrix() const {
+    return TRS_normal_matrix(get_local_orientation(), get_local_scale());
 }
 
 mat4 Transform::get_global_model() const {
-    return global_model;
+    return system->global_models[index].get_matrix();
+}
+
+const affine3x4& Transform::get_global_affine_model() const {
+    return system->global_models[index];
 }
 
-const mat4& Transform::get_global_model_const_reference() const {
-    return global_model;
+const mat3& Transform::get_normal_matrix() const {
+    return system->normal_matrices[index];
 }
 
 vec3 Transform::get_global_position() const {
+    const affine3x4& global_model = system->global_models[index];
     return vec3(global_model(0, 3), global_model(1, 3), global_model(2, 3));
 }
 
@@ -110,27 +133,20 @@ vec3 Transform::get_global_scale() const {
 }
 
 vec3 Transform::get_front_vector() const {
+    const affine3x4& global_model = system->global_models[index];
     return vec3(-global_model(0, 2), -global_model(1, 2), -global_model(2, 2));
 }
 
 vec3 Transform::get_right_vector() const {
+    const affine3x4& global_model = system->global_models[index];
     return vec3(global_model(0, 0), global_model(1, 0), global_model(2, 0));
 }
 
 vec3 Transform::get_up_vector() const {
+    const affine3x4& global_model = system->global_models[index];
     return vec3(global_model(0, 1), global_model(1, 1), global_model(2, 1));
 }
 
 bool Transform::is_local_model_dirty() const {
-    return is_dirty;
-}
-
-void Transform::update_global_model() {
-    global_model = compute_local_model();
-    is_dirty = false;
-}
-
-void Transform::update_global_model(const mat4& parent_global_model) {
-    global_model = parent_global_model * compute_local_model();
-    is_dirty = false;
+    return system->dirty_flags[index];
 }
@@ -0,0 +1,338 @@
+/***************************************************************************************************
+ * @file  TransformSystem.cpp
+ * @brief Implementation of the TransformSystem class
+ **************************************************************************************************/
+
+#include "maths/TransformSystem.hpp"
+
+#include <algorithm>
+#include "maths/simd.hpp"
+#include "maths/Transform.hpp"
+
+/**
+ * @brief The maximum amount of transforms computed by a task, smaller subtrees being computed inline by
+ * the task containing them.
+ */
+static constexpr unsigned int TRANSFORM_TASK_SIZE = 1024;
+
+/**
+ * @brief The modified transforms are found by scanning every flag instead of sorting their list when
+ * more than one transform out of this amount was modified.
+ */
+static constexpr unsigned int TRANSFORM_DIRTY_SCAN_RATIO = 16;
+
+#ifdef MATHS_USE_SSE
+/**
+ * @brief Loads the same component of 4 elements of an array of structures of floats.
+ * @param array A pointer to the component of the first element of the array.
+ * @param stride The amount of floats in an element.
+ * @param indices The indices of the 4 elements.
+ */
+static inline __m128 gather_4(const float* array, std::size_t stride, const unsigned int* indices) {
+    return _mm_set_ps(array[indices[3] * stride], array[indices[2] * stride],
+                      array[indices[1] * stride], array[indices[0] * stride]);
+}
+#endif
+
+TransformSystem::TransformSystem()
+    : updated_count(0), is_sorted(true) { }
+
+unsigned int TransformSystem::add(Transform* transform, TransformOwner* owner, int parent) {
+    const unsigned int index = size();
+
+    local_positions.emplace_back(0.0f);
+    local_orientations.emplace_back(0.0f, 0.0f, 0.0f, 1.0f);
+    local_scales.emplace_back(1.0f);
+    local_models.emplace_back();
+    local_normal_matrices.emplace_back(1.0f);
+    global_models.emplace_back();
+    normal_matrices.emplace_back(1.0f);
+    parents.push_back(parent);
+    subtree_sizes.push_back(1);
+    transforms.push_back(transform);
+    owners.push_back(owner);
+    dirty_flags.push_back(true);
+    dirty_indices.push_back(index);
+
+    // The new transform extends the subtrees of its ancestors if the parent's subtree ends the arrays
+    if(is_sorted && parent != TRANSFORM_NULL_INDEX) {
+        if(parent + subtree_sizes[parent] == index) {
+            for(int ancestor = parent ; ancestor != TRANSFORM_NULL_INDEX ; ancestor = parents[ancestor]) {
+                ++subtree_sizes[ancestor];
+            }
+        } else {
+            is_sorted = false;
+        }
+    }
+
+    return index;
+}
+
+void TransformSystem::remove(unsigned int index) {
+    transforms[index] = nullptr;
+    dirty_flags[index] = false;
+    is_sorted = false;
+}
+
+void TransformSystem::update(ThreadPool& thread_pool) {
+    updated_ranges.clear();
+    updated_count = 0;
+
+    if(!is_sorted) { sort(); }
+    if(dirty_indices.empty()) { return; }
+
+    // In depth-first order, the modified transforms inside of a modified subtree come right after its root.
+    // Listing them again from the flags is cheaper than sorting them when a large part of them were modified
+    if(dirty_indices.size() > size() / TRANSFORM_DIRTY_SCAN_RATIO) {
+        dirty_indices.clear();
+        for(unsigned int i = 0 ; i < size() ; ++i) {
+            if(dirty_flags[i]) { dirty_indices.push_back(i); }
+        }
+    } else {
+        std::sort(dirty_indices.begin(), dirty_indices.end());
+    }
+
+    for(unsigned int i : dirty_indices) {
+        if(!updated_ranges.empty() && i < updated_ranges.back().second) { continue; }
+
+        updated_ranges.emplace_back(i, i + subtree_sizes[i]);
+        updated_count += subtree_sizes[i];
+    }
+
+    // The task size is a multiple of 4 so that every task uses full SIMD iterations
+    const unsigned int dirty_count = dirty_indices.size();
+    const unsigned int local_task_count = (dirty_count + TRANSFORM_TASK_SIZE - 1) / TRANSFORM_TASK_SIZE;
+
+    thread_pool.run(local_task_count, [&](unsigned int task_index, unsigned int) {
+        const unsigned int begin = task_index * TRANSFORM_TASK_SIZE;
+        compute_local_matrices(begin, std::min(begin + TRANSFORM_TASK_SIZE, dirty_count));
+    });
+
+    spine_indices.clear();
+    update_tasks.clear();
+    for(const auto& [begin, end] : updated_ranges) { split_update(begin, end); }
+
+    // The spine is in depth-first order and contains the ancestors of every task that were updated
+    for(unsigned int i : spine_indices) { compute_global_matrices(i); }
+
+    thread_pool.run(update_tasks.size(), [&](unsigned int task_index, unsigned int) {
+        const auto [begin, end] = update_tasks[task_index];
+        for(unsigned int i = begin ; i < end ; ++i) { compute_global_matrices(i); }
+    });
+
+    dirty_indices.clear();
+
+    // The owners are notified on this thread so that they don't need to synchronize
+    for(const auto& [begin, end] : updated_ranges) {
+        for(unsigned int i = begin ; i < end ; ++i) { owners[i]->on_global_model_updated(); }
+    }
+}
+
+void TransformSystem::mark_dirty(unsigned int index) {
+    if(dirty_flags[index]) { return; }
+
+    dirty_flags[index] = true;
+    dirty_indices.push_back(index);
+}
+
+unsigned int TransformSystem::size() const {
+    return parents.size();
+}
+
+unsigned int TransformSystem::get_updated_count() const {
+    return updated_count;
+}
+
+void TransformSystem::sort() {
+    const unsigned int count = size();
+
+    // Lists the children of each transform in the order they were added
+    std::vector<unsigned int> child_offsets(count + 1, 0);
+    for(unsigned int i = 0 ; i < count ; ++i) {
+        if(transforms[i] != nullptr && parents[i] != TRANSFORM_NULL_INDEX) { ++child_offsets[parents[i] + 1]; }
+    }
+    for(unsigned int i = 0 ; i < count ; ++i) { child_offsets[i + 1] += child_offsets[i]; }
+
+    std::vector<unsigned int> children(child_offsets[count]);
+    std::vector<unsigned int> child_cursors(child_offsets.begin(), child_offsets.end() - 1);
+    for(unsigned int i = 0 ; i < count ; ++i) {
+        if(transforms[i] != nullptr && parents[i] != TRANSFORM_NULL_INDEX) { children[child_cursors[parents[i]]++] = i; }
+    }
+
+    // Depth-first order, children being pushed in reverse so that they are visited in order
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> stack;
+    order.reserve(count);
+
+    for(unsigned int root = 0 ; root < count ; ++root) {
+        if(transforms[root] == nullptr || parents[root] != TRANSFORM_NULL_INDEX) { continue; }
+
+        stack.push_back(root);
+        while(!stack.empty()) {
+            const unsigned int i = stack.back();
+            stack.pop_back();
+            order.push_back(i);
+
+            for(unsigned int j = child_offsets[i + 1] ; j > child_offsets[i] ; --j) { stack.push_back(children[j - 1]); }
+        }
+    }
+
+    std::vector<int> new_indices(count, TRANSFORM_NULL_INDEX);
+    for(unsigned int i = 0 ; i < order.size() ; ++i) { new_indices[order[i]] = i; }
+
+    const auto reorder = [&order](auto& array) {
+        std::remove_reference_t<decltype(array)> reordered;
+        reordered.reserve(order.size());
+        for(unsigned int i : order) { reordered.push_back(array[i]); }
+        array = std::move(reordered);
+    };
+
+    reorder(local_positions);
+    reorder(local_orientations);
+    reorder(local_scales);
+    reorder(local_models);
+    reorder(local_normal_matrices);
+    reorder(global_models);
+    reorder(normal_matrices);
+    reorder(parents);
+    reorder(transforms);
+    reorder(owners);
+    reorder(dirty_flags);
+
+    for(int& parent : parents) {
+        if(parent != TRANSFORM_NULL_INDEX) { parent = new_indices[parent]; }
+    }
+
+    // Parents come before their children so the subtrees can be accumulated backwards
+    subtree_sizes.assign(order.size(), 1);
+    for(unsigned int i = order.size() ; i-- > 0 ;) {
+        if(parents[i] != TRANSFORM_NULL_INDEX) { subtree_sizes[parents[i]] += subtree_sizes[i]; }
+        transforms[i]->index = i;
+    }
+
+    dirty_indices.clear();
+    for(unsigned int i = 0 ; i < order.size() ; ++i) {
+        if(dirty_flags[i]) { dirty_indices.push_back(i); }
+    }
+
+    is_sorted = true;
+}
+
+void TransformSystem::compute_local_matrices(unsigned int begin, unsigned int end) {
+    unsigned int i = begin;
+
+#ifdef MATHS_USE_SSE
+    const float* positions = &local_positions.data()->x;
+    const float* orientations = &local_orientations.data()->x;
+    const float* scales = &local_scales.data()->x;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    for(; i + 4 <= end ; i += 4) {
+        const unsigned int* indices = &dirty_indices[i];
+
+        const __m128 x = gather_4(orientations, 4, indices);
+        const __m128 y = gather_4(orientations + 1, 4, indices);
+        const __m128 z = gather_4(orientations + 2, 4, indices);
+        const __m128 w = gather_4(orientations + 3, 4, indices);
+
+        // Same operations as the scalar rotation matrix of a quaternion
+        const __m128 r[3][3]{
+            {
+                _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(z, z)))),
+                _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(x, y), _mm_mul_ps(w, z))),
+                _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, z), _mm_mul_ps(w, y)))
+            },
+            {
+                _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, y), _mm_mul_ps(w, z))),
+                _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)))),
+                _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(y, z), _mm_mul_ps(w, x)))
+            },
+            {
+                _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(x, z), _mm_mul_ps(w, y))),
+                _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(y, z), _mm_mul_ps(w, x))),
+                _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))))
+            }
+        };
+
+        alignas(16) float model[3][4][4];
+        alignas(16) float normal[3][3][4];
+
+        for(int column = 0 ; column < 3 ; ++column) {
+            // Null scaling factors have an inverse of 1 like in the scalar code
+            const __m128 scale = gather_4(scales + column, 3, indices);
+            const __m128 inverse_scale = simd_select(_mm_cmpeq_ps(scale, zero), one, _mm_div_ps(one, scale));
+
+            for(int row = 0 ; row < 3 ; ++row) {
+                _mm_store_ps(model[row][column], _mm_mul_ps(scale, r[row][column]));
+                _mm_store_ps(normal[row][column], _mm_mul_ps(inverse_scale, r[row][column]));
+            }
+        }
+
+        for(int row = 0 ; row < 3 ; ++row) { _mm_store_ps(model[row][3], gather_4(positions + row, 3, indices)); }
+
+        for(int lane = 0 ; lane < 4 ; ++lane) {
+            affine3x4& local_model = local_models[indices[lane]];
+            mat3& local_normal_matrix = local_normal_matrices[indices[lane]];
+
+            for(int row = 0 ; row < 3 ; ++row) {
+                for(int column = 0 ; column < 3 ; ++column) {
+                    local_model(row, column) = model[row][column][lane];
+                    local_normal_matrix(row, column) = normal[row][column][lane];
+                }
+
+                local_model(row, 3) = model[row][3][lane];
+            }
+        }
+    }
+#endif
+
+    for(; i < end ; ++i) {
+        const unsigned int index = dirty_indices[i];
+        local_models[index] = TRS_affine(local_positions[index], local_orientations[index], local_scales[index]);
+        local_normal_matrices[index] = TRS_normal_matrix(local_orientations[index], local_scales[index]);
+    }
+
+    for(i = begin ; i < end ; ++i) { dirty_flags[dirty_indices[i]] = false; }
+}
+
+void TransformSystem::compute_global_matrices(unsigned int index) {
+    const int parent = parents[index];
+
+    if(parent == TRANSFORM_NULL_INDEX) {
+        global_models[index] = local_models[index];
+        normal_matrices[index] = local_normal_matrices[index];
+    } else {
+        global_models[index] = global_models[parent] * local_models[index];
+        normal_matrices[index] = normal_matrices[parent] * local_normal_matrices[index];
+    }
+}
+
+void TransformSystem::split_update(unsigned int begin, unsigned int end) {
+    if(end - begin <= TRANSFORM_TASK_SIZE) {
+        if(begin != end) { update_tasks.emplace_back(begin, end); }
+        return;
+    }
+
+    // Groups consecutive sibling subtrees into tasks, the subtrees too large for a task being split
+    unsigned int task_begin = begin;
+
+    for(unsigned int i = begin ; i < end ; i += subtree_sizes[i]) {
+        const unsigned int subtree_end = i + subtree_sizes[i];
+
+        if(subtree_sizes[i] > TRANSFORM_TASK_SIZE) {
+            if(task_begin != i) { update_tasks.emplace_back(task_begin, i); }
+
+            spine_indices.push_back(i);
+            split_update(i + 1, subtree_end);
+            task_begin = subtree_end;
+        } else if(subtree_end - task_begin > TRANSFORM_TASK_SIZE) {
+            update_tasks.emplace_back(task_begin, i);
+            task_begin = i;
+        }
+    }
+
+    if(task_begin != end) { update_tasks.emplace_back(task_begin, end); }
+}
@@ -0,0 +1,199 @@
+/***************************************************************************************************
+ * @file  affine3x4.cpp
+ * @brief Implementation of the affine3x4 struct
+ **************************************************************************************************/
+
+#include "maths/affine3x4.hpp"
+
+#include "maths/simd.hpp"
+
+/**
+ * @brief Computes the rotation matrix derived from a unit quaternion.
+ * @param q The quaternion.
+ * @param rotation Stores the rotation matrix, indexed by row then column.
+ */
+static void get_rotation_matrix(const quaternion& q, float rotation[3][3]) {
+    rotation[0][0] = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+    rotation[0][1] = 2.0f * (q.x * q.y - q.w * q.z);
+    rotation[0][2] = 2.0f * (q.x * q.z + q.w * q.y);
+
+    rotation[1][0] = 2.0f * (q.x * q.y + q.w * q.z);
+    rotation[1][1] = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+    rotation[1][2] = 2.0f * (q.y * q.z - q.w * q.x);
+
+    rotation[2][0] = 2.0f * (q.x * q.z - q.w * q.y);
+    rotation[2][1] = 2.0f * (q.y * q.z + q.w * q.x);
+    rotation[2][2] = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+}
+
+/**
+ * @brief Calculates the inverse of scaling factors, null factors being treated as 1.
+ */
+static vec3 get_inverse_scale(const vec3& scale) {
+    return vec3(
+        scale.x == 0.0f ? 1.0f : 1.0f / scale.x,
+        scale.y == 0.0f ? 1.0f : 1.0f / scale.y,
+        scale.z == 0.0f ? 1.0f : 1.0f / scale.z
+    );
+}
+
+mat4 affine3x4::get_matrix() const {
+    return mat4(
+        values[0][0], values[1][0], values[2][0], values[3][0],
+        values[0][1], values[1][1], values[2][1], values[3][1],
+        values[0][2], values[1][2], values[2][2], values[3][2],
+        0.0f, 0.0f, 0.0f, 1.0f
+    );
+}
+
+mat3 affine3x4::get_linear_part() const {
+    return mat3(
+        values[0][0], values[1][0], values[2][0],
+        values[0][1], values[1][1], values[2][1],
+        values[0][2], values[1][2], values[2][2]
+    );
+}
+
+vec3 affine3x4::get_translation() const {
+    return vec3(values[3][0], values[3][1], values[3][2]);
+}
+
+std::ostream& operator <<(std::ostream& stream, const affine3x4& mat) {
+    for(int i = 0 ; i < 3 ; ++i) {
+        stream << "( ";
+
+        for(int j = 0 ; j < 3 ; ++j) {
+            stream << ' ' << mat(i, j) << " ; ";
+        }
+
+        stream << mat(i, 3) << " )\n";
+    }
+    return stream;
+}
+
+affine3x4 operator *(const affine3x4& left, const affine3x4& right) {
+    affine3x4 result;
+
+    for(int i = 0 ; i < 3 ; ++i) {
+        for(int j = 0 ; j < 4 ; ++j) {
+            result(i, j) = left(i, 0) * right(0, j) + left(i, 1) * right(1, j) + left(i, 2) * right(2, j);
+        }
+
+        result(i, 3) += left(i, 3);
+    }
+
+    return result;
+}
+
+mat4 operator *(const mat4& left, const affine3x4& right) {
+    mat4 result;
+
+#ifdef MATHS_USE_SSE
+    const __m128 columns[4]{
+        _mm_loadu_ps(&left(0, 0)),
+        _mm_loadu_ps(&left(0, 1)),
+        _mm_loadu_ps(&left(0, 2)),
+        _mm_loadu_ps(&left(0, 3))
+    };
+
+    for(int j = 0 ; j < 4 ; ++j) {
+        __m128 column = _mm_mul_ps(columns[0], _mm_set1_ps(right(0, j)));
+        column = _mm_add_ps(column, _mm_mul_ps(columns[1], _mm_set1_ps(right(1, j))));
+        column = _mm_add_ps(column, _mm_mul_ps(columns[2], _mm_set1_ps(right(2, j))));
+        if(j == 3) { column = _mm_add_ps(column, columns[3]); }
+
+        _mm_storeu_ps(&result(0, j), column);
+    }
+#else
+    for(int i = 0 ; i < 4 ; ++i) {
+        for(int j = 0 ; j < 4 ; ++j) {
+            result(i, j) = left(i, 0) * right(0, j) + left(i, 1) * right(1, j) + left(i, 2) * right(2, j);
+        }
+
+        result(i, 3) += left(i, 3);
+    }
+#endif
+
+    return result;
+}
+
+vec3 operator *(const affine3x4& mat, const vec3& point) {
+    return vec3(
+        mat(0, 0) * point.x + mat(0, 1) * point.y + mat(0, 2) * point.z + mat(0, 3),
+        mat(1, 0) * point.x + mat(1, 1) * point.y + mat(1, 2) * point.z + mat(1, 3),
+        mat(2, 0) * point.x + mat(2, 1) * point.y + mat(2, 2) * point.z + mat(2, 3)
+    );
+}
+
+affine3x4 inverse(const affine3x4& mat) {
+    float det = mat(0, 0) * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1))
+                - mat(0, 1) * (mat(1, 0) * mat(2, 2) - mat(1, 2) * mat(2, 0))
+                + mat(0, 2) * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0));
+
+    if(det == 0.0f) { return affine3x4(); }
+
+    det = 1.0f / det;
+
+    affine3x4 result;
+
+    result(0, 0) = det * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1));
+    result(0, 1) = det * (mat(0, 2) * mat(2, 1) - mat(0, 1) * mat(2, 2));
+    result(0, 2) = det * (mat(0, 1) * mat(1, 2) - mat(0, 2) * mat(1, 1));
+
+    result(1, 0) = det * (mat(1, 2) * mat(2, 0) - mat(1, 0) * mat(2, 2));
+    result(1, 1) = det * (mat(0, 0) * mat(2, 2) - mat(0, 2) * mat(2, 0));
+    result(1, 2) = det * (mat(0, 2) * mat(1, 0) - mat(0, 0) * mat(1, 2));
+
+    result(2, 0) = det * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0));
+    result(2, 1) = det * (mat(0, 1) * mat(2, 0) - mat(0, 0) * mat(2, 1));
+    result(2, 2) = det * (mat(0, 0) * mat(1, 1) - mat(0, 1) * mat(1, 0));
+
+    for(int i = 0 ; i < 3 ; ++i) {
+        result(i, 3) = -(result(i, 0) * mat(0, 3) + result(i, 1) * mat(1, 3) + result(i, 2) * mat(2, 3));
+    }
+
+    return result;
+}
+
+affine3x4 TRS_affine(const vec3& translation, const quaternion& rotation, const vec3& scale) {
+    float r[3][3];
+    get_rotation_matrix(rotation, r);
+
+    return affine3x4(
+        scale.x * r[0][0], scale.y * r[0][1], scale.z * r[0][2], translation.x,
+        scale.x * r[1][0], scale.y * r[1][1], scale.z * r[1][2], translation.y,
+        scale.x * r[2][0], scale.y * r[2][1], scale.z * r[2][2], translation.z
+    );
+}
+
+affine3x4 inverse_TRS_affine(const vec3& translation, const quaternion& rotation, const vec3& scale) {
+    float r[3][3];
+    get_rotation_matrix(rotation, r);
+
+    const vec3 inverse_scale = get_inverse_scale(scale);
+
+    affine3x4 result(
+        inverse_scale.x * r[0][0], inverse_scale.x * r[1][0], inverse_scale.x * r[2][0], 0.0f,
+        inverse_scale.y * r[0][1], inverse_scale.y * r[1][1], inverse_scale.y * r[2][1], 0.0f,
+        inverse_scale.z * r[0][2], inverse_scale.z * r[1][2], inverse_scale.z * r[2][2], 0.0f
+    );
+
+    for(int i = 0 ; i < 3 ; ++i) {
+        result(i, 3) = -(result(i, 0) * translation.x + result(i, 1) * translation.y + result(i, 2) * translation.z);
+    }
+
+    return result;
+}
+
+mat3 TRS_normal_matrix(const quaternion& rotation, const vec3& scale) {
+    float r[3][3];
+    get_rotation_matrix(rotation, r);
+
+    const vec3 inverse_scale = get_inverse_scale(scale);
+
+    return mat3(
+        inverse_scale.x * r[0][0], inverse_scale.y * r[0][1], inverse_scale.z * r[0][2],
+        inverse_scale.x * r[1][0], inverse_scale.y * r[1][1], inverse_scale.z * r[1][2],
+        inverse_scale.x * r[2][0], inverse_scale.y * r[2][1], inverse_scale.z * r[2][2]
+    );
+}
@@ -0,0 +1,231 @@
+/***************************************************************************************************
+ * @file  batch_transforms.cpp
+ * @brief Implementation of functions transforming arrays of points and normals
+ **************************************************************************************************/
+
+#include "maths/batch_transforms.hpp"
+
+#include <cmath>
+#include "maths/simd.hpp"
+
+/**
+ * @brief Transforms a single point by an affine matrix, the operations being done in the same
+ * order as in mat * vec4(x, y, z, 1.0).
+ */
+static void transform_point(const mat4& mat, float x, float y, float z, float* out) {
+    const float result[3]{
+        mat(0, 0) * x + mat(0, 1) * y + mat(0, 2) * z + mat(0, 3),
+        mat(1, 0) * x + mat(1, 1) * y + mat(1, 2) * z + mat(1, 3),
+        mat(2, 0) * x + mat(2, 1) * y + mat(2, 2) * z + mat(2, 3)
+    };
+
+    out[0] = result[0];
+    out[1] = result[1];
+    out[2] = result[2];
+}
+
+/**
+ * @brief Transforms and normalizes a single normal, the operations being done in the same order as
+ * in normalize(mat * vec3(x, y, z)).
+ */
+static void transform_normal(const mat3& mat, float x, float y, float z, float* out) {
+    const float result[3]{
+        mat(0, 0) * x + mat(0, 1) * y + mat(0, 2) * z,
+        mat(1, 0) * x + mat(1, 1) * y + mat(1, 2) * z,
+        mat(2, 0) * x + mat(2, 1) * y + mat(2, 2) * z
+    };
+
+    const float length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+
+    out[0] = result[0] / length;
+    out[1] = result[1] / length;
+    out[2] = result[2] / length;
+}
+
+#ifdef MATHS_USE_SSE
+/**
+ * @brief Computes one row of mat * (x, y, z, 1.0) for 4 points at once.
+ */
+static inline __m128 transform_points_row(const mat4& mat, int row, __m128 x, __m128 y, __m128 z) {
+    __m128 result = _mm_mul_ps(_mm_set1_ps(mat(row, 0)), x);
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(mat(row, 1)), y));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(mat(row, 2)), z));
+    return _mm_add_ps(result, _mm_set1_ps(mat(row, 3)));
+}
+
+/**
+ * @brief Computes normalize(mat * (x, y, z)) for 4 normals at once.
+ */
+static inline void transform_normals_4(const mat3& mat, __m128& x, __m128& y, __m128& z) {
+    __m128 result[3];
+
+    for(int row = 0 ; row < 3 ; ++row) {
+        result[row] = _mm_mul_ps(_mm_set1_ps(mat(row, 0)), x);
+        result[row] = _mm_add_ps(result[row], _mm_mul_ps(_mm_set1_ps(mat(row, 1)), y));
+        result[row] = _mm_add_ps(result[row], _mm_mul_ps(_mm_set1_ps(mat(row, 2)), z));
+    }
+
+    __m128 length = _mm_mul_ps(result[0], result[0]);
+    length = _mm_add_ps(length, _mm_mul_ps(result[1], result[1]));
+    length = _mm_sqrt_ps(_mm_add_ps(length, _mm_mul_ps(result[2], result[2])));
+
+    x = _mm_div_ps(result[0], length);
+    y = _mm_div_ps(result[1], length);
+    z = _mm_div_ps(result[2], length);
+}
+
+/**
+ * @brief Loads the 3 components of 4 points stored in an interleaved array into 3 registers.
+ */
+static inline void gather_4(const float* in, std::size_t stride, __m128& x, __m128& y, __m128& z) {
+    x = _mm_set_ps(in[3 * stride], in[2 * stride], in[stride], in[0]);
+    y = _mm_set_ps(in[3 * stride + 1], in[2 * stride + 1], in[stride + 1], in[1]);
+    z = _mm_set_ps(in[3 * stride + 2], in[2 * stride + 2], in[stride + 2], in[2]);
+}
+
+/**
+ * @brief Stores 3 registers as the 3 components of 4 points inside of an interleaved array.
+ */
+static inline void scatter_4(float* out, std::size_t stride, __m128 x, __m128 y, __m128 z) {
+    alignas(16) float values[3][4];
+    _mm_store_ps(values[0], x);
+    _mm_store_ps(values[1], y);
+    _mm_store_ps(values[2], z);
+
+    for(std::size_t i = 0 ; i < 4 ; ++i) {
+        out[i * stride] = values[0][i];
+        out[i * stride + 1] = values[1][i];
+        out[i * stride + 2] = values[2][i];
+    }
+}
+#endif
+
+void transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) {
+    transform_points(mat, reinterpret_cast<const float*>(in.data()), 3, reinterpret_cast<float*>(out.data()), 3, in.size());
+}
+
+void transform_points(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) {
+#ifdef MATHS_USE_SSE
+    const float* columns = &mat(0, 0);
+
+    for(std::size_t i = 0 ; i < in.size() ; ++i) {
+        _mm_storeu_ps(&out[i].x, simd_combine_columns(columns, _mm_loadu_ps(&in[i].x)));
+    }
+#else
+    for(std::size_t i = 0 ; i < in.size() ; ++i) {
+        out[i] = mat * in[i];
+    }
+#endif
+}
+
+void transform_points(const mat4& mat,
+                      const float* in, std::size_t in_stride,
+                      float* out, std::size_t out_stride,
+                      std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= count ; i += 4) {
+        __m128 x, y, z;
+        gather_4(in + i * in_stride, in_stride, x, y, z);
+
+        scatter_4(out + i * out_stride, out_stride,
+                  transform_points_row(mat, 0, x, y, z),
+                  transform_points_row(mat, 1, x, y, z),
+                  transform_points_row(mat, 2, x, y, z));
+    }
+#endif
+
+    for(; i < count ; ++i) {
+        const float* point = in + i * in_stride;
+        transform_point(mat, point[0], point[1], point[2], out + i * out_stride);
+    }
+}
+
+void transform_points(const mat4& mat,
+                      const float* in_x, const float* in_y, const float* in_z,
+                      float* out_x, float* out_y, float* out_z, float* out_w,
+                      std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= count ; i += 4) {
+        const __m128 x = _mm_loadu_ps(in_x + i);
+        const __m128 y = _mm_loadu_ps(in_y + i);
+        const __m128 z = _mm_loadu_ps(in_z + i);
+
+        const __m128 result_x = transform_points_row(mat, 0, x, y, z);
+        const __m128 result_y = transform_points_row(mat, 1, x, y, z);
+        const __m128 result_z = transform_points_row(mat, 2, x, y, z);
+        if(out_w != nullptr) { _mm_storeu_ps(out_w + i, transform_points_row(mat, 3, x, y, z)); }
+
+        _mm_storeu_ps(out_x + i, result_x);
+        _mm_storeu_ps(out_y + i, result_y);
+        _mm_storeu_ps(out_z + i, result_z);
+    }
+#endif
+
+    for(; i < count ; ++i) {
+        const float x = in_x[i], y = in_y[i], z = in_z[i];
+
+        out_x[i] = mat(0, 0) * x + mat(0, 1) * y + mat(0, 2) * z + mat(0, 3);
+        out_y[i] = mat(1, 0) * x + mat(1, 1) * y + mat(1, 2) * z + mat(1, 3);
+        out_z[i] = mat(2, 0) * x + mat(2, 1) * y + mat(2, 2) * z + mat(2, 3);
+        if(out_w != nullptr) { out_w[i] = mat(3, 0) * x + mat(3, 1) * y + mat(3, 2) * z + mat(3, 3); }
+    }
+}
+
+void transform_normals(const mat3& mat, std::span<const vec3> in, std::span<vec3> out) {
+    transform_normals(mat, reinterpret_cast<const float*>(in.data()), 3, reinterpret_cast<float*>(out.data()), 3, in.size());
+}
+
+void transform_normals(const mat3& mat,
+                       const float* in, std::size_t in_stride,
+                       float* out, std::size_t out_stride,
+                       std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= count ; i += 4) {
+        __m128 x, y, z;
+        gather_4(in + i * in_stride, in_stride, x, y, z);
+        transform_normals_4(mat, x, y, z);
+        scatter_4(out + i * out_stride, out_stride, x, y, z);
+    }
+#endif
+
+    for(; i < count ; ++i) {
+        const float* normal = in + i * in_stride;
+        transform_normal(mat, normal[0], normal[1], normal[2], out + i * out_stride);
+    }
+}
+
+void transform_normals(const mat3& mat,
+                       const float* in_x, const float* in_y, const float* in_z,
+                       float* out_x, float* out_y, float* out_z,
+                       std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= count ; i += 4) {
+        __m128 x = _mm_loadu_ps(in_x + i);
+        __m128 y = _mm_loadu_ps(in_y + i);
+        __m128 z = _mm_loadu_ps(in_z + i);
+
+        transform_normals_4(mat, x, y, z);
+
+        _mm_storeu_ps(out_x + i, x);
+        _mm_storeu_ps(out_y + i, y);
+        _mm_storeu_ps(out_z + i, z);
+    }
+#endif
+
+    for(; i < count ; ++i) {
+        float result[3];
+        transform_normal(mat, in_x[i], in_y[i], in_z[i], result);
+
+        out_x[i] = result[0];
+        out_y[i] = result[1];
+        out_z[i] = result[2];
+    }
+}
@@ -0,0 +1,128 @@
+/***************************************************************************************************
+ * @file  fast.cpp
+ * @brief Implementation of the batched fast approximations of common maths functions
+ **************************************************************************************************/
+
+#include "maths/fast.hpp"
+
+#ifdef MATHS_USE_SSE
+#include <emmintrin.h>
+
+/**
+ * @brief Computes fast_sin and fast_cos for 4 angles at once, doing the same operations as the
+ * scalar versions.
+ */
+static inline void fast_sin_cos_4(__m128 angle, __m128& sine, __m128& cosine) {
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+    // Rounds angle / pi to the nearest integer, halfway cases being rounded away from zero
+    const __m128 half = _mm_or_ps(_mm_and_ps(angle, sign_mask), _mm_set1_ps(0.5f));
+    const __m128i k_int = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(angle, _mm_set1_ps(1.0f / PI_F)), half));
+    const __m128 k = _mm_cvtepi32_ps(k_int);
+
+    const __m128 r = _mm_sub_ps(_mm_sub_ps(angle, _mm_mul_ps(k, _mm_set1_ps(3.140625f))),
+                                _mm_mul_ps(k, _mm_set1_ps(9.67653589793e-4f)));
+    const __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 polynomial = _mm_add_ps(_mm_set1_ps(2.7557319e-6f), _mm_mul_ps(r2, _mm_set1_ps(-2.5052108e-8f)));
+    polynomial = _mm_add_ps(_mm_set1_ps(-1.9841270e-4f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(8.3333333e-3f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(-1.6666667e-1f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, polynomial));
+    sine = _mm_mul_ps(r, polynomial);
+
+    polynomial = _mm_add_ps(_mm_set1_ps(-2.7557319e-7f), _mm_mul_ps(r2, _mm_set1_ps(2.0876757e-9f)));
+    polynomial = _mm_add_ps(_mm_set1_ps(2.4801587e-5f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(-1.3888889e-3f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(4.1666667e-2f), _mm_mul_ps(r2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(-0.5f), _mm_mul_ps(r2, polynomial));
+    cosine = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, polynomial));
+
+    // Flips the sign of the results when k is odd
+    const __m128 flip = _mm_castsi128_ps(_mm_slli_epi32(k_int, 31));
+    sine = _mm_xor_ps(sine, flip);
+    cosine = _mm_xor_ps(cosine, flip);
+}
+
+/**
+ * @brief Computes fast_rsqrt for 4 values at once, doing the same operations as the scalar version.
+ */
+static inline __m128 fast_rsqrt_4(__m128 value) {
+    const __m128 estimate = _mm_rsqrt_ps(value);
+    const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f),
+                                         _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), value), estimate), estimate));
+    return _mm_mul_ps(estimate, correction);
+}
+#endif
+
+void fast_sin_cos(std::span<const float> angles, std::span<float> sines, std::span<float> cosines) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= angles.size() ; i += 4) {
+        __m128 sine, cosine;
+        fast_sin_cos_4(_mm_loadu_ps(&angles[i]), sine, cosine);
+        _mm_storeu_ps(&sines[i], sine);
+        _mm_storeu_ps(&cosines[i], cosine);
+    }
+#endif
+
+    for(; i < angles.size() ; ++i) {
+        sines[i] = fast_sin(angles[i]);
+        cosines[i] = fast_cos(angles[i]);
+    }
+}
+
+void fast_rsqrt(std::span<const float> values, std::span<float> results) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    for(; i + 4 <= values.size() ; i += 4) {
+        _mm_storeu_ps(&results[i], fast_rsqrt_4(_mm_loadu_ps(&values[i])));
+    }
+#endif
+
+    for(; i < values.size() ; ++i) {
+        results[i] = fast_rsqrt(values[i]);
+    }
+}
+
+void fast_normalize(std::span<vec3> vectors) {
+    std::size_t i = 0;
+
+#ifdef MATHS_USE_SSE
+    float* components = reinterpret_cast<float*>(vectors.data());
+
+    for(; i + 4 <= vectors.size() ; i += 4) {
+        // Loads 4 vec3 (12 floats) and transposes them into x, y and z registers
+        const __m128 a = _mm_loadu_ps(components + 3 * i);     // x0 y0 z0 x1
+        const __m128 b = _mm_loadu_ps(components + 3 * i + 4); // y1 z1 x2 y2
+        const __m128 c = _mm_loadu_ps(components + 3 * i + 8); // z2 x3 y3 z3
+
+        const __m128 x = _mm_setr_ps(_mm_cvtss_f32(a), _mm_cvtss_f32(_mm_shuffle_ps(a, a, 3)),
+                                     _mm_cvtss_f32(_mm_shuffle_ps(b, b, 2)), _mm_cvtss_f32(_mm_shuffle_ps(c, c, 1)));
+        const __m128 y = _mm_setr_ps(_mm_cvtss_f32(_mm_shuffle_ps(a, a, 1)), _mm_cvtss_f32(b),
+                                     _mm_cvtss_f32(_mm_shuffle_ps(b, b, 3)), _mm_cvtss_f32(_mm_shuffle_ps(c, c, 2)));
+        const __m128 z = _mm_setr_ps(_mm_cvtss_f32(_mm_shuffle_ps(a, a, 2)), _mm_cvtss_f32(_mm_shuffle_ps(b, b, 1)),
+                                     _mm_cvtss_f32(c), _mm_cvtss_f32(_mm_shuffle_ps(c, c, 3)));
+
+        __m128 squared_length = _mm_mul_ps(x, x);
+        squared_length = _mm_add_ps(squared_length, _mm_mul_ps(y, y));
+        squared_length = _mm_add_ps(squared_length, _mm_mul_ps(z, z));
+        const __m128 factor = fast_rsqrt_4(squared_length);
+
+        alignas(16) float result[3][4];
+        _mm_store_ps(result[0], _mm_mul_ps(x, factor));
+        _mm_store_ps(result[1], _mm_mul_ps(y, factor));
+        _mm_store_ps(result[2], _mm_mul_ps(z, factor));
+
+        for(std::size_t j = 0 ; j < 4 ; ++j) {
+            vectors[i + j] = vec3(result[0][j], result[1][j], result[2][j]);
+        }
+    }
+#endif
+
+    for(; i < vectors.size() ; ++i) {
+        vectors[i] = fast_normalize(vectors[i]);
+    }
+}
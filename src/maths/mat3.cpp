@@ -7,37 +7,6 @@
 
 #include "maths/mat4.hpp"
 
-mat3::mat3()
-    : values{
-        { 0.0f, 0.0f, 0.0f },
-        { 0.0f, 0.0f, 0.0f },
-        { 0.0f, 0.0f, 0.0f }
-    } { }
-
-mat3::mat3(float v00, float v01, float v02,
-           float v10, float v11, float v12,
-           float v20, float v21, float v22)
-    : values{
-        { v00, v10, v20 },
-        { v01, v11, v21 },
-        { v02, v12, v22 }
-    } { }
-
-mat3::mat3(float scalar)
-    : values{
-        { scalar, 0.0f, 0.0f },
-        { 0.0f, scalar, 0.0f },
-        { 0.0f, 0.0f, scalar }
-    } { }
-
-float& mat3::operator ()(int row, int column) {
-    return values[column][row];
-}
-
-const float& mat3::operator ()(int row, int column) const {
-    return values[column][row];
-}
-
 mat3 inverse(const mat3& mat) {
     float det = mat(0, 0) * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1))
                 - mat(0, 1) * (mat(1, 0) * mat(2, 2) - mat(1, 2) * mat(2, 0))
@@ -7,45 +7,9 @@
 
 #include <cmath>
 #include "maths/geometry.hpp"
+#include "maths/simd.hpp"
 #include "maths/trigonometry.hpp"
 
-mat4::mat4()
-    : values{
-        { 0.0f, 0.0f, 0.0f, 0.0f },
-        { 0.0f, 0.0f, 0.0f, 0.0f },
-        { 0.0f, 0.0f, 0.0f, 0.0f },
-        { 0.0f, 0.0f, 0.0f, 0.0f }
-    } { }
-
-mat4::mat4(float v00, float v01, float v02, float v03,
-           float v10, float v11, float v12, float v13,
-           float v20, float v21, float v22, float v23,
-           float v30, float v31, float v32, float v33)
-    : values{
-        { v00, v10, v20, v30 },
-        { v01, v11, v21, v31 },
-        { v02, v12, v22, v32 },
-        { v03, v13, v23, v33 }
-    } { }
-
-mat4::mat4(float v00, float v01, float v02,
-           float v10, float v11, float v12,
-           float v20, float v21, float v22)
-    : values{
-        { v00, v10, v20, 0.0f },
-        { v01, v11, v21, 0.0f },
-        { v02, v12, v22, 0.0f },
-        { 0.0f, 0.0f, 0.0f, 1.0f }
-    } { }
-
-mat4::mat4(float scalar)
-    : values{
-        { scalar, 0.0f, 0.0f, 0.0f },
-        { 0.0f, scalar, 0.0f, 0.0f },
-        { 0.0f, 0.0f, scalar, 0.0f },
-        { 0.0f, 0.0f, 0.0f, scalar }
-    } { }
-
 mat4& mat4::scale(float factor) {
     for(int i = 0 ; i < 3 ; ++i) {
         values[0][i] *= factor;
@@ -294,18 +258,38 @@ mat4 operator -(const mat4& left, const mat4& right) {
 }
 
 mat4 operator *(const mat4& left, const mat4& right) {
-    // mat4 result;
-    //
-    // for(int i = 0 ; i < 4 ; ++i) {
-    //     for(int j = 0 ; j < 4 ; ++j) {
-    //         for(int k = 0 ; k < 4 ; ++k) {
-    //             result(i, j) += left(i, k) * right(k, j);
-    //         }
-    //     }
-    // }
-    //
-    // return result;
+#if defined(MATHS_USE_AVX)
+    mat4 result;
+
+    // Each 256 bits register holds two columns of the result
+    const __m256 left_columns[4]{
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left(0, 0))),
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left(0, 1))),
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left(0, 2))),
+        _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left(0, 3)))
+    };
+
+    for(int j = 0 ; j < 4 ; j += 2) {
+        const __m256 columns = _mm256_loadu_ps(&right(0, j));
+
+        __m256 sum = _mm256_mul_ps(left_columns[0], _mm256_shuffle_ps(columns, columns, _MM_SHUFFLE(0, 0, 0, 0)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(left_columns[1], _mm256_shuffle_ps(columns, columns, _MM_SHUFFLE(1, 1, 1, 1))));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(left_columns[2], _mm256_shuffle_ps(columns, columns, _MM_SHUFFLE(2, 2, 2, 2))));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(left_columns[3], _mm256_shuffle_ps(columns, columns, _MM_SHUFFLE(3, 3, 3, 3))));
+
+        _mm256_storeu_ps(&result(0, j), sum);
+    }
 
+    return result;
+#elif defined(MATHS_USE_SSE)
+    mat4 result;
+
+    for(int j = 0 ; j < 4 ; ++j) {
+        _mm_storeu_ps(&result(0, j), simd_combine_columns(&left(0, 0), _mm_loadu_ps(&right(0, j))));
+    }
+
+    return result;
+#else
     return mat4(
         left(0, 0) * right(0, 0) + left(0, 1) * right(1, 0) + left(0, 2) * right(2, 0) + left(0, 3) * right(3, 0),
         left(0, 0) * right(0, 1) + left(0, 1) * right(1, 1) + left(0, 2) * right(2, 1) + left(0, 3) * right(3, 1),
@@ -324,6 +308,7 @@ mat4 operator *(const mat4& left, const mat4& right) {
         left(3, 0) * right(0, 2) + left(3, 1) * right(1, 2) + left(3, 2) * right(2, 2) + left(3, 3) * right(3, 2),
         left(3, 0) * right(0, 3) + left(3, 1) * right(1, 3) + left(3, 2) * right(2, 3) + left(3, 3) * right(3, 3)
     );
+#endif
 }
 
 mat4 operator +(const mat4& mat, float scalar) {
@@ -395,10 +380,16 @@ vec3 operator*(const mat4& mat, const vec3& vec) {
 }
 
 vec4 operator*(const mat4& mat, const vec4& vec) {
+#ifdef MATHS_USE_SSE
+    vec4 result;
+    _mm_storeu_ps(&result.x, simd_combine_columns(&mat(0, 0), _mm_loadu_ps(&vec.x)));
+    return result;
+#else
     return vec4(
         mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z + mat(0, 3) * vec.w,
         mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z + mat(1, 3) * vec.w,
         mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z + mat(2, 3) * vec.w,
         mat(3, 0) * vec.x + mat(3, 1) * vec.y + mat(3, 2) * vec.z + mat(3, 3) * vec.w
     );
+#endif
 }
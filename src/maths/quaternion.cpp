@@ -11,10 +11,6 @@
 #include "maths/trigonometry.hpp"
 #include "maths/vec2.hpp"
 
-quaternion::quaternion() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) { }
-
-quaternion::quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) { }
-
 quaternion& quaternion::operator +=(const quaternion& q) {
     x += q.x;
     y += q.y;
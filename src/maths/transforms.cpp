@@ -7,6 +7,7 @@
 
 #include <cmath>
 #include "maths/geometry.hpp"
+#include "maths/simd.hpp"
 #include "maths/trigonometry.hpp"
 
 mat4 scale(float factor) {
@@ -197,24 +198,60 @@ mat4 TRS_matrix(const vec3& translation, const vec3& rotation, const vec3& scale
 }
 
 mat4 TRS_matrix(const vec3& translation, const quaternion& rotation, const vec3& scale) {
+#ifdef MATHS_USE_SSE
+    mat4 result;
+
+    // Each column j of the rotation matrix is 2 * (a + b) with its diagonal element replaced by
+    // 1 - 2 * (a + b), the column is then scaled by the j-th scaling factor
+    const __m128 q = _mm_loadu_ps(&rotation.x); // (x, y, z, w)
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 xyz_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+    // Column 0: (1 - 2(yy + zz), 2(xy + wz), 2(xz - wy))
+    __m128 a = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 1)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 2, 1, 1)));
+    __m128 b = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 3, 2)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 2, 2)));
+    __m128 column = _mm_mul_ps(two, _mm_add_ps(a, _mm_xor_ps(b, _mm_set_ps(0.0f, -0.0f, 0.0f, 0.0f))));
+    column = _mm_move_ss(column, _mm_sub_ps(one, column));
+    _mm_storeu_ps(&result(0, 0), _mm_and_ps(xyz_mask, _mm_mul_ps(_mm_set1_ps(scale.x), column)));
+
+    // Column 1: (2(xy - wz), 1 - 2(xx + zz), 2(yz + wx))
+    a = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 0, 0)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 2, 0, 1)));
+    b = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 2, 3)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 2, 2)));
+    column = _mm_mul_ps(two, _mm_add_ps(a, _mm_xor_ps(b, _mm_set_ps(0.0f, 0.0f, 0.0f, -0.0f))));
+    column = simd_select(_mm_castsi128_ps(_mm_set_epi32(0, 0, -1, 0)), _mm_sub_ps(one, column), column);
+    _mm_storeu_ps(&result(0, 1), _mm_and_ps(xyz_mask, _mm_mul_ps(_mm_set1_ps(scale.y), column)));
+
+    // Column 2: (2(xz + wy), 2(yz - wx), 1 - 2(xx + yy))
+    a = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 1, 0)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 2, 2)));
+    b = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 3, 3)), _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 0, 1)));
+    column = _mm_mul_ps(two, _mm_add_ps(a, _mm_xor_ps(b, _mm_set_ps(0.0f, 0.0f, -0.0f, 0.0f))));
+    column = simd_select(_mm_castsi128_ps(_mm_set_epi32(0, -1, 0, 0)), _mm_sub_ps(one, column), column);
+    _mm_storeu_ps(&result(0, 2), _mm_and_ps(xyz_mask, _mm_mul_ps(_mm_set1_ps(scale.z), column)));
+
+    _mm_storeu_ps(&result(0, 3), _mm_set_ps(1.0f, translation.z, translation.y, translation.x));
+
+    return result;
+#else
     return mat4(
         scale.x * (1.0f - 2.0f * (rotation.y * rotation.y + rotation.z * rotation.z)),
-        scale.x * (2.0f * (rotation.x * rotation.y - rotation.w * rotation.z)),
-        scale.x * (2.0f * (rotation.x * rotation.z + rotation.w * rotation.y)),
+        scale.y * (2.0f * (rotation.x * rotation.y - rotation.w * rotation.z)),
+        scale.z * (2.0f * (rotation.x * rotation.z + rotation.w * rotation.y)),
         translation.x,
 
-        scale.y * (2.0f * (rotation.x * rotation.y + rotation.w * rotation.z)),
+        scale.x * (2.0f * (rotation.x * rotation.y + rotation.w * rotation.z)),
         scale.y * (1.0f - 2.0f * (rotation.x * rotation.x + rotation.z * rotation.z)),
-        scale.y * (2.0f * (rotation.y * rotation.z - rotation.w * rotation.x)),
+        scale.z * (2.0f * (rotation.y * rotation.z - rotation.w * rotation.x)),
         translation.y,
 
-        scale.z * (2.0f * (rotation.x * rotation.z - rotation.w * rotation.y)),
-        scale.z * (2.0f * (rotation.y * rotation.z + rotation.w * rotation.x)),
+        scale.x * (2.0f * (rotation.x * rotation.z - rotation.w * rotation.y)),
+        scale.y * (2.0f * (rotation.y * rotation.z + rotation.w * rotation.x)),
         scale.z * (1.0f - 2.0f * (rotation.x * rotation.x + rotation.y * rotation.y)),
         translation.z,
 
         0.0f, 0.0f, 0.0f, 1.0f
     );
+#endif
 }
 
 mat4 look_at(const vec3& eye, const vec3& target, const vec3& up) {
@@ -5,12 +5,42 @@
 
 #include "mesh/Mesh.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <utility>
+#include "AssetManager.hpp"
+#include "GLState.hpp"
+#include "maths/batch_transforms.hpp"
+#include "maths/fast.hpp"
 #include "maths/geometry.hpp"
 #include "maths/mat3.hpp"
+#include "mesh/meshlets.hpp"
+#include "mesh/simplification.hpp"
+
+/**
+ * @brief The maximum simplification error of a level of detail, relative to the radius of the mesh.
+ */
+static constexpr float LOD_MAX_ERROR = 0.1f;
+
+/**
+ * @brief Levels of detail keeping more than this ratio of the previous level's indices aren't kept.
+ */
+static constexpr float LOD_MIN_REDUCTION = 0.85f;
+
+/**
+ * @brief The maximum projected error of a level of detail, relative to half of the screen's height.
+ * About a pixel at 1080p.
+ */
+static constexpr float LOD_MAX_SCREEN_ERROR = 0.002f;
+
+/**
+ * @brief The amount of meshes whose buffers were bound, giving their ids.
+ */
+static unsigned int bound_mesh_count = 0;
 
 Mesh::Mesh(Primitive primitive)
-    : primitive(primitive), stride(0), active_attributes_count(0), VAO(0), VBO(0), EBO(0) {
+    : primitive(primitive), stride(0), active_attributes_count(0), buffer(nullptr), allocation{ }, id(0) {
     for(AttributeType& attribute : attributes) { attribute = AttributeType::NONE; }
     enable_attribute(ATTRIBUTE_POSITION);
 }
@@ -19,29 +49,91 @@ Mesh::~Mesh() {
     delete_buffers();
 }
 
-void Mesh::draw() const {
-    if(primitive == Primitive::NONE) {
-        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have a primitive.\n";
-        return;
-    }
+Mesh::Mesh(Mesh&& mesh) noexcept
+    : primitive(mesh.primitive), stride(mesh.stride), active_attributes_count(mesh.active_attributes_count),
+      data(std::move(mesh.data)), indices(std::move(mesh.indices)), lod_indices(std::move(mesh.lod_indices)),
+      lods(std::move(mesh.lods)), meshlets(std::move(mesh.meshlets)), bounds(mesh.bounds),
+      buffer(std::exchange(mesh.buffer, nullptr)), allocation(mesh.allocation), id(mesh.id) {
+    std::copy(mesh.attributes, mesh.attributes + ATTRIBUTE_AMOUNT, attributes);
+}
 
-    if(stride == 0) {
-        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have any active attributes.\n";
-        return;
-    }
+Mesh& Mesh::operator =(Mesh&& mesh) noexcept {
+    if(this == &mesh) { return *this; }
 
-    if(VAO == 0 || VBO == 0) {
-        std::cout << "[WARNING] Mesh wasn't drawn as its buffers aren't bound.\n";
-        return;
+    delete_buffers();
+
+    primitive = mesh.primitive;
+    std::copy(mesh.attributes, mesh.attributes + ATTRIBUTE_AMOUNT, attributes);
+    stride = mesh.stride;
+    active_attributes_count = mesh.active_attributes_count;
+    data = std::move(mesh.data);
+    indices = std::move(mesh.indices);
+    lod_indices = std::move(mesh.lod_indices);
+    lods = std::move(mesh.lods);
+    meshlets = std::move(mesh.meshlets);
+    bounds = mesh.bounds;
+    buffer = std::exchange(mesh.buffer, nullptr);
+    allocation = mesh.allocation;
+    id = mesh.id;
+
+    return *this;
+}
+
+void Mesh::draw(unsigned int lod) const {
+    if(!can_be_drawn()) { return; }
+
+    GLState::bind_vertex_array(buffer->get_vao());
+
+    if(indices.empty()) {
+        glDrawArrays(get_opengl_enum_for_primitive(primitive), allocation.first_vertex, allocation.vertex_count);
+    } else {
+        const DrawElementsIndirectCommand command = get_draw_command(lod, 1, 0);
+        glDrawElementsBaseVertex(get_opengl_enum_for_primitive(primitive), command.count, GL_UNSIGNED_INT,
+                                 reinterpret_cast<void*>(command.first_index * sizeof(unsigned int)),
+                                 command.base_vertex);
     }
+}
+
+void Mesh::draw_instanced(unsigned int instance_count, unsigned int first_instance, unsigned int lod) const {
+    if(!can_be_drawn()) { return; }
 
-    glBindVertexArray(VAO);
+    GLState::bind_vertex_array(buffer->get_vao());
 
     if(indices.empty()) {
-        glDrawArrays(get_opengl_enum_for_primitive(primitive), 0, data.size() / stride);
+        glDrawArraysInstancedBaseInstance(get_opengl_enum_for_primitive(primitive), allocation.first_vertex,
+                                          allocation.vertex_count, instance_count, first_instance);
     } else {
-        glDrawElements(get_opengl_enum_for_primitive(primitive), indices.size(), GL_UNSIGNED_INT, nullptr);
+        const DrawElementsIndirectCommand command = get_draw_command(lod, instance_count, first_instance);
+        const void* offset = reinterpret_cast<void*>(command.first_index * sizeof(unsigned int));
+        glDrawElementsInstancedBaseVertexBaseInstance(get_opengl_enum_for_primitive(primitive), command.count,
+                                                      GL_UNSIGNED_INT, offset, command.instance_count,
+                                                      command.base_vertex, command.base_instance);
+    }
+}
+
+DrawElementsIndirectCommand Mesh::get_draw_command(unsigned int lod, unsigned int instance_count,
+                                                   unsigned int first_instance) const {
+    DrawElementsIndirectCommand command{ static_cast<unsigned int>(indices.size()), instance_count,
+                                         allocation.first_index, static_cast<int>(allocation.first_vertex),
+                                         first_instance };
+
+    // The levels of detail are stored after the full mesh's indices
+    if(lod > 0 && !lods.empty()) {
+        const MeshLOD& level = lods[std::min<std::size_t>(lod, lods.size() - 1)];
+        command.count = level.count;
+        command.first_index += level.offset;
     }
+
+    return command;
+}
+
+void Mesh::draw_indirect(unsigned int first_command, unsigned int command_count) const {
+    if(!can_be_drawn()) { return; }
+
+    GLState::bind_vertex_array(buffer->get_vao());
+    glMultiDrawElementsIndirect(get_opengl_enum_for_primitive(primitive), GL_UNSIGNED_INT,
+                                reinterpret_cast<void*>(first_command * sizeof(DrawElementsIndirectCommand)),
+                                command_count, 0);
 }
 
 void Mesh::set_primitive(Primitive primitive) {
@@ -68,6 +160,11 @@ size_t Mesh::get_indices_amount() const {
     return indices.size();
 }
 
+size_t Mesh::get_triangle_count() const {
+    if(primitive != Primitive::TRIANGLES) { return 0; }
+    return (indices.empty() ? get_vertices_amount() : indices.size()) / 3;
+}
+
 AttributeType Mesh::get_attribute_type(Attribute attribute) {
     return attributes[attribute];
 }
@@ -87,41 +184,240 @@ void Mesh::get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) co
     }
 }
 
+const AABB& Mesh::get_bounds() const {
+    return bounds;
+}
+
+unsigned int Mesh::get_vao() const {
+    return buffer == nullptr ? 0 : buffer->get_vao();
+}
+
+unsigned int Mesh::get_sort_id() const {
+    return get_vao() << 8 | (id & 0xFF);
+}
+
+const MeshBuffer* Mesh::get_buffer() const {
+    return buffer;
+}
+
+const float* Mesh::get_positions() const {
+    return get_attribute_data(ATTRIBUTE_POSITION);
+}
+
+const float* Mesh::get_attribute_data(Attribute attribute) const {
+    if(!has_attribute(attribute) || data.empty()) { return nullptr; }
+    return data.data() + get_attribute_offset(attribute);
+}
+
+unsigned int Mesh::get_stride() const {
+    return stride;
+}
+
+const std::vector<unsigned int>& Mesh::get_indices() const {
+    return indices;
+}
+
+void Mesh::generate_lods(unsigned int lod_count, float triangle_ratio) {
+    lods.clear();
+    lod_indices.clear();
+    if(primitive != Primitive::TRIANGLES || indices.empty() || lod_count < 2) { return; }
+
+    lods.push_back({ 0, static_cast<unsigned int>(indices.size()), 0.0f });
+
+    // Each level is simplified from the previous one so its error adds up to the previous one's
+    std::vector<unsigned int> previous = indices;
+
+    while(lods.size() < lod_count) {
+        const std::size_t target_index_count = static_cast<std::size_t>(previous.size() / 3 * triangle_ratio) * 3;
+
+        float error;
+        std::vector<unsigned int> level = simplify_mesh(*this, previous, target_index_count, LOD_MAX_ERROR, error);
+        if(level.empty() || level.size() > LOD_MIN_REDUCTION * previous.size()) { break; }
+
+        lods.push_back({ static_cast<unsigned int>(indices.size() + lod_indices.size()),
+                         static_cast<unsigned int>(level.size()),
+                         lods.back().error + error });
+        lod_indices.insert(lod_indices.end(), level.begin(), level.end());
+        previous = std::move(level);
+    }
+
+    if(lods.size() == 1) { lods.clear(); }
+}
+
+unsigned int Mesh::select_lod(float screen_size) const {
+    // Both the errors and the screen size are relative to the radius of the bounds
+    unsigned int lod = 0;
+    while(lod + 1 < lods.size() && lods[lod + 1].error * screen_size <= LOD_MAX_SCREEN_ERROR) { ++lod; }
+    return lod;
+}
+
+unsigned int Mesh::get_lod_count() const {
+    return lods.empty() ? 1 : lods.size();
+}
+
+void Mesh::generate_meshlets(unsigned int max_vertices, unsigned int max_triangles) {
+    meshlets.clear();
+    if(primitive != Primitive::TRIANGLES || indices.size() <= 3 * max_triangles) { return; }
+
+    meshlets = build_meshlets(*this, indices, max_vertices, max_triangles);
+}
+
+const std::vector<Meshlet>& Mesh::get_meshlets() const {
+    return meshlets;
+}
+
+unsigned int Mesh::cull_meshlets(const Frustum& frustum, const affine3x4& model, bool cull_backfaces,
+                                 std::vector<int>& counts, std::vector<const void*>& offsets) const {
+    counts.clear();
+    offsets.clear();
+
+    // World space planes n.p + d become (M^T n).x + (n.t + d) for local positions x with p = M x + t
+    vec4 local_planes[6];
+    for(unsigned int i = 0 ; i < 6 ; ++i) {
+        const vec4& plane = frustum.planes[i];
+        vec4& local_plane = local_planes[i];
+
+        local_plane.x = model(0, 0) * plane.x + model(1, 0) * plane.y + model(2, 0) * plane.z;
+        local_plane.y = model(0, 1) * plane.x + model(1, 1) * plane.y + model(2, 1) * plane.z;
+        local_plane.z = model(0, 2) * plane.x + model(1, 2) * plane.y + model(2, 2) * plane.z;
+        local_plane.w = model(0, 3) * plane.x + model(1, 3) * plane.y + model(2, 3) * plane.z + plane.w;
+
+        // Culling is conservative by the meshlets' radii so approximate normals are precise enough
+        const float squared_length = local_plane.x * local_plane.x + local_plane.y * local_plane.y
+                                     + local_plane.z * local_plane.z;
+        if(squared_length > 0.0f) { local_plane *= fast_rsqrt(squared_length); }
+    }
+
+    const vec3 camera = inverse(model) * frustum.position;
+
+    // Mirroring transforms reverse the winding of the triangles on screen
+    const vec3 column_x(model(0, 0), model(1, 0), model(2, 0));
+    const vec3 column_y(model(0, 1), model(1, 1), model(2, 1));
+    const vec3 column_z(model(0, 2), model(1, 2), model(2, 2));
+    const float winding = dot(column_x, cross(column_y, column_z)) < 0.0f ? -1.0f : 1.0f;
+
+    unsigned int visible_index_count = 0;
+    unsigned int run_end = std::numeric_limits<unsigned int>::max();
+
+    for(const Meshlet& meshlet : meshlets) {
+        bool is_visible = true;
+
+        for(const vec4& plane : local_planes) {
+            if(plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w
+               < -meshlet.radius) {
+                is_visible = false;
+                break;
+            }
+        }
+
+        // Every triangle faces away if the view direction is inside the cone opposite to the normals
+        if(is_visible && cull_backfaces) {
+            const vec3 direction = meshlet.center - camera;
+            is_visible = winding * dot(direction, meshlet.cone_axis)
+                         < meshlet.cone_cutoff * fast_sqrt(dot(direction, direction)) + meshlet.radius;
+        }
+
+        if(!is_visible) { continue; }
+
+        if(meshlet.offset == run_end) {
+            counts.back() += static_cast<int>(meshlet.count);
+        } else {
+            counts.push_back(static_cast<int>(meshlet.count));
+            offsets.push_back(reinterpret_cast<const void*>((allocation.first_index + meshlet.offset)
+                                                            * sizeof(unsigned int)));
+        }
+
+        run_end = meshlet.offset + meshlet.count;
+        visible_index_count += meshlet.count;
+    }
+
+    return visible_index_count / 3;
+}
+
+unsigned int Mesh::draw_meshlets(const Frustum& frustum, const affine3x4& model, bool cull_backfaces) const {
+    if(meshlets.empty()) {
+        draw();
+        return get_triangle_count();
+    }
+
+    const unsigned int triangle_count = cull_meshlets(frustum, model, cull_backfaces, meshlet_draw_counts,
+                                                      meshlet_draw_offsets);
+
+    if(!meshlet_draw_counts.empty() && buffer != nullptr) {
+        meshlet_draw_base_vertices.assign(meshlet_draw_counts.size(), static_cast<int>(allocation.first_vertex));
+
+        GLState::bind_vertex_array(buffer->get_vao());
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, meshlet_draw_counts.data(), GL_UNSIGNED_INT,
+                                      meshlet_draw_offsets.data(), static_cast<GLsizei>(meshlet_draw_counts.size()),
+                                      meshlet_draw_base_vertices.data());
+    }
+
+    return triangle_count;
+}
+
 void Mesh::clear() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    delete_buffers();
     data.clear();
     indices.clear();
+    lod_indices.clear();
+    lods.clear();
+    meshlets.clear();
 }
 
 void Mesh::delete_buffers() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    if(buffer != nullptr) {
+        buffer->free(allocation);
+        buffer = nullptr;
+    }
 }
 
 void Mesh::apply_model_matrix(const mat4& model) {
-    mat3 normals_model = transpose_inverse(model);
-
-    const unsigned int pos_offset = get_attribute_offset(ATTRIBUTE_POSITION);
-    const unsigned int normal_offset = get_attribute_offset(ATTRIBUTE_NORMAL);
+    const std::size_t vertex_count = data.size() / stride;
 
-    for(unsigned int i = 0 ; i < data.size() ; i += stride) {
-        if(has_attribute(ATTRIBUTE_POSITION)) {
-            vec3* pos = reinterpret_cast<vec3*>(&data[pos_offset + i]);
-            *pos = model * vec4(pos->x, pos->y, pos->z, 1.0f);
-        }
+    if(has_attribute(ATTRIBUTE_POSITION)) {
+        float* positions = data.data() + get_attribute_offset(ATTRIBUTE_POSITION);
+        transform_points(model, positions, stride, positions, stride, vertex_count);
+    }
 
-        if(has_attribute(ATTRIBUTE_NORMAL)) {
-            vec3* normal = reinterpret_cast<vec3*>(&data[normal_offset + i]);
-            *normal = normalize(normals_model * (*normal));
-        }
+    if(has_attribute(ATTRIBUTE_NORMAL)) {
+        float* normals = data.data() + get_attribute_offset(ATTRIBUTE_NORMAL);
+        transform_normals(transpose_inverse(model), normals, stride, normals, stride, vertex_count);
     }
 
     bind_buffers();
 }
 
+void Mesh::append_transformed(const Mesh& mesh, const mat4& model, const mat3& normal_matrix) {
+    if(data.empty() && indices.empty()) {
+        primitive = mesh.primitive;
+        std::copy(mesh.attributes, mesh.attributes + ATTRIBUTE_AMOUNT, attributes);
+        stride = mesh.stride;
+        active_attributes_count = mesh.active_attributes_count;
+    } else if(primitive != mesh.primitive || !std::equal(attributes, attributes + ATTRIBUTE_AMOUNT, mesh.attributes)) {
+        throw std::runtime_error("Trying to append a mesh with a different primitive or different attributes.");
+    }
+
+    const std::size_t first_vertex = get_vertices_amount();
+    const std::size_t vertex_count = mesh.get_vertices_amount();
+    data.insert(data.end(), mesh.data.begin(), mesh.data.end());
+
+    if(has_attribute(ATTRIBUTE_POSITION)) {
+        float* positions = data.data() + first_vertex * stride + get_attribute_offset(ATTRIBUTE_POSITION);
+        transform_points(model, positions, stride, positions, stride, vertex_count);
+    }
+
+    if(has_attribute(ATTRIBUTE_NORMAL)) {
+        float* normals = data.data() + first_vertex * stride + get_attribute_offset(ATTRIBUTE_NORMAL);
+        transform_normals(normal_matrix, normals, stride, normals, stride, vertex_count);
+    }
+
+    if(mesh.indices.empty()) {
+        for(std::size_t i = 0 ; i < vertex_count ; ++i) { indices.push_back(first_vertex + i); }
+    } else {
+        for(unsigned int index : mesh.indices) { indices.push_back(first_vertex + index); }
+    }
+}
+
 void Mesh::enable_attribute(Attribute attribute, AttributeType type) {
     if(type == AttributeType::NONE) { type = get_default_attribute_type(attribute); }
 
@@ -167,34 +463,29 @@ void Mesh::add_face(unsigned int topL, unsigned int bottomL, unsigned int bottom
 }
 
 void Mesh::bind_buffers() {
-    /* VAO */
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    /* Bounds */
+    if(has_attribute(ATTRIBUTE_POSITION) && !data.empty()) {
+        vec3 min(std::numeric_limits<float>::max());
+        vec3 max(std::numeric_limits<float>::lowest());
+        get_min_max_axis_aligned_coordinates(min, max);
+        bounds = AABB(min, max);
+    }
 
-    /* VBO */
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+    /* Allocation */
+    delete_buffers();
+    if(stride == 0 || data.empty()) { return; }
 
-    /* Vertex Attributes */
-    float stride_in_bytes = stride * sizeof(float);
-    unsigned int offset = 0;
+    buffer = &AssetManager::get_mesh_buffer(attributes);
+    allocation = buffer->allocate(data.size() / stride, indices.size() + lod_indices.size());
+    id = bound_mesh_count++;
 
-    for(unsigned int attr = 0 ; attr < ATTRIBUTE_AMOUNT ; ++attr) {
-        AttributeType type = attributes[attr];
-        if(type != AttributeType::NONE) {
-            unsigned int size = get_attribute_type_count(type);
-            glVertexAttribPointer(attr, size, GL_FLOAT, false, stride_in_bytes, reinterpret_cast<void*>(offset));
-            glEnableVertexAttribArray(attr);
-            offset += size * sizeof(float);
-        }
-    }
+    /* Vertices & Indices */
+    buffer->upload_vertices(allocation.first_vertex, data.data(), allocation.vertex_count);
 
-    /* Indices & EBO */
-    if(!indices.empty()) {
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint), indices.data(), GL_STATIC_DRAW);
+    // The levels of detail are stored after the full mesh's indices
+    if(!indices.empty()) { buffer->upload_indices(allocation.first_index, indices.data(), indices.size()); }
+    if(!lod_indices.empty()) {
+        buffer->upload_indices(allocation.first_index + indices.size(), lod_indices.data(), lod_indices.size());
     }
 }
 
@@ -221,13 +512,36 @@ void Mesh::push_value(const vec4& value) {
 }
 
 void Mesh::push_values(const float* values, unsigned int n) {
-    for(unsigned int i = 0 ; i < n ; ++i) { data.push_back(values[i]); }
+    data.insert(data.end(), values, values + n);
 }
 
 void Mesh::push_indices_buffer(const std::vector<unsigned int>& indices) {
     this->indices.insert(this->indices.end(), indices.begin(), indices.end());
 }
 
+void Mesh::push_indices(const unsigned int* indices, unsigned int n) {
+    this->indices.insert(this->indices.end(), indices, indices + n);
+}
+
+bool Mesh::can_be_drawn() const {
+    if(primitive == Primitive::NONE) {
+        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have a primitive.\n";
+        return false;
+    }
+
+    if(stride == 0) {
+        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have any active attributes.\n";
+        return false;
+    }
+
+    if(buffer == nullptr) {
+        std::cout << "[WARNING] Mesh wasn't drawn as its buffers aren't bound.\n";
+        return false;
+    }
+
+    return true;
+}
+
 unsigned int Mesh::get_attribute_offset(Attribute attribute) const {
     unsigned int offset = 0;
 
@@ -0,0 +1,188 @@
+/***************************************************************************************************
+ * @file  MeshBuffer.cpp
+ * @brief Implementation of the MeshBuffer class
+ **************************************************************************************************/
+
+#include "mesh/MeshBuffer.hpp"
+
+#include <algorithm>
+#include "glad/glad.h"
+#include "GLState.hpp"
+
+/**
+ * @brief The amount of vertices that fit in the vertex buffer when it's created.
+ */
+static constexpr unsigned int MESH_BUFFER_MIN_VERTEX_CAPACITY = 1 << 16;
+
+/**
+ * @brief The amount of indices that fit in the index buffer when it's created.
+ */
+static constexpr unsigned int MESH_BUFFER_MIN_INDEX_CAPACITY = 3 << 16;
+
+MeshBuffer::MeshBuffer(const AttributeType* attributes)
+    : stride(0), VAO(0), VBO(0), EBO(0), vertex_capacity(0), index_capacity(0) {
+    for(unsigned int attribute = 0 ; attribute < ATTRIBUTE_AMOUNT ; ++attribute) {
+        this->attributes[attribute] = attributes[attribute];
+        stride += get_attribute_type_count(attributes[attribute]);
+    }
+}
+
+MeshBuffer::~MeshBuffer() {
+    if(VAO != 0) {
+        GLState::forget_vertex_array(VAO);
+        glDeleteVertexArrays(1, &VAO);
+    }
+    if(VBO != 0) { glDeleteBuffers(1, &VBO); }
+    if(EBO != 0) { glDeleteBuffers(1, &EBO); }
+}
+
+unsigned int MeshBuffer::get_layout_key(const AttributeType* attributes) {
+    // Attribute types fit in 3 bits
+    unsigned int key = 0;
+    for(unsigned int attribute = 0 ; attribute < ATTRIBUTE_AMOUNT ; ++attribute) {
+        key = key << 3 | static_cast<unsigned int>(attributes[attribute]);
+    }
+
+    return key;
+}
+
+MeshAllocation MeshBuffer::allocate(unsigned int vertex_count, unsigned int index_count) {
+    if(VAO == 0) { glGenVertexArrays(1, &VAO); }
+
+    const unsigned int previous_vertex_capacity = vertex_capacity;
+    const unsigned int previous_index_capacity = index_capacity;
+
+    MeshAllocation allocation{ 0, vertex_count, 0, index_count };
+    allocation.first_vertex = allocate_range(free_vertex_ranges, vertex_capacity, MESH_BUFFER_MIN_VERTEX_CAPACITY,
+                                             vertex_count);
+    if(index_count > 0) {
+        allocation.first_index = allocate_range(free_index_ranges, index_capacity, MESH_BUFFER_MIN_INDEX_CAPACITY,
+                                                index_count);
+    }
+
+    if(vertex_capacity != previous_vertex_capacity || index_capacity != previous_index_capacity) {
+        const std::size_t vertex_size = stride * sizeof(float);
+        if(vertex_capacity != previous_vertex_capacity) {
+            grow_buffer(VBO, previous_vertex_capacity * vertex_size, vertex_capacity * vertex_size);
+        }
+        if(index_capacity != previous_index_capacity) {
+            grow_buffer(EBO, previous_index_capacity * sizeof(unsigned int), index_capacity * sizeof(unsigned int));
+        }
+
+        attach_buffers();
+    }
+
+    return allocation;
+}
+
+void MeshBuffer::upload_vertices(unsigned int first_vertex, const float* vertices, unsigned int vertex_count) const {
+    // The copy target doesn't change the bindings of the vertex array
+    const std::size_t vertex_size = stride * sizeof(float);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, first_vertex * vertex_size, vertex_count * vertex_size, vertices);
+}
+
+void MeshBuffer::upload_indices(unsigned int first_index, const unsigned int* indices, unsigned int index_count) const {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, first_index * sizeof(unsigned int), index_count * sizeof(unsigned int),
+                    indices);
+}
+
+void MeshBuffer::free(const MeshAllocation& allocation) {
+    free_range(free_vertex_ranges, allocation.first_vertex, allocation.vertex_count);
+    if(allocation.index_count > 0) { free_range(free_index_ranges, allocation.first_index, allocation.index_count); }
+}
+
+unsigned int MeshBuffer::get_vao() const {
+    return VAO;
+}
+
+unsigned int MeshBuffer::get_vertex_capacity() const {
+    return vertex_capacity;
+}
+
+unsigned int MeshBuffer::get_index_capacity() const {
+    return index_capacity;
+}
+
+unsigned int MeshBuffer::allocate_range(std::vector<Range>& free_ranges, unsigned int& capacity,
+                                        unsigned int min_capacity, unsigned int count) {
+    auto range = std::find_if(free_ranges.begin(), free_ranges.end(), [count](const Range& range) {
+        return range.count >= count;
+    });
+
+    if(range == free_ranges.end()) {
+        // The free range ending the buffer, if there's one, is extended by the growth
+        const bool ends_free = !free_ranges.empty() && free_ranges.back().offset + free_ranges.back().count == capacity;
+        const unsigned int used_end = ends_free ? free_ranges.back().offset : capacity;
+        const unsigned int new_capacity = std::max({ min_capacity, 2 * capacity, used_end + count });
+
+        free_range(free_ranges, capacity, new_capacity - capacity);
+        capacity = new_capacity;
+        range = free_ranges.end() - 1;
+    }
+
+    const unsigned int offset = range->offset;
+    range->offset += count;
+    range->count -= count;
+    if(range->count == 0) { free_ranges.erase(range); }
+
+    return offset;
+}
+
+void MeshBuffer::free_range(std::vector<Range>& free_ranges, unsigned int offset, unsigned int count) {
+    if(count == 0) { return; }
+
+    auto next = std::find_if(free_ranges.begin(), free_ranges.end(), [offset](const Range& range) {
+        return range.offset > offset;
+    });
+
+    const bool merges_previous = next != free_ranges.begin() && (next - 1)->offset + (next - 1)->count == offset;
+    const bool merges_next = next != free_ranges.end() && offset + count == next->offset;
+
+    if(merges_previous && merges_next) {
+        (next - 1)->count += count + next->count;
+        free_ranges.erase(next);
+    } else if(merges_previous) {
+        (next - 1)->count += count;
+    } else if(merges_next) {
+        next->offset = offset;
+        next->count += count;
+    } else {
+        free_ranges.insert(next, Range{ offset, count });
+    }
+}
+
+void MeshBuffer::grow_buffer(unsigned int& buffer, std::size_t size, std::size_t new_size) {
+    unsigned int new_buffer;
+    glGenBuffers(1, &new_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_size, nullptr, GL_STATIC_DRAW);
+
+    if(buffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = new_buffer;
+}
+
+void MeshBuffer::attach_buffers() const {
+    GLState::bind_vertex_array(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    const unsigned int stride_in_bytes = stride * sizeof(float);
+    unsigned int offset = 0;
+
+    for(unsigned int attribute = 0 ; attribute < ATTRIBUTE_AMOUNT ; ++attribute) {
+        const unsigned int size = get_attribute_type_count(attributes[attribute]);
+        if(size > 0) {
+            glVertexAttribPointer(attribute, size, GL_FLOAT, false, stride_in_bytes, reinterpret_cast<void*>(offset));
+            glEnableVertexAttribArray(attribute);
+            offset += size * sizeof(float);
+        }
+    }
+
+    if(EBO != 0) { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); }
+}
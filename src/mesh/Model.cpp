@@ -5,6 +5,7 @@
 
 #include "mesh/Model.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <ranges>
 
@@ -25,6 +26,8 @@ Model::Model(const std::filesystem::path& path) {
     }
 
     if(extension == ".obj") { parse_obj_file(path); }
+
+    compute_bounds();
 }
 
 void Model::parse_obj_file(const std::filesystem::path& path) {
@@ -234,19 +237,30 @@ void Model::add_mesh(const std::vector<vec3>& positions,
         mesh.add_triangle(indices[0], indices[1], indices[2]);
     }
 
+    mesh.generate_lods();
     mesh.bind_buffers();
 }
 
-void Model::draw(const Shader& shader) {
+void Model::draw(const Shader& shader, float screen_size) {
     shader.use();
     for(unsigned int i = 0 ; i < meshes.size() ; ++i) {
         materials[i].update_shader_uniforms(shader);
-        meshes[i].draw();
+        meshes[i].draw(select_lod(i, screen_size));
     }
 }
 
+unsigned int Model::select_lod(unsigned int mesh_index, float screen_size) const {
+    // The screen size of each mesh is the model's scaled by the ratio of their radii
+    const float radius = length(bounds.extent);
+    const float screen_size_per_radius = radius > 0.0f ? screen_size / radius : screen_size;
+
+    const Mesh& mesh = meshes[mesh_index];
+    return mesh.select_lod(screen_size_per_radius * length(mesh.get_bounds().extent));
+}
+
 void Model::apply_model_matrix(const mat4& model) {
     for(Mesh& mesh : meshes) { mesh.apply_model_matrix(model); }
+    compute_bounds();
 }
 
 void Model::get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) const {
@@ -254,3 +268,24 @@ void Model::get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) c
         meshes[i].get_min_max_axis_aligned_coordinates(minimum, maximum);
     }
 }
+
+const AABB& Model::get_bounds() const {
+    return bounds;
+}
+
+void Model::compute_bounds() {
+    if(meshes.empty()) { return; }
+
+    vec3 min = meshes[0].get_bounds().get_min_point();
+    vec3 max = meshes[0].get_bounds().get_max_point();
+
+    for(unsigned int i = 1 ; i < meshes.size() ; ++i) {
+        const vec3 mesh_min = meshes[i].get_bounds().get_min_point();
+        const vec3 mesh_max = meshes[i].get_bounds().get_max_point();
+
+        min = vec3(std::min(min.x, mesh_min.x), std::min(min.y, mesh_min.y), std::min(min.z, mesh_min.z));
+        max = vec3(std::max(max.x, mesh_max.x), std::max(max.y, mesh_max.y), std::max(max.z, mesh_max.z));
+    }
+
+    bounds = AABB(min, max);
+}
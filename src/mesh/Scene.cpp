@@ -5,14 +5,33 @@
 
 #include "mesh/Scene.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <ranges>
 
 #include "AssetManager.hpp"
 #include "debug.hpp"
+#include "GLState.hpp"
 #include "maths/functions.hpp"
+#include "maths/geometry.hpp"
 #include "utility/LifetimeLogger.hpp"
 
-MeshInfo::MeshInfo() : material(nullptr) { }
+/**
+ * @brief The maximum amount of primitives of a scene rasterized as occluders each frame.
+ */
+static constexpr unsigned int SCENE_MAX_OCCLUDERS = 32;
+
+/**
+ * @brief Primitives with more triangles are too expensive to rasterize as occluders.
+ */
+static constexpr unsigned int SCENE_MAX_OCCLUDER_TRIANGLES = 4096;
+
+/**
+ * @brief The minimum part of the screen covered by the screen rectangle of an occluding primitive.
+ */
+static constexpr float SCENE_MIN_OCCLUDER_COVERAGE = 0.01f;
+
+MeshInfo::MeshInfo() : material(nullptr), last_failed_frustum_plane(0) { }
 
 MeshInfo::~MeshInfo() {
     if(material != nullptr) {
@@ -23,8 +42,19 @@ MeshInfo::~MeshInfo() {
 }
 
 Scene::Scene(const std::filesystem::path& path)
-    : meshes(nullptr), meshes_count(0), primitives_count(nullptr) {
+    : is_pvs_enabled(true), meshes(nullptr), meshes_count(0), primitives_count(nullptr), pvs_culled_primitive_count(0),
+      occluded_primitive_count(0), pvs_path(std::filesystem::path(path).replace_extension(".pvs")), transparent_count(0) {
     load(path);
+
+    if(std::filesystem::exists(pvs_path)) {
+        pvs.load(pvs_path);
+
+        // The scene changed since the sets were baked
+        if(pvs.get_object_count() != indices_order.size()) {
+            std::cout << "[WARNING] PVS file '" << pvs_path.string() << "' wasn't used as it doesn't match the scene.\n";
+            pvs = PVS();
+        }
+    }
 }
 
 Scene::~Scene() {
@@ -38,48 +68,207 @@ Scene::~Scene() {
 
 void Scene::draw(const mat4& view_projection_matrix, const Transform& transform) const {
     for(const auto& [mesh_id, primitive_id] : indices_order) {
-        const MRMaterial* material = meshes[mesh_id][primitive_id].material;
-        const Shader& shader = material == nullptr
-                                   ? AssetManager::get_relevant_shader_from_mesh(meshes[mesh_id][primitive_id].mesh)
-                                   : AssetManager::get_shader("metallic-roughness");
-        shader.use();
+        draw_primitive(view_projection_matrix, transform, meshes[mesh_id][primitive_id]);
+    }
+}
 
-        const mat4& global_model = transform.get_global_model_const_reference();
-        shader.set_uniform_if_exists("u_model", global_model);
+unsigned int Scene::enqueue(RenderQueue& render_queue, const Entity* entity, const mat4& view_projection_matrix,
+                            const Transform& transform, const Frustum& frustum,
+                            const OcclusionCuller* occlusion_culler) const {
+    const affine3x4& global_model = transform.get_global_affine_model();
+    unsigned int enqueued_primitives = 0;
+    pvs_culled_primitive_count = 0;
+    occluded_primitive_count = 0;
 
-        int u_mvp_location = shader.get_uniform_location("u_mvp");
-        if(u_mvp_location != -1) {
-            Shader::set_uniform(u_mvp_location, view_projection_matrix * global_model);
-        }
+    auto enqueue_if_visible = [&](unsigned int index) {
+        const auto& [mesh_id, primitive_id] = indices_order[index];
+        const MeshInfo& mesh_info = meshes[mesh_id][primitive_id];
+        const AABB world_bounds = mesh_info.bounds.transformed(global_model);
+
+        if(!world_bounds.is_in_frustum(frustum, mesh_info.last_failed_frustum_plane)) { return; }
+
+        // Primitives too small to be seen are dropped, the other ones use a level of detail matching
+        // their size
+        const float screen_size = world_bounds.get_screen_size(view_projection_matrix);
+        if(screen_size < SMALL_FEATURE_SCREEN_SIZE) { return; }
 
-        int u_normals_model_matrix_location = shader.get_uniform_location("u_normals_model_matrix");
-        if(u_normals_model_matrix_location != -1) {
-            Shader::set_uniform(u_normals_model_matrix_location, transpose_inverse(global_model));
+        if(occlusion_culler != nullptr && !occlusion_culler->is_visible(world_bounds)) {
+            ++occluded_primitive_count;
+            return;
         }
 
-        shader.set_uniform_if_exists("u_color", vec4(1.0f, 0.0f, 1.0f, 1.0f));
-
-        if(material != nullptr) { // mettalic roughness
-            material->base_color_map.bind(0);
-            material->metallic_roughness_map.bind(1);
-
-            shader.set_uniform_if_exists("u_material.base_color", material->base_color);
-            shader.set_uniform_if_exists("u_material.metallic", material->metallic);
-            shader.set_uniform_if_exists("u_material.roughness", material->roughness);
-            shader.set_uniform_if_exists("u_material.reflectance", material->reflectance);
-        } else { // blinn phong
-            shader.set_uniform_if_exists("u_ambient", vec3(1.0f));
-            shader.set_uniform_if_exists("u_diffuse", vec3(1.0f));
-            shader.set_uniform_if_exists("u_specular", vec3(1.0f));
-            shader.set_uniform_if_exists("u_specular_exponent", 10.0f);
-            int u_diffuse_map_location = shader.get_uniform_location("u_diffuse_map");
-            if(u_diffuse_map_location != -1) {
-                AssetManager::get_texture("default").bind(0);
+        const MRMaterial* material = mesh_info.material;
+        const Shader& shader = material == nullptr
+                                   ? AssetManager::get_relevant_shader_from_mesh(mesh_info.mesh)
+                                   : AssetManager::get_shader("metallic-roughness");
+        const RenderPass pass = index < indices_order.size() - transparent_count ? RENDER_PASS_OPAQUE
+                                                                                  : RENDER_PASS_TRANSPARENT;
+
+        const uint64_t key = RenderQueue::make_key(pass, shader.get_id(),
+                                                   material == nullptr ? 0 : material->base_color_map.get_id(),
+                                                   RenderQueue::get_material_id(material),
+                                                   mesh_info.mesh.get_sort_id(), length(world_bounds.center - frustum.position));
+        render_queue.push(key, entity, index, mesh_info.mesh.select_lod(screen_size));
+        ++enqueued_primitives;
+    };
+
+    // The sets are in the scene's local space
+    const std::vector<uint64_t>* potentially_visible = nullptr;
+    if(is_pvs_enabled && !pvs.is_empty()) {
+        potentially_visible = pvs.find_visible_objects(inverse(global_model) * frustum.position);
+    }
+
+    if(potentially_visible == nullptr) {
+        for(unsigned int i = 0 ; i < indices_order.size() ; ++i) { enqueue_if_visible(i); }
+    } else {
+        // Only the set bits are visited
+        unsigned int potentially_visible_count = 0;
+        for(unsigned int word = 0 ; word < potentially_visible->size() ; ++word) {
+            for(uint64_t bits = (*potentially_visible)[word] ; bits != 0 ; bits &= bits - 1) {
+                enqueue_if_visible(64 * word + std::countr_zero(bits));
             }
+            potentially_visible_count += std::popcount((*potentially_visible)[word]);
         }
+        pvs_culled_primitive_count = indices_order.size() - potentially_visible_count;
+    }
+
+    return enqueued_primitives;
+}
+
+unsigned int Scene::rasterize_occluders(OcclusionCuller& occlusion_culler, const Transform& transform,
+                                        const Frustum& frustum) const {
+    const affine3x4& global_model = transform.get_global_affine_model();
 
-        meshes[mesh_id][primitive_id].mesh.draw();
+    // Chooses the opaque primitives covering the most of the screen that are cheap enough to rasterize
+    occluders.clear();
+    for(unsigned int i = 0 ; i < indices_order.size() - transparent_count ; ++i) {
+        const auto& [mesh_id, primitive_id] = indices_order[i];
+        const MeshInfo& mesh_info = meshes[mesh_id][primitive_id];
+
+        const unsigned int triangle_count = mesh_info.mesh.get_triangle_count();
+        if(triangle_count == 0 || triangle_count > SCENE_MAX_OCCLUDER_TRIANGLES) { continue; }
+
+        const AABB world_bounds = mesh_info.bounds.transformed(global_model);
+        if(!world_bounds.is_in_frustum(frustum, mesh_info.last_failed_frustum_plane)) { continue; }
+
+        const float coverage = occlusion_culler.get_screen_coverage(world_bounds);
+        if(coverage >= SCENE_MIN_OCCLUDER_COVERAGE) { occluders.emplace_back(coverage, i); }
     }
+
+    const unsigned int occluder_count = std::min<std::size_t>(occluders.size(), SCENE_MAX_OCCLUDERS);
+    std::partial_sort(occluders.begin(), occluders.begin() + occluder_count, occluders.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for(unsigned int i = 0 ; i < occluder_count ; ++i) {
+        const auto& [mesh_id, primitive_id] = indices_order[occluders[i].second];
+        occlusion_culler.rasterize_mesh(global_model, meshes[mesh_id][primitive_id].mesh);
+    }
+
+    return occluder_count;
+}
+
+unsigned int Scene::draw_packet(const DrawPacket& packet, const mat4& view_projection_matrix, const Transform& transform,
+                                const Frustum& frustum) const {
+    const auto& [mesh_id, primitive_id] = indices_order[packet.index];
+    const MeshInfo& mesh_info = meshes[mesh_id][primitive_id];
+
+    if(packet.lod == 0 && !mesh_info.mesh.get_meshlets().empty()) {
+        // Backfacing meshlets are only invisible if backfacing triangles are
+        return mesh_info.mesh.get_triangle_count()
+               - draw_primitive(view_projection_matrix, transform, mesh_info, 0, &frustum,
+                                GLState::is_face_culling_enabled());
+    }
+
+    draw_primitive(view_projection_matrix, transform, mesh_info, packet.lod);
+    return 0;
+}
+
+unsigned int Scene::get_primitive_count() const {
+    return indices_order.size();
+}
+
+const AABB& Scene::get_bounds() const {
+    return bounds;
+}
+
+unsigned int Scene::get_pvs_culled_primitive_count() const {
+    return pvs_culled_primitive_count;
+}
+
+unsigned int Scene::get_occluded_primitive_count() const {
+    return occluded_primitive_count;
+}
+
+void Scene::bake_pvs(unsigned int resolution) {
+    LifetimeLogger lifetime_logger("Baked PVS in ");
+
+    std::vector<const Mesh*> objects;
+    std::vector<bool> are_occluders;
+    objects.reserve(indices_order.size());
+    are_occluders.reserve(indices_order.size());
+
+    for(unsigned int i = 0 ; i < indices_order.size() ; ++i) {
+        objects.push_back(&meshes[indices_order[i].x][indices_order[i].y].mesh);
+        are_occluders.push_back(i < indices_order.size() - transparent_count);
+    }
+
+    pvs.bake(objects, are_occluders, resolution);
+    pvs.save(pvs_path);
+}
+
+const PVS& Scene::get_pvs() const {
+    return pvs;
+}
+
+unsigned int Scene::draw_primitive(const mat4& view_projection_matrix, const Transform& transform,
+                                   const MeshInfo& mesh_info, unsigned int lod, const Frustum* frustum,
+                                   bool cull_backfaces) {
+    const MRMaterial* material = mesh_info.material;
+    const Shader& shader = material == nullptr
+                               ? AssetManager::get_relevant_shader_from_mesh(mesh_info.mesh)
+                               : AssetManager::get_shader("metallic-roughness");
+    shader.use();
+
+    const affine3x4& global_model = transform.get_global_affine_model();
+    shader.set_uniform_if_exists("u_model", global_model.get_matrix());
+
+    int u_mvp_location = shader.get_uniform_location("u_mvp");
+    if(u_mvp_location != -1) {
+        Shader::set_uniform(u_mvp_location, view_projection_matrix * global_model);
+    }
+
+    int u_normals_model_matrix_location = shader.get_uniform_location("u_normals_model_matrix");
+    if(u_normals_model_matrix_location != -1) {
+        Shader::set_uniform(u_normals_model_matrix_location, transform.get_normal_matrix());
+    }
+
+    shader.set_uniform_if_exists("u_color", vec4(1.0f, 0.0f, 1.0f, 1.0f));
+
+    if(material != nullptr) { // mettalic roughness
+        material->base_color_map.bind(0);
+        material->metallic_roughness_map.bind(1);
+
+        shader.set_uniform_if_exists("u_material.base_color", material->base_color);
+        shader.set_uniform_if_exists("u_material.metallic", material->metallic);
+        shader.set_uniform_if_exists("u_material.roughness", material->roughness);
+        shader.set_uniform_if_exists("u_material.reflectance", material->reflectance);
+    } else { // blinn phong
+        shader.set_uniform_if_exists("u_ambient", vec3(1.0f));
+        shader.set_uniform_if_exists("u_diffuse", vec3(1.0f));
+        shader.set_uniform_if_exists("u_specular", vec3(1.0f));
+        shader.set_uniform_if_exists("u_specular_exponent", 10.0f);
+        int u_diffuse_map_location = shader.get_uniform_location("u_diffuse_map");
+        if(u_diffuse_map_location != -1) {
+            AssetManager::get_texture("default").bind(0);
+        }
+    }
+
+    if(frustum != nullptr && lod == 0) {
+        return mesh_info.mesh.draw_meshlets(*frustum, global_model, cull_backfaces);
+    }
+
+    mesh_info.mesh.draw(lod);
+    return mesh_info.mesh.get_triangle_count();
 }
 
 void Scene::check_cgltf_result(cgltf_result result, const std::string& error_message) {
@@ -293,8 +482,23 @@ void Scene::load(const std::filesystem::path& path) {
                 }
             }
 
+            mesh.generate_meshlets();
+            mesh.generate_lods();
             mesh.bind_buffers();
 
+            // glTF requires the position accessor to have a min and a max, the mesh's bounds are only
+            // used if they're missing
+            meshes[i][j].bounds = mesh.get_bounds();
+            for(unsigned int k = 0 ; k < c_primitive.attributes_count ; ++k) {
+                const cgltf_accessor* c_accessor = c_primitive.attributes[k].data;
+
+                if(c_primitive.attributes[k].type == cgltf_attribute_type_position && c_accessor->has_min
+                   && c_accessor->has_max) {
+                    meshes[i][j].bounds = AABB(vec3(c_accessor->min[0], c_accessor->min[1], c_accessor->min[2]),
+                                               vec3(c_accessor->max[0], c_accessor->max[1], c_accessor->max[2]));
+                }
+            }
+
             delete[] attributes;
 
 #ifdef DEBUG_LOG_GLTF_READ_INFO
@@ -305,7 +509,13 @@ void Scene::load(const std::filesystem::path& path) {
 
     cgltf_free(data);
 
+    transparent_count = transparent_indices_order.size();
     for(const vector2<unsigned int>& index : transparent_indices_order) { indices_order.push_back(index); }
+
+    for(unsigned int i = 0 ; i < indices_order.size() ; ++i) {
+        const AABB& primitive_bounds = meshes[indices_order[i].x][indices_order[i].y].bounds;
+        bounds = i == 0 ? primitive_bounds : bounds.merged(primitive_bounds);
+    }
 }
 
 void Scene::read_attribute(AttributeInfo& attribute_info, const cgltf_attribute& c_attribute) {
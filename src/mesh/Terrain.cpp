@@ -6,6 +6,7 @@
 #include "mesh/Terrain.hpp"
 
 #include <glad/glad.h>
+#include "GLState.hpp"
 
 Terrain::Terrain(const Shader& shader, float chunk_size, unsigned int chunks_on_line)
     : shader(shader), chunk_size(chunk_size), chunks_on_line(chunks_on_line) {
@@ -27,7 +28,7 @@ Terrain::Terrain(const Shader& shader, float chunk_size, unsigned int chunks_on_
 
     /* VAO */
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    GLState::bind_vertex_array(VAO);
 
     /* VBO */
     glGenBuffers(1, &VBO);
@@ -45,6 +46,7 @@ Terrain::Terrain(const Shader& shader, float chunk_size, unsigned int chunks_on_
 }
 
 Terrain::~Terrain() {
+    GLState::forget_vertex_array(VAO);
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
@@ -54,7 +56,7 @@ void Terrain::draw(const mat4& view_projection) const {
     shader.use();
     shader.set_uniform("u_view_projection", view_projection);
     shader.set_uniform("u_chunk_size", chunk_size);
-    glBindVertexArray(VAO);
+    GLState::bind_vertex_array(VAO);
     glDrawElements(GL_PATCHES, indices.size(), GL_UNSIGNED_INT, nullptr);
 }
 
@@ -65,7 +67,7 @@ void Terrain::draw(const Frustum& frustum, const mat4& view_projection) const {
     shader.set_uniform("u_chunk_size", chunk_size);
     shader.set_uniform("u_frustum_view_projection_matrix", frustum.view_projection);
 
-    glBindVertexArray(VAO);
+    GLState::bind_vertex_array(VAO);
     glDrawElements(GL_PATCHES, indices.size(), GL_UNSIGNED_INT, nullptr);
 }
 
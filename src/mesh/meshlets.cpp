@@ -0,0 +1,200 @@
+/***************************************************************************************************
+ * @file  meshlets.cpp
+ * @brief Implementation of functions aimed at splitting triangle meshes into meshlets
+ **************************************************************************************************/
+
+#include "mesh/meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "maths/geometry.hpp"
+
+/**
+ * @brief Calculates the bounding sphere and the normal cone of a meshlet.
+ * @param positions The positions of the vertices.
+ * @param stride The amount of floats between two consecutive positions.
+ * @param indices The indices of the meshlet's triangles.
+ * @param meshlet The meshlet, whose offset and count need to be set.
+ */
+static void compute_meshlet_bounds(const float* positions, unsigned int stride,
+                                   const std::vector<unsigned int>& indices, Meshlet& meshlet) {
+    auto get_position = [&](unsigned int index) {
+        const float* position = positions + static_cast<std::size_t>(index) * stride;
+        return vec3(position[0], position[1], position[2]);
+    };
+
+    /* Bounding Sphere */
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+
+    for(unsigned int i = meshlet.offset ; i < meshlet.offset + meshlet.count ; ++i) {
+        const vec3 position = get_position(indices[i]);
+        min = vec3(std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z));
+        max = vec3(std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z));
+    }
+
+    meshlet.center = 0.5f * (min + max);
+    meshlet.radius = 0.0f;
+
+    for(unsigned int i = meshlet.offset ; i < meshlet.offset + meshlet.count ; ++i) {
+        meshlet.radius = std::max(meshlet.radius, length(get_position(indices[i]) - meshlet.center));
+    }
+
+    /* Normal Cone */
+    std::vector<vec3> normals;
+    normals.reserve(meshlet.count / 3);
+    vec3 normal_sum(0.0f);
+
+    for(unsigned int i = meshlet.offset ; i < meshlet.offset + meshlet.count ; i += 3) {
+        const vec3 a = get_position(indices[i]);
+        const vec3 normal = cross(get_position(indices[i + 1]) - a, get_position(indices[i + 2]) - a);
+        const float normal_length = length(normal);
+
+        // Degenerate triangles can't be seen so they don't restrict the cone
+        if(normal_length > 0.0f) {
+            normals.push_back(normal / normal_length);
+            normal_sum += normals.back();
+        }
+    }
+
+    const float sum_length = length(normal_sum);
+    meshlet.cone_axis = sum_length > 0.0f ? normal_sum / sum_length : vec3(0.0f, 0.0f, 1.0f);
+    meshlet.cone_cutoff = 1.0f;
+
+    if(sum_length > 0.0f) {
+        float min_dot = 1.0f;
+        for(const vec3& normal : normals) { min_dot = std::min(min_dot, dot(meshlet.cone_axis, normal)); }
+
+        // Cones wider than a half-space face the camera from every direction
+        if(min_dot > 0.0f) { meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot); }
+    }
+}
+
+std::vector<Meshlet> build_meshlets(const Mesh& mesh,
+                                    std::vector<unsigned int>& indices,
+                                    unsigned int max_vertices,
+                                    unsigned int max_triangles) {
+    std::vector<Meshlet> meshlets;
+
+    const float* positions = mesh.get_positions();
+    if(mesh.get_primitive() != Primitive::TRIANGLES || positions == nullptr || indices.size() < 3
+       || max_vertices < 3 || max_triangles == 0) {
+        return meshlets;
+    }
+
+    const std::size_t triangle_count = indices.size() / 3;
+    const std::size_t vertex_count = mesh.get_vertices_amount();
+
+    /* Triangles Adjacent To Each Vertex */
+    std::vector<unsigned int> adjacency_offsets(vertex_count + 1, 0);
+    for(std::size_t i = 0 ; i < triangle_count * 3 ; ++i) { ++adjacency_offsets[indices[i] + 1]; }
+    for(std::size_t i = 0 ; i < vertex_count ; ++i) { adjacency_offsets[i + 1] += adjacency_offsets[i]; }
+
+    std::vector<unsigned int> adjacent_triangles(triangle_count * 3);
+    {
+        std::vector<unsigned int> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for(std::size_t i = 0 ; i < triangle_count * 3 ; ++i) {
+            adjacent_triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+
+    /* Greedy Growth */
+    constexpr unsigned int NONE = std::numeric_limits<unsigned int>::max();
+
+    std::vector<bool> is_emitted(triangle_count, false);
+    std::vector<unsigned int> vertex_meshlet(vertex_count, NONE); // The last meshlet that used each vertex
+    std::vector<unsigned int> meshlet_vertices;
+    std::vector<unsigned int> reordered;
+    reordered.reserve(triangle_count * 3);
+
+    auto get_position = [&](unsigned int index) {
+        const float* position = positions + static_cast<std::size_t>(index) * mesh.get_stride();
+        return vec3(position[0], position[1], position[2]);
+    };
+
+    auto count_new_vertices = [&](std::size_t triangle) {
+        const unsigned int meshlet = static_cast<unsigned int>(meshlets.size());
+        unsigned int count = 0;
+        for(unsigned int k = 0 ; k < 3 ; ++k) { count += vertex_meshlet[indices[3 * triangle + k]] != meshlet; }
+        return count;
+    };
+
+    std::size_t next_unemitted = 0;
+    std::size_t seed = NONE;
+
+    while(reordered.size() < triangle_count * 3) {
+        if(seed == NONE) {
+            while(is_emitted[next_unemitted]) { ++next_unemitted; }
+            seed = next_unemitted;
+        }
+
+        meshlets.push_back({ static_cast<unsigned int>(reordered.size()), 0, vec3(0.0f), 0.0f, vec3(0.0f), 1.0f });
+        const unsigned int meshlet = static_cast<unsigned int>(meshlets.size() - 1);
+        meshlet_vertices.clear();
+        vec3 position_sum(0.0f);
+
+        std::size_t triangle = seed;
+        seed = NONE;
+
+        while(triangle != NONE) {
+            is_emitted[triangle] = true;
+            for(unsigned int k = 0 ; k < 3 ; ++k) {
+                const unsigned int vertex = indices[3 * triangle + k];
+                reordered.push_back(vertex);
+                if(vertex_meshlet[vertex] != meshlet) {
+                    vertex_meshlet[vertex] = meshlet;
+                    meshlet_vertices.push_back(vertex);
+                    position_sum += get_position(vertex);
+                }
+            }
+            meshlets.back().count += 3;
+
+            // Picks the adjacent triangle adding the fewest vertices, then the closest one to the center
+            // of the meshlet to keep it round, which tightens its bounds
+            const vec3 meshlet_center = position_sum / static_cast<float>(meshlet_vertices.size());
+            std::size_t best = NONE;
+            unsigned int best_new_vertices = 4;
+            float best_distance = std::numeric_limits<float>::max();
+
+            for(unsigned int vertex : meshlet_vertices) {
+                for(unsigned int j = adjacency_offsets[vertex] ; j < adjacency_offsets[vertex + 1] ; ++j) {
+                    const unsigned int candidate = adjacent_triangles[j];
+                    if(is_emitted[candidate]) { continue; }
+
+                    const unsigned int new_vertices = count_new_vertices(candidate);
+                    if(new_vertices > best_new_vertices) { continue; }
+
+                    const vec3 centroid = (get_position(indices[3 * candidate]) + get_position(indices[3 * candidate + 1])
+                                           + get_position(indices[3 * candidate + 2])) / 3.0f;
+                    const vec3 offset = centroid - meshlet_center;
+                    const float distance = dot(offset, offset);
+
+                    if(new_vertices < best_new_vertices || distance < best_distance) {
+                        best = candidate;
+                        best_new_vertices = new_vertices;
+                        best_distance = distance;
+                    }
+                }
+            }
+
+            const bool is_full = meshlets.back().count / 3 >= max_triangles
+                                 || (best != NONE && meshlet_vertices.size() + best_new_vertices > max_vertices);
+
+            if(is_full) {
+                // The best candidate is a neighbor of the finished meshlet, keeping the next one compact
+                seed = best;
+                triangle = NONE;
+            } else {
+                triangle = best;
+            }
+        }
+    }
+
+    indices.resize(triangle_count * 3);
+    std::copy(reordered.begin(), reordered.end(), indices.begin());
+
+    for(Meshlet& meshlet : meshlets) { compute_meshlet_bounds(positions, mesh.get_stride(), indices, meshlet); }
+
+    return meshlets;
+}
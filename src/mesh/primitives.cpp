@@ -5,33 +5,91 @@
 
 #include "mesh/primitives.hpp"
 
-#include <cmath>
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
 
 #include "maths/constants.hpp"
 #include "maths/geometry.hpp"
+#include "maths/trigonometry.hpp"
 #include "Window.hpp"
 
-void create_sphere_mesh(Mesh& mesh, unsigned int horizontal_slices, unsigned int vertical_slices) {
-    mesh.set_primitive(Primitive::TRIANGLES);
-    mesh.enable_attribute(ATTRIBUTE_NORMAL);
-    mesh.enable_attribute(ATTRIBUTE_TEX_COORDS);
+/**
+ * @struct BakedMesh
+ * @brief Interleaved vertex data and indices of a triangle mesh generated at compile time.
+ * @tparam data_count The amount of floats in the vertex data.
+ * @tparam indices_count The amount of indices.
+ */
+template <std::size_t data_count, std::size_t indices_count>
+struct BakedMesh {
+    std::array<float, data_count> data;             ///< Interleaved position, normal and texture coordinates.
+    std::array<unsigned int, indices_count> indices; ///< Indices of the triangles.
+};
+
+/**
+ * @brief Adds a vertex with a position, a normal and texture coordinates to interleaved data.
+ */
+static constexpr void push_vertex(std::vector<float>& data, const vec3& position, const vec3& normal, const vec2& tex_coords) {
+    data.insert(data.end(), { position.x, position.y, position.z, normal.x, normal.y, normal.z, tex_coords.x, tex_coords.y });
+}
+
+/**
+ * @brief Adds the indices of a triangle.
+ */
+static constexpr void push_triangle(std::vector<unsigned int>& indices, unsigned int A, unsigned int B, unsigned int C) {
+    indices.insert(indices.end(), { A, B, C });
+}
+
+/**
+ * @brief Runs a mesh generator at compile time and stores its result in fixed size arrays.
+ * @tparam generator A function filling vectors of vertex data and indices.
+ * @return The baked mesh.
+ */
+template <auto generator>
+consteval auto bake_mesh() {
+    constexpr std::array<std::size_t, 2> sizes = [] {
+        std::vector<float> data;
+        std::vector<unsigned int> indices;
+        generator(data, indices);
+        return std::array<std::size_t, 2>{ data.size(), indices.size() };
+    }();
+
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    generator(data, indices);
+
+    BakedMesh<sizes[0], sizes[1]> baked{};
+    std::copy(data.begin(), data.end(), baked.data.begin());
+    std::copy(indices.begin(), indices.end(), baked.indices.begin());
+
+    return baked;
+}
 
+/**
+ * @brief Generates the interleaved vertex data (position, normal and texture coordinates) and the
+ * indices of a UV sphere. Can be evaluated at compile time.
+ */
+static constexpr void generate_sphere(unsigned int horizontal_slices, unsigned int vertical_slices,
+                                      std::vector<float>& data, std::vector<unsigned int>& indices) {
     const float theta_step = PI_F / horizontal_slices; // theta in [-PI/2 ; PI/2]
     const float phi_step = TAU_F / vertical_slices;    // phi in [0 ; 2PI]
 
+    data.reserve(data.size() + 8 * (horizontal_slices + 1) * (vertical_slices + 1));
+    indices.reserve(indices.size() + 6 * vertical_slices * horizontal_slices);
+
     for(unsigned int i = 0 ; i <= horizontal_slices ; ++i) {
         float theta = PI_HALF_F - i * theta_step;
-        float cos_theta = std::cos(theta);
-        vec3 point(0.0f, std::sin(theta), 0.0f);
+        float cos_theta = constexpr_cos(theta);
+        vec3 point(0.0f, constexpr_sin(theta), 0.0f);
 
         for(unsigned int j = 0 ; j <= vertical_slices ; ++j) {
             float phi = j * phi_step;
-            point.x = cos_theta * std::cos(phi);
-            point.z = cos_theta * std::sin(phi);
+            point.x = cos_theta * constexpr_cos(phi);
+            point.z = cos_theta * constexpr_sin(phi);
 
             // TODO : Check if the texture coordinates are correct.
-            mesh.add_vertex(point, point, vec2(1.0f - phi / TAU_F, 0.5f + 0.5f * point.y));
+            push_vertex(data, point, point, vec2(1.0f - phi / TAU_F, 0.5f + 0.5f * point.y));
         }
     }
 
@@ -40,32 +98,27 @@ void create_sphere_mesh(Mesh& mesh, unsigned int horizontal_slices, unsigned int
     };
 
     for(unsigned int j = 0 ; j < vertical_slices ; ++j) {
-        mesh.add_triangle(index(0, j), index(1, j + 1), index(1, j));
-        mesh.add_triangle(index(horizontal_slices - 1, j),
-                          index(horizontal_slices - 1, j + 1),
-                          index(horizontal_slices, j));
+        push_triangle(indices, index(0, j), index(1, j + 1), index(1, j));
+        push_triangle(indices,
+                      index(horizontal_slices - 1, j),
+                      index(horizontal_slices - 1, j + 1),
+                      index(horizontal_slices, j));
     }
 
     for(unsigned int i = 1 ; i < horizontal_slices ; ++i) {
         for(unsigned int j = 0 ; j < vertical_slices ; ++j) {
-            mesh.add_face(
-                index(i + 1, j + 1),
-                index(i + 1, j),
-                index(i, j),
-                index(i, j + 1)
-            );
+            push_triangle(indices, index(i + 1, j + 1), index(i + 1, j), index(i, j));
+            push_triangle(indices, index(i + 1, j + 1), index(i, j), index(i, j + 1));
         }
     }
-
-    mesh.bind_buffers();
 }
 
-void create_cube_mesh(Mesh& mesh) {
-    mesh.set_primitive(Primitive::TRIANGLES);
-    mesh.enable_attribute(ATTRIBUTE_NORMAL);
-    mesh.enable_attribute(ATTRIBUTE_TEX_COORDS);
-
-    static const vec3 positions[8]{
+/**
+ * @brief Generates the interleaved vertex data (position, normal and texture coordinates) and the
+ * indices of a cube. Can be evaluated at compile time.
+ */
+static constexpr void generate_cube(std::vector<float>& data, std::vector<unsigned int>& indices) {
+    constexpr vec3 positions[8]{
         vec3(1.0f, 1.0f, 1.0f),   // 0: TOP - RIGHT - FRONT
         vec3(1.0f, 1.0f, -1.0f),  // 1: TOP - RIGHT - BACK
         vec3(1.0f, -1.0f, 1.0f),  // 2: BOTTOM - RIGHT - FRONT
@@ -76,7 +129,7 @@ void create_cube_mesh(Mesh& mesh) {
         vec3(-1.0f, -1.0f, -1.0f) // 7: BOTTOM - LEFT - BACK
     };
 
-    static const vec3 normals[6]{
+    constexpr vec3 normals[6]{
         vec3(1.0f, 0.0f, 0.0f),  // 0: RIGHT
         vec3(-1.0f, 0.0f, 0.0f), // 1: LEFT
         vec3(0.0f, 1.0f, 0.0f),  // 2: TOP
@@ -85,7 +138,7 @@ void create_cube_mesh(Mesh& mesh) {
         vec3(0.0f, 0.0f, -1.0f)  // 5: BACK
     };
 
-    static const uvec4 faces[6]{
+    constexpr uvec4 faces[6]{
         uvec4(0, 2, 3, 1), // 0: RIGHT
         uvec4(5, 7, 6, 4), // 1: LEFT
         uvec4(5, 4, 0, 1), // 2: TOP
@@ -94,7 +147,7 @@ void create_cube_mesh(Mesh& mesh) {
         uvec4(1, 3, 7, 5)  // 5: BACK
     };
 
-    static const vec2 tex_coords[4]{
+    constexpr vec2 tex_coords[4]{
         vec2(0.0f, 1.0f),
         vec2(0.0f, 0.0f),
         vec2(1.0f, 0.0f),
@@ -102,16 +155,179 @@ void create_cube_mesh(Mesh& mesh) {
     };
 
     for(unsigned int i = 0 ; i < 6 ; ++i) {
-        mesh.add_vertex(positions[faces[i].x], normals[i], tex_coords[0]);
-        mesh.add_vertex(positions[faces[i].y], normals[i], tex_coords[1]);
-        mesh.add_vertex(positions[faces[i].z], normals[i], tex_coords[2]);
-        mesh.add_vertex(positions[faces[i].w], normals[i], tex_coords[3]);
-        mesh.add_face(i * 4, i * 4 + 1, i * 4 + 2, i * 4 + 3);
+        push_vertex(data, positions[faces[i].x], normals[i], tex_coords[0]);
+        push_vertex(data, positions[faces[i].y], normals[i], tex_coords[1]);
+        push_vertex(data, positions[faces[i].z], normals[i], tex_coords[2]);
+        push_vertex(data, positions[faces[i].w], normals[i], tex_coords[3]);
+        push_triangle(indices, i * 4, i * 4 + 1, i * 4 + 2);
+        push_triangle(indices, i * 4, i * 4 + 2, i * 4 + 3);
     }
+}
+
+/**
+ * @brief Recursively subdivides a triangle of an icosphere, adding the new vertices to the list.
+ */
+static constexpr void subdivide_icosphere_triangle(std::vector<vec3>& vertices, std::vector<unsigned int>& indices,
+                                                   unsigned int A, unsigned int B, unsigned int C,
+                                                   unsigned int depth) {
+    if(depth > 0) {
+        vertices.push_back(0.5f * (vertices[A] + vertices[B]));
+        unsigned int AB = vertices.size() - 1;
+        vertices.push_back(0.5f * (vertices[B] + vertices[C]));
+        unsigned int BC = vertices.size() - 1;
+        vertices.push_back(0.5f * (vertices[C] + vertices[A]));
+        unsigned int CA = vertices.size() - 1;
+
+        subdivide_icosphere_triangle(vertices, indices, A, AB, CA, depth - 1);
+        subdivide_icosphere_triangle(vertices, indices, AB, B, BC, depth - 1);
+        subdivide_icosphere_triangle(vertices, indices, CA, BC, C, depth - 1);
+        subdivide_icosphere_triangle(vertices, indices, AB, BC, CA, depth - 1);
+    } else {
+        push_triangle(indices, A, B, C);
+    }
+}
+
+/**
+ * @brief Generates the interleaved vertex data (position, normal and texture coordinates) and the
+ * indices of an icosphere. Can be evaluated at compile time.
+ */
+static constexpr void generate_icosphere(unsigned int subdivisions,
+                                         std::vector<float>& data, std::vector<unsigned int>& indices) {
+    constexpr unsigned int faces[12][5]{
+        { 13, 5, 18, 4, 12 },
+        { 12, 4, 10, 8, 0 },
+        { 13, 12, 0, 16, 1 },
+        { 13, 1, 9, 11, 5 },
+        { 1, 16, 17, 3, 9 },
+        { 0, 8, 2, 17, 16 },
+        { 5, 11, 7, 19, 18 },
+        { 4, 18, 19, 6, 10 },
+        { 9, 3, 15, 7, 11 },
+        { 10, 6, 14, 2, 8 },
+        { 17, 2, 14, 15, 3 },
+        { 19, 7, 15, 14, 6 }
+    };
+
+    std::vector<vec3> vertices{
+        normalize(vec3(1.0f, 1.0f, 1.0f)),    // 0
+        normalize(vec3(1.0f, 1.0f, -1.0f)),   // 1
+        normalize(vec3(1.0f, -1.0f, 1.0f)),   // 2
+        normalize(vec3(1.0f, -1.0f, -1.0f)),  // 3
+        normalize(vec3(-1.0f, 1.0f, 1.0f)),   // 4
+        normalize(vec3(-1.0f, 1.0f, -1.0f)),  // 5
+        normalize(vec3(-1.0f, -1.0f, 1.0f)),  // 6
+        normalize(vec3(-1.0f, -1.0f, -1.0f)), // 7
+
+        normalize(vec3(INV_GOLDEN_RATIO_F, 0.0f, GOLDEN_RATIO_F)),   // 8
+        normalize(vec3(INV_GOLDEN_RATIO_F, 0.0f, -GOLDEN_RATIO_F)),  // 9
+        normalize(vec3(-INV_GOLDEN_RATIO_F, 0.0f, GOLDEN_RATIO_F)),  // 10
+        normalize(vec3(-INV_GOLDEN_RATIO_F, 0.0f, -GOLDEN_RATIO_F)), // 11
+
+        normalize(vec3(0.0f, GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F)),   // 12
+        normalize(vec3(0.0f, GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F)),  // 13
+        normalize(vec3(0.0f, -GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F)),  // 14
+        normalize(vec3(0.0f, -GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F)), // 15
+
+        normalize(vec3(GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F, 0.0f)),  // 16
+        normalize(vec3(GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F, 0.0f)), // 17
+        normalize(vec3(-GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F, 0.0f)), // 18
+        normalize(vec3(-GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F, 0.0f)) // 19
+    };
+
+    // Each of the 60 starting triangles is split in 4 at each subdivision, which adds 3 vertices
+    const std::size_t triangles_count = 60 * (std::size_t(1) << (2 * subdivisions));
+    const std::size_t vertices_count = 32 + 60 * ((std::size_t(1) << (2 * subdivisions)) - 1);
+    vertices.reserve(vertices_count);
+    indices.reserve(indices.size() + 3 * triangles_count);
+    data.reserve(data.size() + 8 * vertices_count);
+
+    for(unsigned int i = 0 ; i < 12 ; ++i) {
+        const unsigned int* face = faces[i];
+        vertices.push_back(0.2f * (vertices[face[0]]
+                                   + vertices[face[1]]
+                                   + vertices[face[2]]
+                                   + vertices[face[3]]
+                                   + vertices[face[4]]));
+
+        unsigned int index = vertices.size() - 1;
+
+        subdivide_icosphere_triangle(vertices, indices, face[0], face[1], index, subdivisions);
+        subdivide_icosphere_triangle(vertices, indices, face[1], face[2], index, subdivisions);
+        subdivide_icosphere_triangle(vertices, indices, face[2], face[3], index, subdivisions);
+        subdivide_icosphere_triangle(vertices, indices, face[3], face[4], index, subdivisions);
+        subdivide_icosphere_triangle(vertices, indices, face[4], face[0], index, subdivisions);
+    }
+
+    for(const vec3& vertex : vertices) {
+        vec3 project_on_sphere = normalize(vertex);
+        vec2 tex_coords(constexpr_atan2(project_on_sphere.x, project_on_sphere.z) / (2.0f * PI_F) + 0.5f,
+                        0.5f + 0.5f * project_on_sphere.y);
+        push_vertex(data, project_on_sphere, project_on_sphere, tex_coords);
+    }
+}
+
+/* Meshes baked at compile time */
+
+static constexpr auto baked_cube = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_cube(data, indices);
+}>();
+
+static constexpr auto baked_sphere_8_16 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_sphere(8, 16, data, indices);
+}>();
+
+static constexpr auto baked_sphere_16_32 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_sphere(16, 32, data, indices);
+}>();
+
+static constexpr auto baked_icosphere_0 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_icosphere(0, data, indices);
+}>();
+
+static constexpr auto baked_icosphere_1 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_icosphere(1, data, indices);
+}>();
+
+static constexpr auto baked_icosphere_2 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_icosphere(2, data, indices);
+}>();
+
+static constexpr auto baked_icosphere_3 = bake_mesh<[](std::vector<float>& data, std::vector<unsigned int>& indices) {
+    generate_icosphere(3, data, indices);
+}>();
+
+/**
+ * @brief Enables the position, normal and texture coordinates attributes of a triangle mesh, fills
+ * it with the given data and uploads it to the GPU.
+ */
+static void load_mesh_data(Mesh& mesh, std::span<const float> data, std::span<const unsigned int> indices) {
+    mesh.set_primitive(Primitive::TRIANGLES);
+    mesh.enable_attribute(ATTRIBUTE_NORMAL);
+    mesh.enable_attribute(ATTRIBUTE_TEX_COORDS);
+
+    mesh.push_values(data.data(), data.size());
+    mesh.push_indices(indices.data(), indices.size());
 
     mesh.bind_buffers();
 }
 
+void create_sphere_mesh(Mesh& mesh, unsigned int horizontal_slices, unsigned int vertical_slices) {
+    if(horizontal_slices == 8 && vertical_slices == 16) {
+        load_mesh_data(mesh, baked_sphere_8_16.data, baked_sphere_8_16.indices);
+    } else if(horizontal_slices == 16 && vertical_slices == 32) {
+        load_mesh_data(mesh, baked_sphere_16_32.data, baked_sphere_16_32.indices);
+    } else {
+        std::vector<float> data;
+        std::vector<unsigned int> indices;
+        generate_sphere(horizontal_slices, vertical_slices, data, indices);
+        load_mesh_data(mesh, data, indices);
+    }
+}
+
+void create_cube_mesh(Mesh& mesh) {
+    load_mesh_data(mesh, baked_cube.data, baked_cube.indices);
+}
+
 void create_wireframe_cube_mesh(Mesh& mesh) {
     mesh.set_primitive(Primitive::LINES);
 
@@ -314,101 +530,16 @@ void create_frustum_meshes(Mesh& faces, Mesh& lines, const Camera& camera) {
 }
 
 void create_icosphere_mesh(Mesh& mesh, unsigned int subdivisions) {
-    static constexpr unsigned int faces[12][5]{
-        { 13, 5, 18, 4, 12 },
-        { 12, 4, 10, 8, 0 },
-        { 13, 12, 0, 16, 1 },
-        { 13, 1, 9, 11, 5 },
-        { 1, 16, 17, 3, 9 },
-        { 0, 8, 2, 17, 16 },
-        { 5, 11, 7, 19, 18 },
-        { 4, 18, 19, 6, 10 },
-        { 9, 3, 15, 7, 11 },
-        { 10, 6, 14, 2, 8 },
-        { 17, 2, 14, 15, 3 },
-        { 19, 7, 15, 14, 6 }
-    };
-
-    std::vector<vec3> vertices{
-        normalize(vec3(1.0f, 1.0f, 1.0f)),    // 0
-        normalize(vec3(1.0f, 1.0f, -1.0f)),   // 1
-        normalize(vec3(1.0f, -1.0f, 1.0f)),   // 2
-        normalize(vec3(1.0f, -1.0f, -1.0f)),  // 3
-        normalize(vec3(-1.0f, 1.0f, 1.0f)),   // 4
-        normalize(vec3(-1.0f, 1.0f, -1.0f)),  // 5
-        normalize(vec3(-1.0f, -1.0f, 1.0f)),  // 6
-        normalize(vec3(-1.0f, -1.0f, -1.0f)), // 7
-
-        normalize(vec3(INV_GOLDEN_RATIO_F, 0.0f, GOLDEN_RATIO_F)),   // 8
-        normalize(vec3(INV_GOLDEN_RATIO_F, 0.0f, -GOLDEN_RATIO_F)),  // 9
-        normalize(vec3(-INV_GOLDEN_RATIO_F, 0.0f, GOLDEN_RATIO_F)),  // 10
-        normalize(vec3(-INV_GOLDEN_RATIO_F, 0.0f, -GOLDEN_RATIO_F)), // 11
-
-        normalize(vec3(0.0f, GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F)),   // 12
-        normalize(vec3(0.0f, GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F)),  // 13
-        normalize(vec3(0.0f, -GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F)),  // 14
-        normalize(vec3(0.0f, -GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F)), // 15
-
-        normalize(vec3(GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F, 0.0f)),  // 16
-        normalize(vec3(GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F, 0.0f)), // 17
-        normalize(vec3(-GOLDEN_RATIO_F, INV_GOLDEN_RATIO_F, 0.0f)), // 18
-        normalize(vec3(-GOLDEN_RATIO_F, -INV_GOLDEN_RATIO_F, 0.0f)) // 19
-    };
-
-    std::vector<unsigned int> indices;
-
-    std::function<void(unsigned int, unsigned int, unsigned int, unsigned int)> add_triangle =
-        [&](unsigned int A, unsigned int B, unsigned int C, unsigned int depth) {
-        if(depth > 0) {
-            vertices.push_back(0.5f * (vertices[A] + vertices[B]));
-            unsigned int AB = vertices.size() - 1;
-            vertices.push_back(0.5f * (vertices[B] + vertices[C]));
-            unsigned int BC = vertices.size() - 1;
-            vertices.push_back(0.5f * (vertices[C] + vertices[A]));
-            unsigned int CA = vertices.size() - 1;
-
-            add_triangle(A, AB, CA, depth - 1);
-            add_triangle(AB, B, BC, depth - 1);
-            add_triangle(CA, BC, C, depth - 1);
-            add_triangle(AB, BC, CA, depth - 1);
-        } else {
-            indices.push_back(A);
-            indices.push_back(B);
-            indices.push_back(C);
+    switch(subdivisions) {
+        case 0: load_mesh_data(mesh, baked_icosphere_0.data, baked_icosphere_0.indices); break;
+        case 1: load_mesh_data(mesh, baked_icosphere_1.data, baked_icosphere_1.indices); break;
+        case 2: load_mesh_data(mesh, baked_icosphere_2.data, baked_icosphere_2.indices); break;
+        case 3: load_mesh_data(mesh, baked_icosphere_3.data, baked_icosphere_3.indices); break;
+        default: {
+            std::vector<float> data;
+            std::vector<unsigned int> indices;
+            generate_icosphere(subdivisions, data, indices);
+            load_mesh_data(mesh, data, indices);
         }
-    };
-
-    for(unsigned int i = 0 ; i < 12 ; ++i) {
-        const unsigned int* face = faces[i];
-        vertices.push_back(0.2f * (vertices[face[0]]
-                                   + vertices[face[1]]
-                                   + vertices[face[2]]
-                                   + vertices[face[3]]
-                                   + vertices[face[4]]));
-
-        unsigned int index = vertices.size() - 1;
-
-        add_triangle(face[0], face[1], index, subdivisions);
-        add_triangle(face[1], face[2], index, subdivisions);
-        add_triangle(face[2], face[3], index, subdivisions);
-        add_triangle(face[3], face[4], index, subdivisions);
-        add_triangle(face[4], face[0], index, subdivisions);
     }
-
-    mesh.set_primitive(Primitive::TRIANGLES);
-    mesh.enable_attribute(ATTRIBUTE_NORMAL);
-    mesh.enable_attribute(ATTRIBUTE_TEX_COORDS);
-
-    for(const vec3& vertex : vertices) {
-        vec3 project_on_sphere = normalize(vertex);
-        vec2 tex_coords(std::atan2(project_on_sphere.x, project_on_sphere.z) / (2.0f * PI_F) + 0.5f,
-                        0.5f + 0.5f * project_on_sphere.y);
-        mesh.add_vertex(project_on_sphere, project_on_sphere, tex_coords);
-    }
-
-    for(unsigned int i = 0 ; i + 2 < indices.size() ; i += 3) {
-        mesh.add_triangle(indices[i], indices[i + 1], indices[i + 2]);
-    }
-
-    mesh.bind_buffers();
 }
@@ -0,0 +1,392 @@
+/***************************************************************************************************
+ * @file  simplification.cpp
+ * @brief Implementation of functions aimed at simplifying triangle meshes
+ **************************************************************************************************/
+
+#include "mesh/simplification.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include "maths/geometry.hpp"
+#include "utility/hash.hpp"
+
+/**
+ * @brief Error added per unit of difference between the normals or texture coordinates of collapsed
+ * vertices, relative to the radius of the mesh's bounds.
+ */
+static constexpr float SIMPLIFICATION_ATTRIBUTE_WEIGHT = 0.05f;
+
+/**
+ * @brief Collapses rotating the normal of a triangle by more than about 75 degrees are rejected.
+ */
+static constexpr float SIMPLIFICATION_MIN_NORMAL_COSINE = 0.25f;
+
+/**
+ * @struct Quadric
+ * @brief Sum of the squared distances to weighted planes, stored as the symmetric matrix A, the
+ * vector b and the scalar c of p^T A p + 2 b.p + c.
+ */
+struct Quadric {
+    /**
+     * @brief Adds a plane.
+     * @param normal The unit normal of the plane.
+     * @param distance The signed distance of the plane to the origin, d in n.p + d = 0.
+     * @param plane_weight The weight of the plane, the area of its triangle.
+     */
+    void add_plane(const vec3& normal, double distance, double plane_weight) {
+        a00 += plane_weight * normal.x * normal.x;
+        a01 += plane_weight * normal.x * normal.y;
+        a02 += plane_weight * normal.x * normal.z;
+        a11 += plane_weight * normal.y * normal.y;
+        a12 += plane_weight * normal.y * normal.z;
+        a22 += plane_weight * normal.z * normal.z;
+        b0 += plane_weight * distance * normal.x;
+        b1 += plane_weight * distance * normal.y;
+        b2 += plane_weight * distance * normal.z;
+        c += plane_weight * distance * distance;
+        weight += plane_weight;
+    }
+
+    /**
+     * @brief Adds the planes of another quadric.
+     */
+    Quadric& operator +=(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    /**
+     * @brief Calculates the mean squared distance of a point to the planes.
+     */
+    double evaluate(const vec3& p) const {
+        if(weight == 0.0) { return 0.0; }
+
+        const double error = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+                             + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                             + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+
+        return std::max(error, 0.0) / weight;
+    }
+
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0; ///< The matrix A.
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;                                     ///< The vector b.
+    double c = 0.0;                                                          ///< The scalar c.
+    double weight = 0.0;                                                     ///< The sum of the weights.
+};
+
+/**
+ * @struct Collapse
+ * @brief The collapse of every vertex at a position onto the vertices at a neighboring position.
+ */
+struct Collapse {
+    float cost;        ///< The squared error of the collapse.
+    unsigned int from; ///< The first vertex at the collapsed position.
+    unsigned int to;   ///< The first vertex at the position it is collapsed onto.
+};
+
+std::vector<unsigned int> simplify_mesh(const Mesh& mesh,
+                                        const std::vector<unsigned int>& indices,
+                                        std::size_t target_index_count,
+                                        float max_error,
+                                        float& error) {
+    error = 0.0f;
+    std::vector<unsigned int> result(indices);
+
+    const float* data = mesh.get_attribute_data(ATTRIBUTE_POSITION);
+    if(mesh.get_primitive() != Primitive::TRIANGLES || data == nullptr || result.size() <= target_index_count) {
+        return result;
+    }
+
+    const unsigned int stride = mesh.get_stride();
+    const std::size_t vertex_count = mesh.get_vertices_amount();
+
+    // Positions are normalized by the bounds so that errors are relative to their radius
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+    mesh.get_min_max_axis_aligned_coordinates(min, max);
+
+    const vec3 center = 0.5f * (min + max);
+    const float radius = 0.5f * length(max - min);
+    if(radius == 0.0f) { return result; }
+
+    std::vector<vec3> positions(vertex_count);
+    for(std::size_t i = 0 ; i < vertex_count ; ++i) {
+        const float* position = data + i * stride;
+        positions[i] = (vec3(position[0], position[1], position[2]) - center) / radius;
+    }
+
+    // Normals and texture coordinates are compared when choosing where vertices are collapsed
+    const float* normals = mesh.get_attribute_type(ATTRIBUTE_NORMAL) == AttributeType::VEC3
+                               ? mesh.get_attribute_data(ATTRIBUTE_NORMAL)
+                               : nullptr;
+    const float* tex_coords = mesh.get_attribute_type(ATTRIBUTE_TEX_COORDS) == AttributeType::VEC2
+                                  ? mesh.get_attribute_data(ATTRIBUTE_TEX_COORDS)
+                                  : nullptr;
+
+    auto get_attribute_distance = [&](unsigned int a, unsigned int b) {
+        float distance = 0.0f;
+
+        if(normals != nullptr) {
+            for(unsigned int k = 0 ; k < 3 ; ++k) {
+                const float difference = normals[a * stride + k] - normals[b * stride + k];
+                distance += difference * difference;
+            }
+        }
+
+        if(tex_coords != nullptr) {
+            for(unsigned int k = 0 ; k < 2 ; ++k) {
+                const float difference = tex_coords[a * stride + k] - tex_coords[b * stride + k];
+                distance += difference * difference;
+            }
+        }
+
+        return distance;
+    };
+
+    // Vertices at the same position form a group, represented by its first vertex and linked in a
+    // circular list
+    std::vector<unsigned int> group(vertex_count);
+    std::vector<unsigned int> next_in_group(vertex_count);
+    std::unordered_map<vec3, unsigned int, vector3_hash<float>> first_at_position;
+
+    for(unsigned int i = 0 ; i < vertex_count ; ++i) {
+        auto [first, was_inserted] = first_at_position.try_emplace(positions[i], i);
+        group[i] = first->second;
+
+        if(was_inserted) {
+            next_in_group[i] = i;
+        } else {
+            next_in_group[i] = next_in_group[first->second];
+            next_in_group[first->second] = i;
+        }
+    }
+
+    // Finds the vertex of a group with the closest attributes to a vertex
+    auto get_closest_in_group = [&](unsigned int vertex, unsigned int group_first, float& distance) {
+        unsigned int closest = group_first;
+        distance = std::numeric_limits<float>::max();
+
+        unsigned int other = group_first;
+        do {
+            const float other_distance = get_attribute_distance(vertex, other);
+            if(other_distance < distance) {
+                distance = other_distance;
+                closest = other;
+            }
+            other = next_in_group[other];
+        } while(other != group_first);
+
+        return closest;
+    };
+
+    // Quadrics of the planes of the triangles around each group
+    std::vector<Quadric> quadrics(vertex_count);
+
+    for(std::size_t i = 0 ; i + 2 < result.size() ; i += 3) {
+        const unsigned int g0 = group[result[i]];
+        const unsigned int g1 = group[result[i + 1]];
+        const unsigned int g2 = group[result[i + 2]];
+
+        const vec3 normal = cross(positions[g1] - positions[g0], positions[g2] - positions[g0]);
+        const float double_area = length(normal);
+        if(double_area == 0.0f) { continue; }
+
+        const vec3 unit_normal = normal / double_area;
+        const double distance = -dot(unit_normal, positions[g0]);
+
+        quadrics[g0].add_plane(unit_normal, distance, 0.5 * double_area);
+        quadrics[g1].add_plane(unit_normal, distance, 0.5 * double_area);
+        quadrics[g2].add_plane(unit_normal, distance, 0.5 * double_area);
+    }
+
+    // Groups with an edge that isn't shared by a triangle going the other way are on a border
+    std::vector<unsigned char> is_locked(vertex_count, false);
+    std::unordered_set<std::uint64_t> edges;
+
+    auto get_edge_key = [](unsigned int a, unsigned int b) { return static_cast<std::uint64_t>(a) << 32 | b; };
+
+    for(std::size_t i = 0 ; i + 2 < result.size() ; i += 3) {
+        for(unsigned int k = 0 ; k < 3 ; ++k) {
+            edges.insert(get_edge_key(group[result[i + k]], group[result[i + (k + 1) % 3]]));
+        }
+    }
+
+    for(std::uint64_t edge : edges) {
+        const unsigned int a = edge >> 32;
+        const unsigned int b = edge & 0xFFFFFFFF;
+        if(!edges.contains(get_edge_key(b, a))) { is_locked[a] = is_locked[b] = true; }
+    }
+
+    std::vector<unsigned int> vertex_remap(vertex_count);
+    for(unsigned int i = 0 ; i < vertex_count ; ++i) { vertex_remap[i] = i; }
+
+    std::vector<unsigned int> triangle_offsets(vertex_count + 1);
+    std::vector<unsigned int> group_triangles;
+    std::vector<float> best_costs(vertex_count);
+    std::vector<unsigned int> best_targets(vertex_count);
+    std::vector<Collapse> collapses;
+    std::vector<unsigned char> is_touched(vertex_count);
+
+    const float max_cost = max_error * max_error;
+    float reached_cost = 0.0f;
+
+    // Each pass does the cheapest collapses of distinct regions of the mesh
+    while(result.size() > target_index_count) {
+        const std::size_t triangle_count = result.size() / 3;
+
+        // Lists the triangles around each group
+        std::fill(triangle_offsets.begin(), triangle_offsets.end(), 0);
+        for(unsigned int index : result) { ++triangle_offsets[group[index] + 1]; }
+        for(std::size_t i = 1 ; i <= vertex_count ; ++i) { triangle_offsets[i] += triangle_offsets[i - 1]; }
+
+        group_triangles.resize(result.size());
+        for(std::size_t i = 0 ; i < result.size() ; ++i) {
+            group_triangles[triangle_offsets[group[result[i]]]++] = i / 3;
+        }
+        for(std::size_t i = vertex_count ; i > 0 ; --i) { triangle_offsets[i] = triangle_offsets[i - 1]; }
+        triangle_offsets[0] = 0;
+
+        // Finds the cheapest collapse of each group onto one of its neighbors
+        std::fill(best_costs.begin(), best_costs.end(), std::numeric_limits<float>::max());
+
+        auto evaluate_collapse = [&](unsigned int from, unsigned int to) {
+            if(is_locked[from]) { return; }
+
+            Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+
+            // Every vertex of the group needs a vertex with close attributes at the new position
+            float attribute_distance = 0.0f;
+            unsigned int vertex = from;
+            do {
+                float distance;
+                get_closest_in_group(vertex, to, distance);
+                attribute_distance = std::max(attribute_distance, distance);
+                vertex = next_in_group[vertex];
+            } while(vertex != from);
+
+            const float cost = static_cast<float>(quadric.evaluate(positions[to]))
+                               + SIMPLIFICATION_ATTRIBUTE_WEIGHT * SIMPLIFICATION_ATTRIBUTE_WEIGHT * attribute_distance;
+
+            if(cost < best_costs[from]) {
+                best_costs[from] = cost;
+                best_targets[from] = to;
+            }
+        };
+
+        for(std::size_t i = 0 ; i < result.size() ; i += 3) {
+            for(unsigned int k = 0 ; k < 3 ; ++k) {
+                const unsigned int a = group[result[i + k]];
+                const unsigned int b = group[result[i + (k + 1) % 3]];
+                evaluate_collapse(a, b);
+                evaluate_collapse(b, a);
+            }
+        }
+
+        collapses.clear();
+        for(unsigned int i = 0 ; i < vertex_count ; ++i) {
+            if(group[i] == i && best_costs[i] <= max_cost) { collapses.push_back({ best_costs[i], i, best_targets[i] }); }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost || (a.cost == b.cost && a.from < b.from);
+        });
+
+        // Does the collapses in order of cost, skipping the ones touching a region already modified
+        // during this pass so that the triangle lists stay valid
+        const std::size_t triangles_to_remove = (result.size() - target_index_count + 2) / 3;
+        std::size_t removed_triangles = 0;
+        std::size_t collapse_count = 0;
+        std::fill(is_touched.begin(), is_touched.end(), false);
+
+        for(const Collapse& collapse : collapses) {
+            if(removed_triangles >= triangles_to_remove) { break; }
+            if(is_touched[collapse.from] || is_touched[collapse.to]) { continue; }
+
+            const unsigned int* first_triangle = group_triangles.data() + triangle_offsets[collapse.from];
+            const unsigned int* last_triangle = group_triangles.data() + triangle_offsets[collapse.from + 1];
+
+            // Rejects the collapse if a remaining triangle would be flipped
+            bool is_flipping = false;
+            std::size_t collapsed_triangles = 0;
+
+            for(const unsigned int* triangle = first_triangle ; triangle != last_triangle ; ++triangle) {
+                unsigned int corners[3];
+                for(unsigned int k = 0 ; k < 3 ; ++k) { corners[k] = group[result[3 * *triangle + k]]; }
+
+                if(corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+                    ++collapsed_triangles;
+                    continue;
+                }
+
+                const vec3 before = cross(positions[corners[1]] - positions[corners[0]],
+                                          positions[corners[2]] - positions[corners[0]]);
+
+                for(unsigned int& corner : corners) { if(corner == collapse.from) { corner = collapse.to; } }
+
+                const vec3 after = cross(positions[corners[1]] - positions[corners[0]],
+                                         positions[corners[2]] - positions[corners[0]]);
+
+                if(dot(before, after) < SIMPLIFICATION_MIN_NORMAL_COSINE * length(before) * length(after)) {
+                    is_flipping = true;
+                    break;
+                }
+            }
+
+            if(is_flipping) { continue; }
+
+            // Moves each vertex of the group onto the vertex with the closest attributes
+            unsigned int vertex = collapse.from;
+            do {
+                float distance;
+                vertex_remap[vertex] = get_closest_in_group(vertex, collapse.to, distance);
+                vertex = next_in_group[vertex];
+            } while(vertex != collapse.from);
+
+            quadrics[collapse.to] += quadrics[collapse.from];
+
+            for(const unsigned int* triangle = first_triangle ; triangle != last_triangle ; ++triangle) {
+                for(unsigned int k = 0 ; k < 3 ; ++k) { is_touched[group[result[3 * *triangle + k]]] = true; }
+            }
+
+            removed_triangles += collapsed_triangles;
+            reached_cost = std::max(reached_cost, collapse.cost);
+            ++collapse_count;
+        }
+
+        if(collapse_count == 0) { break; }
+
+        // Remaps the indices and removes the triangles whose corners are now at the same position
+        std::size_t kept_count = 0;
+        for(std::size_t i = 0 ; i < triangle_count ; ++i) {
+            const unsigned int a = vertex_remap[result[3 * i]];
+            const unsigned int b = vertex_remap[result[3 * i + 1]];
+            const unsigned int c = vertex_remap[result[3 * i + 2]];
+
+            if(group[a] != group[b] && group[b] != group[c] && group[c] != group[a]) {
+                result[kept_count++] = a;
+                result[kept_count++] = b;
+                result[kept_count++] = c;
+            }
+        }
+
+        result.resize(kept_count);
+    }
+
+    error = std::sqrt(reached_cost);
+    return result;
+}
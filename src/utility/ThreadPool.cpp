@@ -0,0 +1,82 @@
+/***************************************************************************************************
+ * @file  ThreadPool.cpp
+ * @brief Implementation of the ThreadPool class
+ **************************************************************************************************/
+
+#include "utility/ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+    : current_task(nullptr), task_count(0), next_task(0), busy_workers(0), batch_id(0), is_stopping(false) {
+    if(thread_count == 0) { thread_count = std::max(1u, std::thread::hardware_concurrency()); }
+
+    workers.reserve(thread_count - 1);
+    for(unsigned int i = 1 ; i < thread_count ; ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        is_stopping = true;
+    }
+
+    start_condition.notify_all();
+    for(std::thread& worker : workers) { worker.join(); }
+}
+
+void ThreadPool::run(unsigned int task_count, const Task& task) {
+    if(task_count == 0) { return; }
+
+    // Waking the workers up costs more than running a single task
+    if(task_count == 1) {
+        task(0, 0);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        current_task = &task;
+        this->task_count = task_count;
+        next_task = 0;
+        busy_workers = workers.size();
+        ++batch_id;
+    }
+
+    start_condition.notify_all();
+    run_tasks(0);
+
+    std::unique_lock lock(mutex);
+    done_condition.wait(lock, [this] { return busy_workers == 0; });
+    current_task = nullptr;
+}
+
+unsigned int ThreadPool::get_thread_count() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::worker_loop(unsigned int thread_index) {
+    unsigned int last_batch_id = 0;
+
+    while(true) {
+        {
+            std::unique_lock lock(mutex);
+            start_condition.wait(lock, [&] { return is_stopping || batch_id != last_batch_id; });
+            if(is_stopping) { return; }
+            last_batch_id = batch_id;
+        }
+
+        run_tasks(thread_index);
+
+        std::lock_guard lock(mutex);
+        if(--busy_workers == 0) { done_condition.notify_one(); }
+    }
+}
+
+void ThreadPool::run_tasks(unsigned int thread_index) {
+    for(unsigned int i = next_task++ ; i < task_count ; i = next_task++) {
+        (*current_task)(i, thread_index);
+    }
+}
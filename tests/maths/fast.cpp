@@ -0,0 +1,167 @@
+/***************************************************************************************************
+ * @file  fast.cpp
+ * @brief Checks the maximum errors documented by the fast approximations of maths/fast.hpp
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numbers>
+#include <vector>
+#include "maths/fast.hpp"
+
+/**
+ * @brief The maximum absolute error of fast_sin and fast_cos for angles in [-100 ; 100].
+ */
+static constexpr double SIN_COS_MAX_ERROR = 2.5e-7;
+
+/**
+ * @brief The maximum absolute error of fast_atan2 in radians.
+ */
+static constexpr double ATAN2_MAX_ERROR = 1.2e-5;
+
+/**
+ * @brief The maximum relative error of fast_rsqrt, fast_sqrt and fast_normalize.
+ */
+#ifdef MATHS_USE_SSE
+static constexpr double RSQRT_MAX_ERROR = 3e-7;
+#else
+static constexpr double RSQRT_MAX_ERROR = 5e-6;
+#endif
+
+/**
+ * @brief The amount of samples of each sweep. Isn't a multiple of 4 so that the scalar tails of the
+ * batched functions are checked too.
+ */
+static constexpr unsigned int SAMPLE_COUNT = 2'000'003;
+
+/**
+ * @brief Prints the maximum error of a function and compares it to its documented bound.
+ * @param name The name of the function.
+ * @param max_error The maximum error measured.
+ * @param bound The documented maximum error.
+ * @return Whether the error is within the bound.
+ */
+static bool check(const char* name, double max_error, double bound) {
+    const bool passed = max_error <= bound;
+    std::cout << (passed ? "[PASSED] " : "[FAILED] ") << name << ": max error " << max_error << ", bound " << bound
+              << '\n';
+    return passed;
+}
+
+/**
+ * @param value A value.
+ * @return The relative error of a value that should be 1.
+ */
+static double relative_error_to_one(double value) {
+    return std::abs(value - 1.0);
+}
+
+/**
+ * @param vec A vector.
+ * @return The length of the vector in double precision.
+ */
+static double length_double(const vec3& vec) {
+    return std::sqrt(double(vec.x) * vec.x + double(vec.y) * vec.y + double(vec.z) * vec.z);
+}
+
+int main() {
+    bool passed = true;
+
+    /* Sine & Cosine */ {
+        std::vector<float> angles(SAMPLE_COUNT);
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) { angles[i] = -100.0f + 200.0f * i / (SAMPLE_COUNT - 1); }
+
+        std::vector<float> sines(SAMPLE_COUNT);
+        std::vector<float> cosines(SAMPLE_COUNT);
+        fast_sin_cos(angles, sines, cosines);
+
+        double sin_error = 0.0, cos_error = 0.0, batched_sin_error = 0.0, batched_cos_error = 0.0;
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            const double sine = std::sin(double(angles[i]));
+            const double cosine = std::cos(double(angles[i]));
+            sin_error = std::max(sin_error, std::abs(fast_sin(angles[i]) - sine));
+            cos_error = std::max(cos_error, std::abs(fast_cos(angles[i]) - cosine));
+            batched_sin_error = std::max(batched_sin_error, std::abs(sines[i] - sine));
+            batched_cos_error = std::max(batched_cos_error, std::abs(cosines[i] - cosine));
+        }
+
+        passed &= check("fast_sin", sin_error, SIN_COS_MAX_ERROR);
+        passed &= check("fast_cos", cos_error, SIN_COS_MAX_ERROR);
+        passed &= check("fast_sin_cos (sines)", batched_sin_error, SIN_COS_MAX_ERROR);
+        passed &= check("fast_sin_cos (cosines)", batched_cos_error, SIN_COS_MAX_ERROR);
+    }
+
+    /* Arctangent */ {
+        // Points on circles of several radii so that every octant and both coordinate signs are covered
+        double error = 0.0;
+        for(float radius : { 1e-3f, 1.0f, 1e3f }) {
+            for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+                const double angle = -std::numbers::pi + 2.0 * std::numbers::pi * i / SAMPLE_COUNT;
+                const float x = radius * static_cast<float>(std::cos(angle));
+                const float y = radius * static_cast<float>(std::sin(angle));
+                error = std::max(error, std::abs(fast_atan2(y, x) - std::atan2(double(y), double(x))));
+            }
+        }
+
+        passed &= check("fast_atan2", error, ATAN2_MAX_ERROR);
+        passed &= check("fast_atan2 (origin)", std::abs(fast_atan2(0.0f, 0.0f)), 0.0);
+    }
+
+    /* Reciprocal Square Root & Square Root */ {
+        // Every mantissa of [1 ; 4) is sampled, both exponent parities included, then shifted by powers of 4
+        std::vector<float> values;
+        values.reserve(SAMPLE_COUNT + 64);
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) { values.push_back(1.0f + 3.0f * i / SAMPLE_COUNT); }
+        for(int exponent = -30 ; exponent <= 30 ; ++exponent) { values.push_back(std::ldexp(1.2345f, 2 * exponent)); }
+
+        std::vector<float> results(values.size());
+        fast_rsqrt(values, results);
+
+        double rsqrt_error = 0.0, sqrt_error = 0.0, batched_error = 0.0;
+        for(unsigned int i = 0 ; i < values.size() ; ++i) {
+            const double value = values[i];
+            const double sqrt = std::sqrt(value);
+            rsqrt_error = std::max(rsqrt_error, relative_error_to_one(fast_rsqrt(values[i]) * sqrt));
+            sqrt_error = std::max(sqrt_error, relative_error_to_one(fast_sqrt(values[i]) / sqrt));
+            batched_error = std::max(batched_error, relative_error_to_one(results[i] * sqrt));
+        }
+
+        passed &= check("fast_rsqrt", rsqrt_error, RSQRT_MAX_ERROR);
+        passed &= check("fast_rsqrt (batched)", batched_error, RSQRT_MAX_ERROR);
+        passed &= check("fast_sqrt", sqrt_error, RSQRT_MAX_ERROR);
+        passed &= check("fast_sqrt (zero)", fast_sqrt(0.0f), 0.0);
+    }
+
+    /* Normalization */ {
+        // Deterministic pseudo-random vectors with components of very different magnitudes
+        std::vector<vec3> vectors;
+        vectors.reserve(SAMPLE_COUNT);
+        uint32_t state = 12345;
+        const auto random = [&state] {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>(state >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+        };
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            const float scale = std::ldexp(1.0f, static_cast<int>(i % 41) - 20);
+            vec3 vec(random(), random(), random());
+            if(vec.x == 0.0f && vec.y == 0.0f && vec.z == 0.0f) { vec.x = 1.0f; }
+            vectors.push_back(scale * vec);
+        }
+
+        std::vector<vec3> normalized = vectors;
+        fast_normalize(normalized);
+
+        double error = 0.0, batched_error = 0.0;
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            error = std::max(error, relative_error_to_one(length_double(fast_normalize(vectors[i]))));
+            batched_error = std::max(batched_error, relative_error_to_one(length_double(normalized[i])));
+        }
+
+        passed &= check("fast_normalize", error, RSQRT_MAX_ERROR);
+        passed &= check("fast_normalize (batched)", batched_error, RSQRT_MAX_ERROR);
+    }
+
+    return passed ? 0 : 1;
+}
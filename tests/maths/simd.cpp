@@ -0,0 +1,212 @@
+/***************************************************************************************************
+ * @file  simd.cpp
+ * @brief Checks that the SIMD kernels of the maths module give bit-identical results to the scalar code
+ **************************************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "maths/mat4.hpp"
+#include "maths/quaternion.hpp"
+#include "maths/simd.hpp"
+#include "maths/transforms.hpp"
+
+/**
+ * @brief The amount of random inputs of each kernel.
+ */
+static constexpr unsigned int SAMPLE_COUNT = 100'000;
+
+/**
+ * @brief The maximum absolute error allowed when checking a matrix against its expected values.
+ */
+static constexpr float TRS_MAX_ERROR = 1e-6f;
+
+/**
+ * @brief Deterministic pseudo-random generator so that failures can be reproduced.
+ */
+static uint32_t random_state = 12345;
+
+/**
+ * @param min The minimum value.
+ * @param max The maximum value.
+ * @return A pseudo-random float in [min ; max].
+ */
+static float random_float(float min, float max) {
+    random_state = random_state * 1664525u + 1013904223u;
+    return min + (max - min) * static_cast<float>(random_state >> 8) / static_cast<float>(1 << 24);
+}
+
+/**
+ * @return A matrix with pseudo-random components in [-10 ; 10].
+ */
+static mat4 random_mat4() {
+    mat4 mat;
+    for(int i = 0 ; i < 4 ; ++i) {
+        for(int j = 0 ; j < 4 ; ++j) { mat(i, j) = random_float(-10.0f, 10.0f); }
+    }
+    return mat;
+}
+
+/**
+ * @return A pseudo-random unit quaternion.
+ */
+static quaternion random_unit_quaternion() {
+    quaternion q(random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f),
+                 random_float(-1.0f, 1.0f));
+    const float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return quaternion(q.x / length, q.y / length, q.z / length, q.w / length);
+}
+
+/**
+ * @brief Scalar reference of mat4 * mat4, summing the products from left to right.
+ */
+static mat4 reference_product(const mat4& left, const mat4& right) {
+    mat4 result;
+    for(int i = 0 ; i < 4 ; ++i) {
+        for(int j = 0 ; j < 4 ; ++j) {
+            result(i, j) = left(i, 0) * right(0, j) + left(i, 1) * right(1, j) + left(i, 2) * right(2, j)
+                           + left(i, 3) * right(3, j);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Scalar reference of mat4 * vec4, summing the products from left to right.
+ */
+static vec4 reference_product(const mat4& mat, const vec4& vec) {
+    return vec4(
+        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z + mat(0, 3) * vec.w,
+        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z + mat(1, 3) * vec.w,
+        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z + mat(2, 3) * vec.w,
+        mat(3, 0) * vec.x + mat(3, 1) * vec.y + mat(3, 2) * vec.z + mat(3, 3) * vec.w
+    );
+}
+
+/**
+ * @brief Scalar reference of the quaternion TRS_matrix, T * R * S: column j of the rotation matrix is
+ * scaled by the j-th scaling factor.
+ */
+static mat4 reference_TRS_matrix(const vec3& t, const quaternion& q, const vec3& s) {
+    return mat4(
+        s.x * (1.0f - 2.0f * (q.y * q.y + q.z * q.z)),
+        s.y * (2.0f * (q.x * q.y - q.w * q.z)),
+        s.z * (2.0f * (q.x * q.z + q.w * q.y)),
+        t.x,
+
+        s.x * (2.0f * (q.x * q.y + q.w * q.z)),
+        s.y * (1.0f - 2.0f * (q.x * q.x + q.z * q.z)),
+        s.z * (2.0f * (q.y * q.z - q.w * q.x)),
+        t.y,
+
+        s.x * (2.0f * (q.x * q.z - q.w * q.y)),
+        s.y * (2.0f * (q.y * q.z + q.w * q.x)),
+        s.z * (1.0f - 2.0f * (q.x * q.x + q.y * q.y)),
+        t.z,
+
+        0.0f, 0.0f, 0.0f, 1.0f
+    );
+}
+
+/**
+ * @brief Prints the amount of mismatches of a kernel.
+ * @param name The name of the kernel.
+ * @param mismatch_count The amount of inputs whose result differs from the reference.
+ * @return Whether there weren't any mismatches.
+ */
+static bool check(const char* name, unsigned int mismatch_count) {
+    const bool passed = mismatch_count == 0;
+    std::cout << (passed ? "[PASSED] " : "[FAILED] ") << name << ": " << mismatch_count << " mismatches out of "
+              << SAMPLE_COUNT << '\n';
+    return passed;
+}
+
+/**
+ * @param mat A matrix.
+ * @param expected The expected values of the matrix, row by row.
+ * @return Whether every component of the matrix is close to its expected value.
+ */
+static bool is_close(const mat4& mat, const float (&expected)[16]) {
+    for(int i = 0 ; i < 4 ; ++i) {
+        for(int j = 0 ; j < 4 ; ++j) {
+            if(std::abs(mat(i, j) - expected[4 * i + j]) > TRS_MAX_ERROR) { return false; }
+        }
+    }
+    return true;
+}
+
+int main() {
+#if defined(MATHS_USE_AVX)
+    std::cout << "Instruction set: AVX\n";
+#elif defined(MATHS_USE_SSE)
+    std::cout << "Instruction set: SSE\n";
+#else
+    std::cout << "Instruction set: scalar\n";
+#endif
+
+    bool passed = true;
+
+    /* mat4 * mat4 */ {
+        unsigned int mismatch_count = 0;
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            const mat4 left = random_mat4();
+            const mat4 right = random_mat4();
+            const mat4 result = left * right;
+            const mat4 expected = reference_product(left, right);
+            if(std::memcmp(&result, &expected, sizeof(mat4)) != 0) { ++mismatch_count; }
+        }
+
+        passed &= check("mat4 * mat4", mismatch_count);
+    }
+
+    /* mat4 * vec4 */ {
+        unsigned int mismatch_count = 0;
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            const mat4 mat = random_mat4();
+            const vec4 vec(random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f),
+                           random_float(-10.0f, 10.0f));
+            const vec4 result = mat * vec;
+            const vec4 expected = reference_product(mat, vec);
+            if(std::memcmp(&result, &expected, sizeof(vec4)) != 0) { ++mismatch_count; }
+        }
+
+        passed &= check("mat4 * vec4", mismatch_count);
+    }
+
+    /* Quaternion TRS_matrix */ {
+        unsigned int mismatch_count = 0;
+        for(unsigned int i = 0 ; i < SAMPLE_COUNT ; ++i) {
+            const vec3 translation(random_float(-100.0f, 100.0f), random_float(-100.0f, 100.0f),
+                                   random_float(-100.0f, 100.0f));
+            const quaternion rotation = random_unit_quaternion();
+            const vec3 scale(random_float(0.1f, 10.0f), random_float(0.1f, 10.0f), random_float(0.1f, 10.0f));
+
+            const mat4 result = TRS_matrix(translation, rotation, scale);
+            const mat4 expected = reference_TRS_matrix(translation, rotation, scale);
+            if(std::memcmp(&result, &expected, sizeof(mat4)) != 0) { ++mismatch_count; }
+        }
+
+        passed &= check("TRS_matrix (quaternion)", mismatch_count);
+    }
+
+    /* TRS order */ {
+        // A quarter turn around z with a scale along x: R * S stretches x before turning it into y,
+        // while S * R would stretch the y axis that x turned into
+        const float half_sqrt2 = std::sqrt(0.5f);
+        const mat4 trs = TRS_matrix(vec3(1.0f, 2.0f, 3.0f), quaternion(0.0f, 0.0f, half_sqrt2, half_sqrt2),
+                                    vec3(2.0f, 1.0f, 1.0f));
+        const float expected[16]{
+            0.0f, -1.0f, 0.0f, 1.0f,
+            2.0f, 0.0f, 0.0f, 2.0f,
+            0.0f, 0.0f, 1.0f, 3.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+
+        const bool is_order_correct = is_close(trs, expected);
+        std::cout << (is_order_correct ? "[PASSED] " : "[FAILED] ") << "TRS_matrix (quaternion) scales then rotates\n";
+        passed &= is_order_correct;
+    }
+
+    return passed ? 0 : 1;
+}